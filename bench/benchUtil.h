@@ -0,0 +1,24 @@
+#ifndef BENCHUTIL_H
+#define BENCHUTIL_H
+
+// Required imports
+#include <cstdint>
+#include <string>
+#include <tuple>
+#include <vector>
+#include "benchmark/benchmark.h"
+#include "../test/allocCounter.h"
+
+/**
+ * Helpers shared by the benchmarks. Every allocation of the benchmark binary goes
+ * through a counting operator new (see test/allocCounter.cpp), so a benchmark reports the
+ * allocations of its timed loop next to the time per operation.
+ **/
+
+// sets the "allocs" counter (per iteration) from the count taken before the timed loop
+void reportAllocations(benchmark::State& state, std::uint64_t startCount);
+
+// games of the SimulatedGames corpus as (row, col) moves, cut at the first move Omok rejects
+const std::vector<std::vector<std::tuple<int, int>>>& corpusGames(void);
+
+#endif
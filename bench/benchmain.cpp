@@ -0,0 +1,62 @@
+#include "benchUtil.h"
+#include "psqReader.h"
+#include <cstring>
+
+/**
+ * Entry point of the benchmarks. Unless --benchmark_out is given the results are also
+ * written to benchmark_results.json, so two builds can be compared with the compare.py
+ * tool of Google Benchmark:
+ *     compare.py benchmarks old_results.json new_results.json
+ **/
+
+namespace {
+    // same relative path as the tests, run from the build directory
+    const char* CORPUS_PATH = "../test/SimulatedGames/";
+}
+
+void reportAllocations(benchmark::State& state, std::uint64_t startCount) {
+    state.counters["allocs"] = benchmark::Counter(static_cast<double>(allocationCount() - startCount),
+                                                  benchmark::Counter::kAvgIterations);
+}
+
+const std::vector<std::vector<std::tuple<int, int>>>& corpusGames(void) {
+    static const std::vector<std::vector<std::tuple<int, int>>> games = [](void) {
+        std::vector<std::vector<std::tuple<int, int>>> loaded;
+        Omok board;
+        int width, height;
+        PsqMove move;
+        for(const std::string& filePath : PsqReplayer::listCorpus(CORPUS_PATH)) {
+            const MappedFile psqFile(filePath);
+            PsqScanner scanner(psqFile.data(), psqFile.data() + psqFile.size());
+            if(!psqFile.isOpen() || !scanner.readHeader(width, height))
+                continue;
+            board.clearBoard();
+            loaded.emplace_back();
+            while(scanner.nextMove(move) && board.placePiece(move.x-1, move.y-1))
+                loaded.back().emplace_back(move.x-1, move.y-1);
+        }
+        return loaded;
+    }();
+    return games;
+}
+
+int main(int argc, char** argv) {
+    std::vector<char*> args(argv, argv + argc);
+    bool hasOutput = false;
+    for(int argInd=1; argInd<argc; argInd++)
+        hasOutput |= std::strncmp(argv[argInd], "--benchmark_out=", 16) == 0;
+    char outArg[] = "--benchmark_out=benchmark_results.json";
+    char formatArg[] = "--benchmark_out_format=json";
+    if(!hasOutput) {
+        args.push_back(outArg);
+        args.push_back(formatArg);
+    }
+
+    int numArgs = static_cast<int>(args.size());
+    benchmark::Initialize(&numArgs, args.data());
+    if(benchmark::ReportUnrecognizedArguments(numArgs, args.data()))
+        return 1;
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
@@ -0,0 +1,130 @@
+#include "benchUtil.h"
+#include "mnkGame.h"
+#include <algorithm>
+#include <random>
+
+// Benchmarks of the MNKBoard primitives, on 15x15 (compile-time board) and 12x12 (runtime board)
+namespace {
+    // exposes the protected line readers
+    class ProbeBoard : public MNKBoard{
+    public:
+        using MNKBoard::MNKBoard;
+        using MNKBoard::enumerateInARow;
+        using MNKBoard::getRowVec;
+        using MNKBoard::getColVec;
+        using MNKBoard::getForwardDiagVec;
+        using MNKBoard::getBackDiagVec;
+    };
+
+    const int WIN_SIZE = 5;
+    const int POSITION_MOVES = 40;
+
+    // distinct cells in a fixed random order
+    std::vector<std::tuple<int, int>> shuffledCells(int rows, int cols) {
+        std::vector<std::tuple<int, int>> cells;
+        for(int rowInd=0; rowInd<rows; rowInd++)
+            for(int colInd=0; colInd<cols; colInd++)
+                cells.emplace_back(rowInd, colInd);
+        std::shuffle(cells.begin(), cells.end(), std::mt19937(rows*cols));
+        return cells;
+    }
+
+    // alternating pieces on the first cells of the shuffled order
+    void playPosition(MNKBoard& board, const std::vector<std::tuple<int, int>>& cells) {
+        for(int moveInd=0; moveInd<POSITION_MOVES; moveInd++)
+            board.placePiece(std::get<0>(cells[moveInd]), std::get<1>(cells[moveInd]),
+                             moveInd % 2 ? CellState::white : CellState::black);
+    }
+
+    // places one piece per iteration; the board is cleared whenever every cell is taken
+    void BM_PlacePiece(benchmark::State& state) {
+        ProbeBoard board(state.range(0), state.range(0), WIN_SIZE);
+        const std::vector<std::tuple<int, int>> cells = shuffledCells(state.range(0), state.range(0));
+        std::size_t cellInd = 0;
+        const std::uint64_t startCount = allocationCount();
+        for(auto _ : state) {
+            if(cellInd == cells.size()) {
+                board.clearBoard();
+                cellInd = 0;
+            }
+            benchmark::DoNotOptimize(board.placePiece(std::get<0>(cells[cellInd]), std::get<1>(cells[cellInd]),
+                                                      cellInd % 2 ? CellState::white : CellState::black));
+            cellInd++;
+        }
+        reportAllocations(state, startCount);
+    }
+
+    void BM_CheckWin(benchmark::State& state) {
+        ProbeBoard board(state.range(0), state.range(0), WIN_SIZE);
+        playPosition(board, shuffledCells(state.range(0), state.range(0)));
+        const std::uint64_t startCount = allocationCount();
+        for(auto _ : state)
+            benchmark::DoNotOptimize(board.checkWin());
+        reportAllocations(state, startCount);
+    }
+
+    void BM_EnumerateInARow(benchmark::State& state) {
+        ProbeBoard board(state.range(0), state.range(0), WIN_SIZE);
+        playPosition(board, shuffledCells(state.range(0), state.range(0)));
+        const std::uint64_t startCount = allocationCount();
+        for(auto _ : state)
+            benchmark::DoNotOptimize(board.enumerateInARow());
+        reportAllocations(state, startCount);
+    }
+
+    // reads every line of one direction in turn
+    template<typename Getter>
+    void benchLineGetter(benchmark::State& state, Getter getter) {
+        const int boardSize = state.range(0);
+        ProbeBoard board(boardSize, boardSize, WIN_SIZE);
+        playPosition(board, shuffledCells(boardSize, boardSize));
+        int lineInd = 0;
+        const std::uint64_t startCount = allocationCount();
+        for(auto _ : state) {
+            benchmark::DoNotOptimize(getter(board, lineInd));
+            lineInd = lineInd + 1 == boardSize ? 0 : lineInd + 1;
+        }
+        reportAllocations(state, startCount);
+    }
+
+    void BM_GetRowVec(benchmark::State& state) {
+        benchLineGetter(state, [](ProbeBoard& board, int lineInd) { return board.getRowVec(lineInd); });
+    }
+
+    void BM_GetColVec(benchmark::State& state) {
+        benchLineGetter(state, [](ProbeBoard& board, int lineInd) { return board.getColVec(lineInd); });
+    }
+
+    void BM_GetForwardDiagVec(benchmark::State& state) {
+        benchLineGetter(state, [](ProbeBoard& board, int lineInd) { return board.getForwardDiagVec(lineInd, lineInd); });
+    }
+
+    void BM_GetBackDiagVec(benchmark::State& state) {
+        benchLineGetter(state, [](ProbeBoard& board, int lineInd) { return board.getBackDiagVec(lineInd, lineInd); });
+    }
+
+    // clears a mid-game position every iteration (refilling it is not timed)
+    void BM_ClearBoard(benchmark::State& state) {
+        ProbeBoard board(state.range(0), state.range(0), WIN_SIZE);
+        const std::vector<std::tuple<int, int>> cells = shuffledCells(state.range(0), state.range(0));
+        std::uint64_t numAllocations = 0;
+        for(auto _ : state) {
+            state.PauseTiming();
+            playPosition(board, cells);
+            const std::uint64_t startCount = allocationCount();
+            state.ResumeTiming();
+            board.clearBoard();
+            numAllocations += allocationCount() - startCount;
+        }
+        state.counters["allocs"] = benchmark::Counter(static_cast<double>(numAllocations), benchmark::Counter::kAvgIterations);
+    }
+}
+
+BENCHMARK(BM_PlacePiece)->Arg(15)->Arg(12);
+BENCHMARK(BM_CheckWin)->Arg(15)->Arg(12);
+BENCHMARK(BM_EnumerateInARow)->Arg(15)->Arg(12);
+BENCHMARK(BM_GetRowVec)->Arg(15)->Arg(12);
+BENCHMARK(BM_GetColVec)->Arg(15)->Arg(12);
+BENCHMARK(BM_GetForwardDiagVec)->Arg(15)->Arg(12);
+BENCHMARK(BM_GetBackDiagVec)->Arg(15)->Arg(12);
+BENCHMARK(BM_ClearBoard)->Arg(15)->Arg(12);
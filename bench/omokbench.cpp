@@ -0,0 +1,172 @@
+#include <algorithm>
+#include "benchUtil.h"
+#include "batchOmok.h"
+#include "gomoku.h"
+
+// Benchmarks of the Omok rules and of replaying the SimulatedGames corpus
+namespace {
+    typedef MNKBoard::PieceDirection PieceDirection;
+
+    const int BOARD_SIZE = 15;
+
+    // the first corpus game long enough to have threes on the board, played up to its middle
+    void playMidGame(Omok& game) {
+        for(const std::vector<std::tuple<int, int>>& moves : corpusGames()) {
+            if(moves.size() < 40)
+                continue;
+            for(std::size_t moveInd=0; moveInd<moves.size()/2; moveInd++)
+                game.placePiece(std::get<0>(moves[moveInd]), std::get<1>(moves[moveInd]));
+            return;
+        }
+    }
+
+    std::vector<std::tuple<int, int>> emptyCells(Omok& game) {
+        std::vector<std::tuple<int, int>> cells;
+        for(int rowInd=0; rowInd<BOARD_SIZE; rowInd++)
+            for(int colInd=0; colInd<BOARD_SIZE; colInd++)
+                if(game.isPosEmpty(rowInd, colInd))
+                    cells.emplace_back(rowInd, colInd);
+        return cells;
+    }
+
+    // plays one move of a corpus game per iteration (rules and win check included)
+    void BM_OmokPlacePiece(benchmark::State& state) {
+        const std::vector<std::vector<std::tuple<int, int>>>& games = corpusGames();
+        if(games.empty()) {
+            state.SkipWithError("SimulatedGames corpus not found");
+            return;
+        }
+        Omok game(static_cast<Omok::RuleSet>(state.range(0)));
+        std::size_t gameInd = 0, moveInd = 0;
+        const std::uint64_t startCount = allocationCount();
+        for(auto _ : state) {
+            while(moveInd == games[gameInd].size()) {
+                game.clearBoard();
+                gameInd = gameInd + 1 == games.size() ? 0 : gameInd + 1;
+                moveInd = 0;
+            }
+            benchmark::DoNotOptimize(game.placePiece(std::get<0>(games[gameInd][moveInd]), std::get<1>(games[gameInd][moveInd])));
+            moveInd++;
+        }
+        reportAllocations(state, startCount);
+    }
+
+    // one empty cell of a mid-game position per iteration
+    template<typename Query>
+    void benchCellQuery(benchmark::State& state, Omok::RuleSet ruleSet, Query query) {
+        Omok game(ruleSet);
+        playMidGame(game);
+        const std::vector<std::tuple<int, int>> cells = emptyCells(game);
+        if(cells.empty()) {
+            state.SkipWithError("SimulatedGames corpus not found");
+            return;
+        }
+        std::size_t cellInd = 0;
+        const std::uint64_t startCount = allocationCount();
+        for(auto _ : state) {
+            benchmark::DoNotOptimize(query(game, std::get<0>(cells[cellInd]), std::get<1>(cells[cellInd])));
+            cellInd = cellInd + 1 == cells.size() ? 0 : cellInd + 1;
+        }
+        reportAllocations(state, startCount);
+    }
+
+    void BM_IsDoubleThree(benchmark::State& state) {
+        benchCellQuery(state, Omok::RuleSet::omok, [](Omok& game, int row, int col) { return game.isDoubleThree(row, col); });
+    }
+
+    void BM_IsForbiddenRenju(benchmark::State& state) {
+        benchCellQuery(state, Omok::RuleSet::renju, [](Omok& game, int row, int col) { return game.isForbidden(row, col); });
+    }
+
+    // the open three check of every direction (formerly openThreeCheck)
+    void BM_OpenThreeGaps(benchmark::State& state) {
+        benchCellQuery(state, Omok::RuleSet::omok, [](Omok& game, int row, int col) {
+            MNKBoard::LineBits gaps = 0;
+            for(int dirInd=0; dirInd<MNKBoard::NUM_DIRS; dirInd++)
+                gaps |= game.openThreeGaps(row, col, game.getCurrentPlayer(), static_cast<PieceDirection>(dirInd));
+            return gaps;
+        });
+    }
+
+    void BM_OmokClearBoard(benchmark::State& state) {
+        Omok game;
+        std::uint64_t numAllocations = 0;
+        for(auto _ : state) {
+            state.PauseTiming();
+            playMidGame(game);
+            const std::uint64_t startCount = allocationCount();
+            state.ResumeTiming();
+            game.clearBoard();
+            numAllocations += allocationCount() - startCount;
+        }
+        state.counters["allocs"] = benchmark::Counter(static_cast<double>(numAllocations), benchmark::Counter::kAvgIterations);
+    }
+
+    // replays the whole corpus per iteration; "moves" is the rate of replayed moves
+    void BM_ReplayCorpus(benchmark::State& state) {
+        const std::vector<std::vector<std::tuple<int, int>>>& games = corpusGames();
+        if(games.empty()) {
+            state.SkipWithError("SimulatedGames corpus not found");
+            return;
+        }
+        Omok game(static_cast<Omok::RuleSet>(state.range(0)));
+        std::int64_t numMoves = 0;
+        const std::uint64_t startCount = allocationCount();
+        for(auto _ : state) {
+            for(const std::vector<std::tuple<int, int>>& moves : games) {
+                game.clearBoard();
+                for(const std::tuple<int, int>& move : moves)
+                    game.placePiece(std::get<0>(move), std::get<1>(move));
+                numMoves += moves.size();
+            }
+            benchmark::DoNotOptimize(game.getGameWinner());
+        }
+        // counted before the counters are added, as adding them allocates
+        const std::uint64_t numAllocations = allocationCount() - startCount;
+        reportAllocations(state, startCount);
+        state.counters["moves"] = benchmark::Counter(static_cast<double>(numMoves), benchmark::Counter::kIsRate);
+        state.counters["allocsPerMove"] = benchmark::Counter(static_cast<double>(numAllocations) / numMoves);
+    }
+
+    // replays the whole corpus per iteration with every game an environment of one batch
+    void BM_BatchReplayCorpus(benchmark::State& state) {
+        const std::vector<std::vector<std::tuple<int, int>>>& games = corpusGames();
+        if(games.empty()) {
+            state.SkipWithError("SimulatedGames corpus not found");
+            return;
+        }
+        BatchOmok batch(static_cast<int>(games.size()), static_cast<Omok::RuleSet>(state.range(0)));
+        std::size_t maxMoves = 0;
+        for(const std::vector<std::tuple<int, int>>& moves : games)
+            maxMoves = std::max(maxMoves, moves.size());
+
+        // moves laid out per step, games out of moves being skipped
+        std::vector<BatchOmok::Move> steps(maxMoves * games.size(), BatchOmok::Move{-1, -1});
+        std::int64_t numMoves = 0, numReplayed = 0;
+        for(std::size_t gameInd=0; gameInd<games.size(); gameInd++) {
+            for(std::size_t moveInd=0; moveInd<games[gameInd].size(); moveInd++)
+                steps[moveInd*games.size() + gameInd] = {std::get<0>(games[gameInd][moveInd]), std::get<1>(games[gameInd][moveInd])};
+            numMoves += games[gameInd].size();
+        }
+
+        const std::uint64_t startCount = allocationCount();
+        for(auto _ : state) {
+            batch.clearBoards();
+            for(std::size_t moveInd=0; moveInd<maxMoves; moveInd++)
+                benchmark::DoNotOptimize(batch.placePieces(&steps[moveInd*games.size()]));
+            numReplayed += numMoves;
+        }
+        const std::uint64_t numAllocations = allocationCount() - startCount;
+        reportAllocations(state, startCount);
+        state.counters["moves"] = benchmark::Counter(static_cast<double>(numReplayed), benchmark::Counter::kIsRate);
+        state.counters["allocsPerMove"] = benchmark::Counter(static_cast<double>(numAllocations) / numReplayed);
+    }
+}
+
+BENCHMARK(BM_OmokPlacePiece)->Arg(static_cast<int>(Omok::RuleSet::omok))->Arg(static_cast<int>(Omok::RuleSet::renju));
+BENCHMARK(BM_IsDoubleThree);
+BENCHMARK(BM_IsForbiddenRenju);
+BENCHMARK(BM_OpenThreeGaps);
+BENCHMARK(BM_OmokClearBoard);
+BENCHMARK(BM_ReplayCorpus)->Arg(static_cast<int>(Omok::RuleSet::omok))->Arg(static_cast<int>(Omok::RuleSet::renju))->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_BatchReplayCorpus)->Arg(static_cast<int>(Omok::RuleSet::omok))->Arg(static_cast<int>(Omok::RuleSet::renju))->Unit(benchmark::kMillisecond);
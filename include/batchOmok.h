@@ -0,0 +1,100 @@
+#ifndef BATCHOMOK_H
+#define BATCHOMOK_H
+
+// Required imports
+#include <cstdint>
+#include <vector>
+#include "gomoku.h"
+
+/**
+ * BatchOmok
+ *
+ * Steps many independent Omok games at once, for self-play with thousands of
+ * environments. The games are kept as a structure of arrays: one array per field of
+ * the game state (player to move, finished flag, number of moves) and a single block
+ * holding the line planes of every game, 88 lines of 16 bits per player on the 15x15
+ * board. placePieces applies one move to every game in a single pass over these arrays
+ * and reports the outcome of every game through a flag array, without a virtual call or
+ * an allocation per move.
+ *
+ * The rules are exactly those of Omok::placePiece: a move onto an occupied cell, off
+ * the board or into a finished game is refused, and so is a move the rule set forbids
+ * (read from the same pattern table as Omok). A game is skipped for a step by giving it
+ * a move off the board, such as (-1, -1).
+ **/
+class BatchOmok{
+public:
+    struct Move {
+        int row;
+        int col;
+    };
+
+    // outcome of a step, per game
+    enum StepFlags: std::uint8_t{
+        PLACED = 1,         // the move was played
+        FORBIDDEN = 2,      // refused by the rule set
+        WIN = 4,            // the move won the game (five, or an overline under freestyle)
+        FINISHED = 8        // the game is over (after this move or before it)
+    };
+
+    BatchOmok(int numGames, Omok::RuleSet ruleSet = Omok::RuleSet::omok);
+
+    // plays moves[gameInd] in every game; returns the StepFlags of every game, valid until
+    // the next step
+    const std::uint8_t* placePieces(const Move* moves);
+
+    // clears every game, or a single one
+    void clearBoards(void);
+    void clearBoard(int gameInd);
+
+    int size(void) const;
+    Omok::RuleSet getRuleSet(void) const;
+
+    // state of a single game, as the Omok functions of the same name
+    CellState getCell(int gameInd, int row, int col) const;
+    CellState getCurrentPlayer(int gameInd) const;
+    bool isFinished(int gameInd) const;
+    int getGameWinner(int gameInd) const;
+    int getMoveCount(int gameInd) const;
+
+private:
+    typedef MNKBoard::LineBits LineBits;
+    typedef MNKBoard::PieceDirection PieceDirection;
+    typedef std::uint16_t LineWord;
+
+    inline static const int BOARD_SIZE = Omok::BOARD_SIZE;
+    inline static const int NUM_DIAGS = 2*BOARD_SIZE - 1;
+    // lines of a player: columns, rows, then both kinds of diagonals
+    inline static const int LINE_OFFSETS[MNKBoard::NUM_DIRS] = {0, BOARD_SIZE, 2*BOARD_SIZE, 2*BOARD_SIZE + NUM_DIAGS};
+    inline static const int NUM_LINES = 2*BOARD_SIZE + 2*NUM_DIAGS;
+    inline static const int PLANES_SIZE = 2*NUM_LINES;      // line words of one game
+
+    int numGames;
+    Omok::RuleSet ruleSet;
+    std::vector<LineWord> linePlanes;       // [game][player][line]
+    std::vector<CellState> curPlayers;
+    std::vector<std::uint8_t> gamesFinished;
+    std::vector<std::uint8_t> moveCounts;
+    std::vector<std::uint8_t> stepFlags;
+
+    // position of a cell's line among the lines of a player
+    static int lineIndex(PieceDirection dir, int row, int col);
+    // bits of the board's cells for every line
+    static const LineWord* lineMasks(void);
+
+    // the rules read the line planes of a single game
+    static LineBits getLineBits(const LineWord* planes, CellState state, PieceDirection dir, int row, int col);
+    static void flipPiece(LineWord* planes, CellState player, int row, int col);
+    static int patternIndex(const LineWord* planes, int row, int col, CellState player, PieceDirection dir);
+    bool isForbidden(LineWord* planes, CellState player, int row, int col) const;
+
+    // the line planes of a game as RenjuRules reads them
+    struct RenjuPlanes {
+        LineWord* planes;
+        int patternIndex(int row, int col, PieceDirection dir, int depth) const;
+        void placeBlack(int row, int col);
+        void removeBlack(int row, int col);
+    };
+};
+
+#endif
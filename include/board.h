@@ -0,0 +1,232 @@
+#ifndef BOARD_H
+#define BOARD_H
+
+// Required imports
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include "mnkGame.h"
+
+/**
+ * Board
+ *
+ * Implements the line planes of an M x N board for a K-in-a-row game (see MNKBoard for
+ * the layout) with every dimension fixed at compile time. The storage is a plain array,
+ * and the number of lines of every direction, the board mask of every line, the line and
+ * bit of every cell along each direction and the win masks are tables of the type. Loops
+ * over lines and directions therefore have constant bounds and placing a piece needs no
+ * index arithmetic.
+ *
+ * MNKBoard keeps its runtime interface and runs on a Board for the sizes that are
+ * actually played (see BoardCore::create); other sizes use a runtime-sized core.
+ **/
+template<int M, int N, int K>
+class Board{
+    static_assert(M > 0 && N > 0 && M <= MNKBoard::MAX_DIM && N <= MNKBoard::MAX_DIM,
+                  "Board dimensions must lie within [1, 64]");
+    static_assert(K > 0 && K <= MNKBoard::MAX_DIM, "Board win size must lie within [1, 64]");
+
+public:
+    typedef MNKBoard::LineBits LineBits;
+    typedef MNKBoard::PieceDirection PieceDirection;
+
+    inline static constexpr int NUM_ROWS = M;
+    inline static constexpr int NUM_COLS = N;
+    inline static constexpr int WIN_SIZE = K;
+    inline static constexpr int NUM_CELLS = M*N;
+    inline static constexpr int NUM_DIRS = MNKBoard::NUM_DIRS;
+
+    // lines of every direction (columns, rows and both diagonals), stored one after the other
+    inline static constexpr std::array<int, NUM_DIRS> NUM_LINES = {N, M, M+N-1, M+N-1};
+    inline static constexpr std::array<int, NUM_DIRS> LINE_OFFSETS = {0, N, N+M, N+M+(M+N-1)};
+    inline static constexpr int TOTAL_LINES = N + M + 2*(M+N-1);
+
+    static constexpr int lineIndex(PieceDirection dir, int row, int col) {
+        switch(dir) {
+            case PieceDirection::VERT: return col;
+            case PieceDirection::HORZ: return row;
+            case PieceDirection::FSD:  return row + col;
+            default:                   return col - row + M - 1;
+        }
+    }
+
+    static constexpr int bitIndex(PieceDirection dir, int row, int col) {
+        return dir == PieceDirection::VERT ? row : col;
+    }
+
+private:
+    static constexpr LineBits lowBitsMask(int numBits) {
+        return numBits >= 64 ? ~LineBits(0) : ((LineBits(1) << numBits) - 1);
+    }
+
+    // bits of every line that lie on the board
+    static constexpr std::array<LineBits, TOTAL_LINES> buildLineMasks(void) {
+        std::array<LineBits, TOTAL_LINES> masks{};
+        for(int rowInd=0; rowInd<M; rowInd++)
+            for(int colInd=0; colInd<N; colInd++)
+                for(int dirInd=0; dirInd<NUM_DIRS; dirInd++) {
+                    const PieceDirection dir = static_cast<PieceDirection>(dirInd);
+                    masks[LINE_OFFSETS[dirInd] + lineIndex(dir, rowInd, colInd)] |= LineBits(1) << bitIndex(dir, rowInd, colInd);
+                }
+        return masks;
+    }
+
+    // stored line (offset included) and bit of every cell along every direction
+    struct CellTable {
+        std::uint16_t lines[NUM_DIRS][NUM_CELLS];
+        std::uint8_t bits[NUM_DIRS][NUM_CELLS];
+    };
+    static constexpr CellTable buildCellTable(void) {
+        CellTable table{};
+        for(int dirInd=0; dirInd<NUM_DIRS; dirInd++)
+            for(int cellInd=0; cellInd<NUM_CELLS; cellInd++) {
+                const PieceDirection dir = static_cast<PieceDirection>(dirInd);
+                table.lines[dirInd][cellInd] = LINE_OFFSETS[dirInd] + lineIndex(dir, cellInd / N, cellInd % N);
+                table.bits[dirInd][cellInd] = bitIndex(dir, cellInd / N, cellInd % N);
+            }
+        return table;
+    }
+
+    // WIN_MASKS[bit] holds the first bits of the K-cell windows that cover the bit
+    static constexpr std::array<LineBits, MNKBoard::MAX_DIM> buildWinMasks(void) {
+        std::array<LineBits, MNKBoard::MAX_DIM> masks{};
+        for(int bit=0; bit<MNKBoard::MAX_DIM; bit++)
+            masks[bit] = lowBitsMask(bit+1) & ~lowBitsMask(bit+1 >= K ? bit+1-K : 0);
+        return masks;
+    }
+
+public:
+    inline static constexpr std::array<LineBits, TOTAL_LINES> LINE_MASKS = buildLineMasks();
+    inline static constexpr CellTable CELLS = buildCellTable();
+    inline static constexpr std::array<LineBits, MNKBoard::MAX_DIM> WIN_MASKS = buildWinMasks();
+
+    // fills the cell for the player (the cell must be on the board and empty)
+    void setCell(int playerInd, int row, int col) {
+        const int cellInd = row*N + col;
+        for(int dirInd=0; dirInd<NUM_DIRS; dirInd++)
+            planes[playerInd][CELLS.lines[dirInd][cellInd]] |= LineBits(1) << CELLS.bits[dirInd][cellInd];
+    }
+
+    void clearCell(int row, int col) {
+        const int cellInd = row*N + col;
+        for(int dirInd=0; dirInd<NUM_DIRS; dirInd++) {
+            const LineBits clearMask = ~(LineBits(1) << CELLS.bits[dirInd][cellInd]);
+            planes[0][CELLS.lines[dirInd][cellInd]] &= clearMask;
+            planes[1][CELLS.lines[dirInd][cellInd]] &= clearMask;
+        }
+    }
+
+    CellState getCell(int row, int col) const {
+        const int lineInd = LINE_OFFSETS[(int)PieceDirection::HORZ] + row;
+        if((planes[0][lineInd] >> col) & 1)
+            return CellState::black;
+        if((planes[1][lineInd] >> col) & 1)
+            return CellState::white;
+        return CellState::none;
+    }
+
+    // bits of a line of the player, or the open cells of the line for CellState::none
+    LineBits getLine(CellState state, PieceDirection dir, int lineInd) const {
+        const int storedInd = LINE_OFFSETS[(int)dir] + lineInd;
+        if(state == CellState::none)
+            return LINE_MASKS[storedInd] & ~(planes[0][storedInd] | planes[1][storedInd]);
+        return planes[MNKBoard::playerIndex(state)][storedInd];
+    }
+
+    // whether the player has at least K pieces in a row through (row, col)
+    bool hasRun(int playerInd, int row, int col) const {
+        const int cellInd = row*N + col;
+        for(int dirInd=0; dirInd<NUM_DIRS; dirInd++) {
+            const LineBits lineBits = planes[playerInd][CELLS.lines[dirInd][cellInd]];
+            LineBits windowStarts = lineBits;
+            for(int shiftVal=1; shiftVal<K; shiftVal++)
+                windowStarts &= lineBits >> shiftVal;
+            if(windowStarts & WIN_MASKS[CELLS.bits[dirInd][cellInd]])
+                return true;
+        }
+        return false;
+    }
+
+    void clear(void) {
+        planes[0].fill(0);
+        planes[1].fill(0);
+    }
+
+    // first stored line of a direction, for readers that index lines themselves
+    LineBits* linePlane(int playerInd, PieceDirection dir) {
+        return planes[playerInd].data() + LINE_OFFSETS[(int)dir];
+    }
+    static const LineBits* lineMask(PieceDirection dir) {
+        return LINE_MASKS.data() + LINE_OFFSETS[(int)dir];
+    }
+
+private:
+    std::array<LineBits, TOTAL_LINES> planes[2] = {};
+};
+
+/**
+ * BoardCore
+ *
+ * Type-erased storage behind an MNKBoard. The line planes and masks are exposed as plain
+ * pointers so that reading a line never goes through a virtual call; only placing,
+ * removing, clearing and the win check do, and those run the size-specific code.
+ *
+ * A core is built inside a block the board provides, with every line it stores in that
+ * block: the lines of each player follow one another (planes[player][0] spans all
+ * totalLines of them), so a core is copied with one memcpy per player.
+ **/
+class BoardCore{
+public:
+    typedef MNKBoard::LineBits LineBits;
+    typedef MNKBoard::PieceDirection PieceDirection;
+
+    // picks the compile-time board for the sizes in use and a runtime-sized one otherwise,
+    // and builds it in memory of storageSize bytes (aligned for LineBits)
+    static std::size_t storageSize(int m, int n, int k);
+    static BoardCore* create(int m, int n, int k, void* memory);
+
+    BoardCore(void) = default;
+    BoardCore(const BoardCore& otherCore) = delete;
+    BoardCore& operator=(const BoardCore& otherCore) = delete;
+    virtual ~BoardCore() = default;
+
+    virtual void setCell(int playerInd, int row, int col) = 0;
+    virtual void clearCell(int row, int col) = 0;
+    virtual bool hasRun(int playerInd, int row, int col) const = 0;
+    virtual void clear(void) = 0;
+
+    // copies the pieces of a core of the same size
+    void copyFrom(const BoardCore& otherCore);
+
+    // [player][direction] first line of the direction, [direction] its board masks
+    LineBits* planes[2][MNKBoard::NUM_DIRS];
+    const LineBits* masks[MNKBoard::NUM_DIRS];
+    int numLines[MNKBoard::NUM_DIRS];
+    int totalLines;
+};
+
+// BoardCore running on a compile-time board
+template<int M, int N, int K>
+class FixedBoardCore final : public BoardCore{
+public:
+    FixedBoardCore(void) {
+        for(int dirInd=0; dirInd<MNKBoard::NUM_DIRS; dirInd++) {
+            const PieceDirection dir = static_cast<PieceDirection>(dirInd);
+            planes[0][dirInd] = board.linePlane(0, dir);
+            planes[1][dirInd] = board.linePlane(1, dir);
+            masks[dirInd] = Board<M, N, K>::lineMask(dir);
+            numLines[dirInd] = Board<M, N, K>::NUM_LINES[dirInd];
+        }
+        totalLines = Board<M, N, K>::TOTAL_LINES;
+    }
+
+    void setCell(int playerInd, int row, int col) override { board.setCell(playerInd, row, col); }
+    void clearCell(int row, int col) override { board.clearCell(row, col); }
+    bool hasRun(int playerInd, int row, int col) const override { return board.hasRun(playerInd, row, col); }
+    void clear(void) override { board.clear(); }
+
+private:
+    Board<M, N, K> board;
+};
+
+#endif
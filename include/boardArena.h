@@ -0,0 +1,80 @@
+#ifndef BOARDARENA_H
+#define BOARDARENA_H
+
+// Required imports
+#include <cstddef>
+#include <vector>
+
+/**
+ * BoardArena
+ *
+ * Pool the boards of one thread draw their storage from, so that thousands of boards
+ * can be created (and copied) without going through malloc. Memory is carved from large
+ * chunks; a released block goes onto a free list of its size and is handed out again to
+ * the next board of the same size. Blocks are aligned to cache lines.
+ *
+ * An arena is not thread-safe (every search thread keeps its own), and it must outlive
+ * the boards that were created on it.
+ **/
+class BoardArena{
+public:
+    inline static const std::size_t ALIGNMENT = 64;
+    inline static const std::size_t DEFAULT_CHUNK_SIZE = 1 << 20;
+
+    explicit BoardArena(std::size_t chunkSize = DEFAULT_CHUNK_SIZE);
+    BoardArena(const BoardArena& otherArena) = delete;
+    BoardArena& operator=(const BoardArena& otherArena) = delete;
+    ~BoardArena();
+
+    void* allocate(std::size_t size);
+    void release(void* memory, std::size_t size);
+
+    // bytes taken from the heap so far
+    std::size_t getReservedBytes(void) const;
+
+private:
+    // free blocks are linked through their first word
+    struct FreeList {
+        std::size_t size;
+        void* head;
+    };
+
+    std::size_t chunkSize;
+    std::vector<void*> chunks;
+    char* chunkPos = nullptr;
+    std::size_t chunkLeft = 0;
+    std::size_t reservedBytes = 0;
+    std::vector<FreeList> freeLists;
+
+    static std::size_t roundSize(std::size_t size);
+};
+
+/**
+ * ArenaBlock
+ *
+ * One aligned block owned by a board, taken from an arena or (without one) from the
+ * heap, and given back when the block is destroyed. Blocks are move-only.
+ **/
+class ArenaBlock{
+public:
+    ArenaBlock(void) = default;
+    ArenaBlock(std::size_t size, BoardArena* arena);
+    ArenaBlock(const ArenaBlock& otherBlock) = delete;
+    ArenaBlock& operator=(const ArenaBlock& otherBlock) = delete;
+    ArenaBlock(ArenaBlock&& otherBlock) noexcept;
+    ArenaBlock& operator=(ArenaBlock&& otherBlock) noexcept;
+    ~ArenaBlock();
+
+    void* data(void) const { return memory; }
+    std::size_t size(void) const { return blockSize; }
+    BoardArena* getArena(void) const { return arena; }
+
+private:
+    void* memory = nullptr;
+    std::size_t blockSize = 0;
+    BoardArena* arena = nullptr;
+
+    void release(void);
+};
+
+#endif
@@ -0,0 +1,60 @@
+#ifndef BOARDSCAN_H
+#define BOARDSCAN_H
+
+// Required imports
+#include <cstdint>
+#include "mnkGame.h"
+
+/**
+ * BoardScanner
+ *
+ * Scans every row, column and diagonal of a board at once and counts the patterns of
+ * both players, for static evaluation and for extracting features of whole game records.
+ * All lines of the board are gathered into arrays and run through a kernel that works
+ * on several lines per instruction: 4 lines with AVX2, 2 with SSE2 and 1 otherwise. The
+ * kernel is picked from the features of the CPU at runtime, so one binary runs anywhere.
+ *
+ * Patterns are counted along the lines only, without the Omok / Renju rules:
+ *  - windows: the 5-cell windows free of opponent pieces, by number of own pieces,
+ *  - open threes: .xxx.. / ..xxx. / .x.xx. / .xx.x. (a three matching several shapes
+ *    counts once),
+ *  - open fours: .xxxx.,
+ *  - fives: exactly five in a row.
+ *
+ * The threat map marks, for every empty cell, whether the player completes five
+ * (a window with four own pieces) or makes a four (a window with three) by playing there.
+ **/
+
+// Pattern counts of a board, [player] indexed by MNKBoard::playerIndex
+struct BoardFeatures {
+    int windows[2][6] = {};
+    int openThrees[2] = {};
+    int openFours[2] = {};
+    int fives[2] = {};
+};
+
+class BoardScanner{
+public:
+    typedef MNKBoard::LineBits LineBits;
+
+    enum class Kernel: char{
+        scalar,
+        sse2,
+        avx2
+    };
+
+    // flags of a threat map cell
+    inline static const std::uint8_t FIVE_POINT = 1;
+    inline static const std::uint8_t FOUR_POINT = 2;
+
+    // fastest kernel the CPU supports
+    static Kernel bestKernel(void);
+    static bool isSupported(Kernel kernel);
+
+    // counts the patterns of both players. If threatMaps is given it receives the flags
+    // of every cell as [player][row*cols+col] (room for two times the board cells).
+    static void scan(MNKBoard& board, BoardFeatures& features, std::uint8_t* threatMaps = nullptr);
+    static void scan(MNKBoard& board, BoardFeatures& features, std::uint8_t* threatMaps, Kernel kernel);
+};
+
+#endif
@@ -0,0 +1,120 @@
+#ifndef DFPNSOLVER_H
+#define DFPNSOLVER_H
+
+// Required imports
+#include <cstdint>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include "gomoku.h"
+
+/**
+ * DfpnSolver
+ *
+ * Implements depth-first proof-number search (df-pn) to solve positions of an Omok
+ * game or of a plain m,n,k board. Every node keeps a (phi, delta) pair from the point
+ * of view of its side to move: phi is the proof number of its goal and delta the
+ * disproof number. A node is only re-expanded while both numbers stay below the
+ * thresholds handed down by its parent, and the numbers of every visited node live
+ * in a fixed-size transposition table, so memory use is bounded by the table size.
+ *
+ * Proof-number search only answers yes / no questions, so a position is solved with
+ * up to two searches: "can the side to move win?" and, if not, "can the opponent win?".
+ * A position where both answers are no is a proven draw.
+ *
+ * Moves are generated by the same rules in the solver and in the proof checker:
+ * an immediate win ends the node, and a pending win of the opponent has to be blocked.
+ **/
+
+// Game-theoretic value of a position for the side to move
+enum class ProofValue: char{
+    unknown,
+    win,
+    loss,
+    draw
+};
+
+// Outcome of a df-pn solve
+struct DfpnResult {
+    ProofValue value = ProofValue::unknown;
+    std::tuple<int, int> bestMove = std::make_tuple(-1, -1);   // winning move, or a move holding the draw
+    std::uint64_t nodes = 0;
+    bool limitReached = false;                                  // the node limit ran out (value is unknown)
+};
+
+// Rules of the solved game (defined alongside the solver)
+class DfpnPosition;
+
+class DfpnSolver{
+public:
+    explicit DfpnSolver(std::size_t ttSizeMB = 64, std::uint64_t nodeLimit = 10000000);
+    DfpnSolver(const DfpnSolver& otherSolver) = delete;
+    DfpnSolver& operator=(const DfpnSolver& otherSolver) = delete;
+
+    // solves the position for the side to move (the game is left unchanged)
+    DfpnResult solve(Omok& game);
+    // plain m,n,k rules: black moves first and the side to move follows from the piece counts
+    DfpnResult solve(MNKBoard& board);
+
+    // writes the proof of the last solved position to a file
+    bool saveProof(const std::string& filePath) const;
+
+    // replays a saved proof against a position and returns the value it proves
+    // (unknown if the file does not hold a valid proof for the position)
+    static ProofValue checkProofFile(Omok& game, const std::string& filePath);
+    static ProofValue checkProofFile(MNKBoard& board, const std::string& filePath);
+
+private:
+    inline static const std::uint32_t INF_NUM = 1u << 30;
+    inline static const int BUCKET_SIZE = 4;
+
+    // proof / disproof numbers of a position (work counts the nodes spent below it)
+    struct TTEntry {
+        std::uint64_t key = 0;
+        std::uint32_t phi = 0;
+        std::uint32_t delta = 0;
+        std::uint64_t work = 0;     // 0 marks an empty slot
+    };
+
+    // the moves a side chooses on its way to a proven goal, keyed by position
+    struct Proof {
+        CellState attacker;
+        bool attackerWins;
+        std::unordered_map<std::uint64_t, int> choices;
+    };
+
+    std::vector<TTEntry> table;
+    std::uint64_t nodeLimit;
+    std::uint64_t nodes = 0;
+    bool limitReached = false;
+    CellState attacker = CellState::black;
+
+    // description of the last solved position, for saveProof
+    int boardRows = 0;
+    int boardCols = 0;
+    int boardWinSize = 0;
+    std::uint64_t rootKey = 0;
+    ProofValue rootValue = ProofValue::unknown;
+    std::vector<Proof> proofs;
+
+    DfpnResult solvePosition(DfpnPosition& pos);
+    // runs one search for the given attacker and returns whether the attacker wins
+    bool runSearch(DfpnPosition& pos, CellState searchAttacker);
+    void mid(DfpnPosition& pos, std::uint64_t key, std::uint32_t thPhi, std::uint32_t thDelta);
+
+    // walks the solved tree and records the choices of the side reaching its goal
+    bool collectProof(DfpnPosition& pos, std::uint64_t key, Proof& proof, std::unordered_set<std::uint64_t>& visited);
+    // proof numbers of a child, solving it again if the table lost it
+    void resolveChild(DfpnPosition& pos, int move, std::uint64_t childKey, std::uint32_t& phi, std::uint32_t& delta);
+
+    void lookup(std::uint64_t key, std::uint32_t& phi, std::uint32_t& delta) const;
+    void store(std::uint64_t key, std::uint32_t phi, std::uint32_t delta, std::uint64_t work);
+    bool checkLimit(void);
+
+    static ProofValue checkProof(DfpnPosition& pos, const std::string& filePath);
+    static bool verifyNode(DfpnPosition& pos, std::uint64_t key, const Proof& proof, std::unordered_set<std::uint64_t>& verified);
+};
+
+#endif
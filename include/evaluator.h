@@ -0,0 +1,108 @@
+#ifndef EVALUATOR_H
+#define EVALUATOR_H
+
+// Required imports
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "gomoku.h"
+
+/**
+ * Batched leaf evaluation
+ *
+ * Search threads hand leaf positions to a BatchEvaluator, which encodes every position
+ * as a stack of float feature planes and gathers them into fixed-size batches. A full
+ * batch (or one that waited long enough) is evaluated with a single call into the
+ * backend, so that the backend can work on the whole batch as one matrix.
+ *
+ * Feature planes (rows x cols floats each, from the point of view of the side to move):
+ *  0) own pieces
+ *  1) opponent pieces
+ *  2) side to move (all ones when black is to move)
+ *  3) forbidden points of the side to move (under the rule set of the game)
+ **/
+
+// Output of the evaluation of one position
+struct EvalOutput {
+    float value = 0;                // expected result for the side to move in [-1, 1]
+    std::vector<float> policy;      // one logit per cell (row major)
+};
+
+// Interface of an evaluation backend (a network runtime, or the reference backend)
+class EvalBackend{
+public:
+    virtual ~EvalBackend() = default;
+
+    // evaluates batchSize positions stored back to back in inputs; writes one value per
+    // position and numRows*numCols policy logits per position
+    virtual void evaluate(const float* inputs, int batchSize, int numRows, int numCols,
+                          float* values, float* policies) = 0;
+};
+
+// Reference backend: a single dense layer with fixed pseudo-random weights
+class ReferenceBackend : public EvalBackend{
+public:
+    ReferenceBackend(int numRows, int numCols, std::uint64_t seed = 1);
+    void evaluate(const float* inputs, int batchSize, int numRows, int numCols,
+                  float* values, float* policies) override;
+
+private:
+    int numCells;
+    std::vector<float> policyWeights;   // (planes * cells) x cells, row major
+    std::vector<float> valueWeights;    // planes * cells
+};
+
+class BatchEvaluator{
+public:
+    inline static const int NUM_PLANES = 4;
+
+    // partially filled batches are evaluated once their first position waited maxWaitUs
+    BatchEvaluator(EvalBackend& backend, int batchSize, int numRows = 15, int numCols = 15, int maxWaitUs = 1000);
+    BatchEvaluator(const BatchEvaluator& otherEvaluator) = delete;
+    BatchEvaluator& operator=(const BatchEvaluator& otherEvaluator) = delete;
+
+    // submits a position and blocks until its batch has been evaluated (thread safe)
+    void evaluate(Omok& game, EvalOutput& output);
+
+    // evaluates positions gathered by a single caller, in batches of at most batchSize
+    void evaluateMany(Omok* const* games, int numGames, EvalOutput* outputs);
+
+    // encodes a position as NUM_PLANES feature planes
+    static void encodePosition(Omok& game, float* planes);
+
+    // statistics over the lifetime of the evaluator
+    std::uint64_t getNumPositions(void) const;
+    std::uint64_t getNumBatches(void) const;
+
+private:
+    // one batch worth of inputs and outputs
+    struct Batch {
+        std::vector<float> inputs;
+        std::vector<float> values;
+        std::vector<float> policies;
+        int numClaimed = 0;         // slots handed out to submitting threads
+        int numWritten = 0;         // slots whose inputs are encoded
+        bool isRunning = false;
+        bool isEvaluated = false;
+    };
+
+    EvalBackend& backend;
+    int batchSize;
+    int numRows;
+    int numCols;
+    int inputSize;
+    int maxWaitUs;
+
+    mutable std::mutex batchLock;
+    std::condition_variable batchDone;
+    std::shared_ptr<Batch> currentBatch;
+    std::uint64_t numPositions = 0;
+    std::uint64_t numBatches = 0;
+
+    std::shared_ptr<Batch> makeBatch(void) const;
+    void copyOutput(const Batch& batch, int slot, EvalOutput& output) const;
+};
+
+#endif
@@ -0,0 +1,94 @@
+#ifndef GAMEARCHIVE_H
+#define GAMEARCHIVE_H
+
+// Required imports
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <tuple>
+#include <vector>
+#include "gomoku.h"
+#include "mappedFile.h"
+
+/**
+ * Game archive (.garc)
+ *
+ * Stores many games of one board size in a single binary file:
+ *  - header (32 bytes): "GARC", version, rows, cols, flags, number of games and the offset
+ *    of the index,
+ *  - games, one after the other: the number of moves as a varint, then every move as its
+ *    cell index (row*cols + col) - a single byte on boards of at most 256 cells such as
+ *    15x15, a varint otherwise. With the METADATA flag every game ends with its result and
+ *    rule set (one byte each) and the time of every move in milliseconds (varints),
+ *  - index: the offset of every game plus the end of the last one (8 bytes each),
+ * with every fixed-width field little-endian. The index gives random access to any game
+ * of a memory-mapped archive without reading the others.
+ **/
+
+// one game of an archive
+struct ArchiveGame {
+    std::vector<std::tuple<int, int>> moves;    // (row, col) in playing order
+    // metadata (kept only by archives with the METADATA flag)
+    int result = -1;                            // as Omok::getGameWinner, -1 when unknown
+    Omok::RuleSet ruleSet = Omok::RuleSet::omok;
+    std::vector<int> times;                     // milliseconds per move (empty when unknown)
+};
+
+// writes an archive game by game; the index and header are completed by finish
+class GameArchiveWriter{
+public:
+    GameArchiveWriter(const std::string& filePath, int rows, int cols, std::uint32_t flags);
+
+    bool isOpen(void) const;
+    // false if a move lies off the board or the file cannot be written
+    bool addGame(const ArchiveGame& game);
+    bool finish(void);
+
+private:
+    std::ofstream archiveFile;
+    int numRows;
+    int numCols;
+    std::uint32_t flags;
+    std::vector<std::uint64_t> offsets;
+    std::vector<char> recordBuffer;             // reused for every game
+    bool isFinished = false;
+};
+
+// random access to the games of a memory-mapped archive
+class GameArchive{
+public:
+    inline static const std::uint32_t VERSION = 1;
+    inline static const std::uint32_t METADATA = 1;     // flag: results, rule sets and timings
+
+    explicit GameArchive(const std::string& filePath);
+
+    // false if the file is missing or not a valid archive
+    bool isOpen(void) const;
+    std::size_t size(void) const;
+    int getRows(void) const;
+    int getCols(void) const;
+    bool hasMetadata(void) const;
+
+    // decodes a game into the given one (its vectors are reused); false on a bad index or record
+    bool getGame(std::size_t gameInd, ArchiveGame& game) const;
+
+    /**
+     * Converts Piskvork records (see psqReader.h) into an archive. The result is taken
+     * from the file names (see PsqReplayer::expectedWinner) and every game gets the given
+     * rule set. Records that cannot be read are skipped; returns the number of games
+     * written, or -1 if the archive cannot be written.
+     **/
+    static long convertPsq(const std::vector<std::string>& psqPaths, const std::string& archivePath,
+                           Omok::RuleSet ruleSet = Omok::RuleSet::renju);
+
+private:
+    MappedFile archiveFile;
+    bool isValid = false;
+    int numRows = 0;
+    int numCols = 0;
+    std::uint32_t flags = 0;
+    std::size_t numGames = 0;
+    const char* indexData = nullptr;
+};
+
+#endif
@@ -2,9 +2,12 @@
 #define GOMOKU_H
 
 // Required imports
+#include <tuple>
 #include <utility>
-#include <unordered_map>
+#include <vector>
 #include "mnkGame.h"
+#include "linePatterns.h"
+#include "threatCache.h"
 
 // verbose output
 // #define OMOK_VERBOSE
@@ -16,9 +19,29 @@
  * specific rules are applied. The following rules are followed:
  *  1) No double 3's allowed 
  *  2) No overlines are allowed (only 5-in-a-row wins)
- *  3) The board must be 19x19 with a 5-in-a-row win condition
+ *  3) The board must be 15x15 with a 5-in-a-row win condition
+ *
+ * Under the Renju rule set black is restricted further: double threes (counting only
+ * the threes that can still become a straight four through a move that is not itself
+ * forbidden), double fours and overlines are all forbidden, while a move completing
+ * exactly five always stands. White keeps the rules above.
+ *
+ * The freestyle and standard rule sets (Gomocup rules 0 and 1) forbid no move at all:
+ * under freestyle an overline wins as well, under standard only exactly five does.
+ *
+ * The patterns both players would form on every cell are kept in a ThreatCache that is
+ * refreshed only along the four lines through each move, so that win detection, the
+ * rule checks and the searchers all read patterns without scanning the board.
  **/
 class Omok: public MNKBoard{
+public:
+    enum class RuleSet: char{
+        omok,       // no double threes for either player
+        renju,      // full Renju restrictions for black
+        freestyle,  // no forbidden moves, five or more in a row wins
+        standard    // no forbidden moves, only exactly five wins
+    };
+
 private:
     inline static const int BOARD_SIZE = 15;
     inline static const int KSIZE = 5;
@@ -26,50 +49,105 @@ private:
     bool gameFinished = false;
     bool gameStarted = false;
 
+    // game flags as they were before each recorded move (parallel to the board's undo stack)
+    struct GameFlags {
+        CellState curPlayer;
+        bool gameFinished;
+        bool gameStarted;
+    };
+    ArenaBlock flagStorage;
+    GameFlags* flagStack;
+
+    RuleSet ruleSet;
+    ThreatCache threats;
+    // steps many games under the same rules
+    friend class BatchOmok;
+
+    // the game as RenjuRules reads it: patterns come from the cache for the cell asked
+    // about and from the board once pieces were placed for the three check
+    struct RenjuBoard {
+        Omok& game;
+        int patternIndex(int row, int col, PieceDirection dir, int depth) const;
+        void placeBlack(int row, int col);
+        void removeBlack(int row, int col);
+    };
+
 public:
-    // inits omok board
-    Omok();
+    // inits omok board (with its storage from the arena, if one is given)
+    explicit Omok(RuleSet ruleSet = RuleSet::omok, BoardArena* arena = nullptr);
+
+    // copies carry the whole game (undo stack and threat cache included), see MNKBoard
+    Omok(const Omok& otherGame, BoardArena* arena = nullptr);
+    Omok& operator=(const Omok& otherGame);
+    Omok(Omok&& otherGame) = default;
+    Omok& operator=(Omok&& otherGame) = default;
 
     // modified placement schema
     // CellState should only be modified for testing
     bool placePiece(int row, int col);
 
+    // rule-checked placement that can be taken back with unmakeMove
+    bool makeMove(int row, int col);
+    bool unmakeMove(void);
+
     // used to determine when the game has finished
     bool isFinished(void);
 
+    // reports the player to move (or the winner once the game has finished)
+    CellState getCurrentPlayer(void) const;
+
+    // checks whether placing a piece for the current player would form a 3n3 sequence
+    bool isDoubleThree(int row, int col);
+
+    // checks whether the rule set forbids the current player to play on (row, col)
+    // (the first move of the game is never forbidden)
+    bool isForbidden(int row, int col);
+
+    // writes every empty cell that is forbidden for the current player as row*cols+col and
+    // returns their number (the buffer needs room for every cell of the board)
+    int getForbiddenPoints(int* cells);
+
+    RuleSet getRuleSet(void) const;
+
+    // whether the rule set forbids any moves, and whether an overline wins under it
+    static bool hasForbiddenMoves(RuleSet ruleSet);
+    static bool overlineWins(RuleSet ruleSet);
+    // whether a line pattern formed by a move wins the game under the rule set
+    static bool isWinningPattern(RuleSet ruleSet, LinePatterns::Pattern pattern);
+
+    // patterns and threat scores of every cell for both players
+    const ThreatCache& getThreats(void) const;
+
+    // empty cells (as line bits) of the open threes that the player would form along one
+    // direction by playing (row, col). Returns 0 if no open three would be formed.
+    LineBits openThreeGaps(int row, int col, CellState player, PieceDirection dir);
+
+    // strongest pattern the player would have through (row, col) along one direction by
+    // playing there (or has through a piece of its own already on the cell)
+    LinePatterns::Pattern getLinePattern(int row, int col, CellState player, PieceDirection dir) const;
+
     // reports the value of the player who won the game (0 if nobody has won yet)
     int getGameWinner(void);
 
     // clears the game board
     void clearBoard(void);
 
-private:
-    // enumerate possible open 3 conditions
-    class O3CondsContainer {
-        public:
-        inline static const int SIZE = 6;
-        static std::vector<CellState>& o3Cond1(CellState& player);
-        static std::vector<CellState>& o3Cond2(CellState& player);
-        static std::vector<CellState>& o3Cond3(CellState& player);
-        static std::vector<CellState>& o3Cond4(CellState& player);
-
-        private:
-        static inline std::unordered_map<CellState, std::vector<CellState>, EnumClassHash> cacheMap1;
-        static inline std::unordered_map<CellState, std::vector<CellState>, EnumClassHash> cacheMap2;
-        static inline std::unordered_map<CellState, std::vector<CellState>, EnumClassHash> cacheMap3;
-        static inline std::unordered_map<CellState, std::vector<CellState>, EnumClassHash> cacheMap4;
-    };
-
-    O3CondsContainer returnPlayerSpecificConds(const CellState& player);
+    // sets up a position from its stones, recorded as moves alternating from black's first
+    // stone in the order given. No rules are checked, as the stones may not come in the
+    // order they were played; false (with the board cleared) if the counts cannot alternate,
+    // two stones share a cell or a player already has a winning line
+    bool setPosition(const std::vector<std::tuple<int, int>>& blackStones,
+                     const std::vector<std::tuple<int, int>>& whiteStones);
 
-    // checks whether a 3-in-a-row sequence is an open three
-    bool openThreeCheck(const std::vector<CellState>& pieceArr);
+private:
+    // copies the flag stack, the player to move and the rule set
+    void copyGameState(const Omok& otherGame);
 
-    // helper function for 3n3 rule
-    bool isDoubleThree(int row, int col);
+    // index of the pattern window of the player around (row, col) along one direction
+    int patternIndex(int row, int col, CellState player, PieceDirection dir) const;
 
     // modified win detection
     void checkWin(void);
 };
 
-#endif
\ No newline at end of file
+#endif
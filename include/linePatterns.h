@@ -0,0 +1,100 @@
+#ifndef LINEPATTERNS_H
+#define LINEPATTERNS_H
+
+// Required imports
+#include <array>
+#include <cstdint>
+#include "mnkGame.h"
+
+/**
+ * LinePatterns
+ *
+ * Classifies the cells of a line around a piece with a single table lookup. The 9-cell
+ * window centred on the piece is read as a base-3 number (blocked, own piece or empty
+ * for every cell) together with whether the cells just outside the window hold own
+ * pieces, which is all that is needed to tell a five from an overline. The table is
+ * generated at compile time and holds, for every window:
+ *  - the strongest pattern through the piece (five, overline, open four, four, open three,
+ *    broken three or none),
+ *  - the empty cells that complete exactly five through the piece,
+ *  - the empty cells that turn the line into a straight four through the piece (the
+ *    threes of the Renju rules),
+ *  - the empty cells of the open three patterns inside the window (the Omok double
+ *    three rule).
+ *
+ * The window is always read from the point of view of one player, so the same table
+ * serves both players.
+ **/
+class LinePatterns{
+public:
+    typedef MNKBoard::LineBits LineBits;
+
+    // patterns in increasing order of strength
+    enum class Pattern: char{
+        none,
+        brokenThree,    // .x.xx. or .xx.x.
+        openThree,      // ..xxx. or .xxx..
+        four,           // one empty cell completes five
+        openFour,       // .xxxx. with both ends completing five
+        overline,
+        five
+    };
+
+    inline static const int WINDOW_SIZE = 9;
+    inline static const int CENTER = 4;
+    inline static const int WINDOW_STATES = 19683;          // 3^9
+    inline static const int TABLE_SIZE = 4*WINDOW_STATES;   // times the two outside cells
+
+    // layout of a table entry: three gaps in the low bits, then the five points, the
+    // straight four points and the pattern
+    inline static const int FIVE_SHIFT = 9;
+    inline static const int FOUR_SHIFT = 18;
+    inline static const int PATTERN_SHIFT = 27;
+
+    // index of the window around bit, with the piece at bit counted as the player's
+    static int windowIndex(LineBits ownBits, LineBits emptyBits, int bit) {
+        const LineBits pieceMask = LineBits(1) << bit;
+        ownBits |= pieceMask;
+        emptyBits &= ~pieceMask;
+        const int beyondLow = bit > CENTER ? (ownBits >> (bit-CENTER-1)) & 1 : 0;
+        const int beyondHigh = bit+CENTER+1 < 64 ? (ownBits >> (bit+CENTER+1)) & 1 : 0;
+        return BASE3[toWindow(ownBits, bit)] + 2*BASE3[toWindow(emptyBits, bit)]
+               + WINDOW_STATES*(beyondLow + 2*beyondHigh);
+    }
+
+    static Pattern getPattern(int index) {
+        return static_cast<Pattern>(TABLE[index] >> PATTERN_SHIFT);
+    }
+
+    // empty cells (as line bits) that complete exactly five through the piece at bit
+    static LineBits fivePoints(int index, int bit) {
+        return fromWindow((TABLE[index] >> FIVE_SHIFT) & WINDOW_MASK, bit);
+    }
+
+    // empty cells (as line bits) that make a straight four through the piece at bit
+    static LineBits straightFourPoints(int index, int bit) {
+        return fromWindow((TABLE[index] >> FOUR_SHIFT) & WINDOW_MASK, bit);
+    }
+
+    // empty cells (as line bits) of the open three patterns of the window around bit
+    static LineBits threeGaps(int index, int bit) {
+        return fromWindow(TABLE[index] & WINDOW_MASK, bit);
+    }
+
+private:
+    inline static const LineBits WINDOW_MASK = 0x1FF;
+
+    // BASE3[bits] reads the 9 bits as base-3 digits
+    static const std::array<std::uint16_t, 512> BASE3;
+    static const std::array<std::uint32_t, TABLE_SIZE> TABLE;
+
+    static LineBits toWindow(LineBits bits, int bit) {
+        return (bit >= CENTER ? bits >> (bit-CENTER) : bits << (CENTER-bit)) & WINDOW_MASK;
+    }
+
+    static LineBits fromWindow(LineBits windowBits, int bit) {
+        return bit >= CENTER ? windowBits << (bit-CENTER) : windowBits >> (CENTER-bit);
+    }
+};
+
+#endif
@@ -0,0 +1,35 @@
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+// Required imports
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/**
+ * MappedFile
+ *
+ * Read-only view of a whole file. The file is memory-mapped where the platform allows it,
+ * so readers scan the bytes in place and only the pages they touch are loaded; elsewhere
+ * (or if mapping fails) the file is read into memory once.
+ **/
+class MappedFile{
+public:
+    explicit MappedFile(const std::string& filePath);
+    MappedFile(const MappedFile& otherFile) = delete;
+    MappedFile& operator=(const MappedFile& otherFile) = delete;
+    ~MappedFile();
+
+    bool isOpen(void) const;
+    const char* data(void) const;
+    std::size_t size(void) const;
+
+private:
+    const char* fileData = nullptr;
+    std::size_t fileSize = 0;
+    bool isOpened = false;
+    bool isMapped = false;
+    std::vector<char> fileBuffer;   // contents when the file cannot be mapped
+};
+
+#endif
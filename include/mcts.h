@@ -0,0 +1,128 @@
+#ifndef MCTS_H
+#define MCTS_H
+
+// Required imports
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <tuple>
+#include <vector>
+#include "gomoku.h"
+
+/**
+ * MctsSearcher
+ *
+ * Implements Monte Carlo tree search over Omok positions. Every thread runs its own
+ * playouts on a private copy of the game (rebuilt from the move history) while all
+ * threads share a single tree:
+ *  - children are picked through UCT or PUCT (with pattern based priors),
+ *  - a thread passing through a node adds a virtual loss to it so that other threads
+ *    spread out over the tree, and removes it again when the playout is backed up,
+ *  - visit counts and scores are atomics, and a node is expanded by the first thread
+ *    that claims it.
+ *
+ * Nodes come from a fixed-capacity arena. When the next search starts from a position
+ * reached through the tree, the subtree below it is kept and compacted into a fresh
+ * arena, so the statistics of earlier searches are reused.
+ **/
+
+// Configuration of the searcher
+struct MctsConfig {
+    int numThreads = 1;
+    double exploration = 1.4;
+    bool usePuct = false;                   // PUCT with pattern priors instead of plain UCT
+    bool patternRollouts = true;            // rollouts complete and block fives instead of playing at random
+    int virtualLoss = 3;
+    int maxRolloutMoves = 80;               // rollouts running longer than this count as draws
+    std::size_t maxNodes = 1 << 20;
+    std::uint64_t seed = 0;
+};
+
+// Budget of a single search (0 means unlimited, but one of them has to be set)
+struct MctsLimits {
+    std::uint64_t maxPlayouts = 10000;
+    int maxTimeMs = 0;
+};
+
+// Outcome of a search
+struct MctsResult {
+    std::tuple<int, int> bestMove = std::make_tuple(-1, -1);  // most visited root move
+    double winRate = 0.5;                                      // for the side to move
+    std::uint64_t playouts = 0;
+    std::uint64_t reusedVisits = 0;                            // root visits carried over from the last search
+    std::size_t treeNodes = 0;
+    double elapsedMs = 0;
+    std::uint64_t playoutsPerSecond = 0;
+};
+
+class MctsSearcher{
+public:
+    explicit MctsSearcher(const MctsConfig& config = MctsConfig());
+    MctsSearcher(const MctsSearcher& otherSearcher) = delete;
+    MctsSearcher& operator=(const MctsSearcher& otherSearcher) = delete;
+
+    // searches the position for the side to move (the game is left unchanged)
+    MctsResult search(Omok& game, const MctsLimits& limits);
+
+    // drops the tree so that the next search starts from scratch
+    void clearTree(void);
+
+private:
+    // a tree node; scores are kept in half points for the player who moved into the node
+    struct Node {
+        std::atomic<std::int32_t> visits;
+        std::atomic<std::int32_t> virtualLosses;
+        std::atomic<std::int64_t> score;
+        std::atomic<std::uint32_t> firstChild;
+        std::atomic<std::uint32_t> numChildren;
+        std::atomic<std::uint8_t> state;
+        std::int32_t move;
+        float prior;
+    };
+    inline static const std::uint8_t UNEXPANDED = 0;
+    inline static const std::uint8_t EXPANDING = 1;
+    inline static const std::uint8_t EXPANDED = 2;
+    inline static const std::uint8_t TERMINAL = 3;     // the move into the node won the game
+
+    // per-thread playout state
+    struct Worker {
+        std::mt19937_64 randGen;
+        std::vector<std::uint32_t> path;
+        std::vector<int> moves;
+        std::vector<int> cells;
+        std::vector<float> priors;
+    };
+
+    MctsConfig config;
+    std::unique_ptr<Node[]> nodes;
+    std::unique_ptr<Node[]> spareNodes;     // target of the compaction on tree reuse
+    std::atomic<std::size_t> numNodes;
+    std::vector<std::tuple<int, int>> rootHistory;
+    int numCols = 0;
+    bool hasTree = false;
+
+    std::atomic<std::uint64_t> numPlayouts;
+    std::atomic<bool> stopSearch;
+
+    void resetTree(Omok& game);
+    // keeps the subtree of the searched position if it was reached through the tree
+    bool reuseTree(Omok& game);
+    void compactTree(std::uint32_t newRoot);
+
+    // runs playouts on the worker's own game until the limits are reached
+    void runWorker(Omok& game, int workerInd, const MctsLimits& limits, std::chrono::steady_clock::time_point startTime);
+    void playout(Omok& game, Worker& worker);
+    std::uint32_t selectChild(const Node& node, bool usePriors) const;
+    // expands the node for the side to move; returns false if another thread got there first
+    bool expandNode(Omok& game, Node& node, Worker& worker);
+    // plays the game out and returns the winner (CellState::none for draws)
+    CellState rollout(Omok& game, Worker& worker);
+
+    // pattern weight of a move for the side to move
+    static float moveWeight(Omok& game, int row, int col);
+    static void initNode(Node& node, int move, float prior);
+};
+
+#endif
@@ -2,19 +2,32 @@
 #define MNKGAME_H
 
 // Required imports
+#include <array>
 #include <iostream>
 #include <utility>
 #include <vector>
 #include <tuple>
+#include <cstdint>
+#include "boardArena.h"
 
 // VERBOSE OUTPUT
 // #define MNK_VERBOSE
 
 /**
  * MNKBoard
- * 
+ *
  * Implements the basic m x n board for a k-in-a-row
  * game.
+ *
+ * The board is stored as a set of bitboards. Every player owns one bit-plane
+ * per line direction (rows, columns and both diagonals), where each line of the
+ * board is packed into a single 64-bit word. Any query about a line through a
+ * cell is then a handful of shifts and ANDs on a single word.
+ *
+ * The planes live in a BoardCore (see board.h), which runs the compile-time Board of the
+ * board sizes in use and a runtime-sized implementation for every other size. The core
+ * and the undo stack share one aligned block, taken from a BoardArena when the board is
+ * given one, so copying a board copies a few hundred bytes and allocates at most once.
  **/
 
 // Enumerates possible board states
@@ -33,16 +46,17 @@ struct EnumClassHash {
     }
 };
 
+class BoardCore;
+
 class MNKBoard{
 private:
     unsigned int numRows;
     unsigned int numCols;
 
-protected:
-    unsigned int winSize;
-    CellState **board;  // stores board in row-major format (x,y)
-    CellState **flippedBoard;  // stores board in column-major format (y,x)
-    std::tuple<int, int> lastMove;
+public:
+    // a line of the board packed into a word (bit i is the i-th cell along the line)
+    typedef std::uint64_t LineBits;
+    inline static const int MAX_DIM = 64;
 
     // used to detect win directions and collect move
     enum class PieceDirection: char{
@@ -51,40 +65,132 @@ protected:
         FSD,        // [ie. bottom left to uper right]
         BSD         // [ie. upper left to bottom right]
     };
+    inline static const int NUM_DIRS = 4;
+
+    // board symmetries, as a transpose followed by flips of the rows and / or columns.
+    // Quarter turns and transposes only exist for square boards.
+    enum class Symmetry: char{
+        identity,
+        flipRows,       // mirrors top and bottom
+        flipCols,       // mirrors left and right
+        rotate180,
+        transpose,      // mirrors along the main diagonal
+        rotate270,      // a quarter turn counterclockwise
+        rotate90,       // a quarter turn clockwise
+        antiTranspose   // mirrors along the anti-diagonal
+    };
+    inline static const int NUM_SYMMETRIES = 8;
+
+    // maps a player / cell onto its line representation
+    static int playerIndex(CellState player) { return player == CellState::black ? 0 : 1; }
+    int lineIndex(PieceDirection dir, int row, int col) const;
+    static int bitIndex(PieceDirection dir, int row, int col) { return dir == PieceDirection::VERT ? row : col; }
+
+    // maps a bit of the line passing through (row, col) back onto board coordinates
+    static std::tuple<int, int> lineCell(PieceDirection dir, int row, int col, int bit);
+
+    // returns the bits of the line passing through (row, col) for the given state
+    // (CellState::none reports the empty cells of the line)
+    LineBits getLineBits(CellState state, PieceDirection dir, int row, int col) const;
+
+    // same as getLineBits but addresses the line by its index, for scans over the whole board
+    LineBits getLine(CellState state, PieceDirection dir, int lineInd) const;
+    int getNumLines(PieceDirection dir) const;
+
+    // cells of a line (or of a window of one) in increasing bit order, held in a fixed
+    // buffer so that reading a line never allocates
+    class LineCells{
+    public:
+        const CellState* begin(void) const { return cells; }
+        const CellState* end(void) const { return cells + numCells; }
+        int size(void) const { return numCells; }
+        CellState operator[](int cellInd) const { return cells[cellInd]; }
+
+    private:
+        friend class MNKBoard;
+        CellState cells[MAX_DIM];
+        int numCells = 0;
+    };
 
-    // some helper functions that might be useful for other classes
-    int updateVertPos(const CellState player, std::tuple<int, int>& pieceL, 
-                        std::tuple<int, int>& pieceR);
-    int updateHorzPos(const CellState player, std::tuple<int, int>& pieceL, 
-                        std::tuple<int, int>& pieceR);
-    int updateFSDPos(const CellState player, std::tuple<int, int>& pieceL, 
-                        std::tuple<int, int>& pieceR);
-    int updateBSDPos(const CellState player, std::tuple<int, int>& pieceL, 
-                        std::tuple<int, int>& pieceR);
+    // run of pieces through a cell along one direction and its two end points
+    struct Run {
+        int length;
+        PieceDirection dir;
+        std::tuple<int, int> lowEnd;
+        std::tuple<int, int> highEnd;
+    };
+
+    // length of the run of the player's pieces through the given bit of a line
+    static int runLength(LineBits line, int bit, int& lowBit, int& highBit);
+
+protected:
+    unsigned int winSize;
+    std::tuple<int, int> lastMove;
+
+    // linePlanes[player][direction][line] holds the bits of a single player for one line.
+    // Rows are indexed by row and use the column as bit index, columns are indexed by
+    // column and use the row as bit index. Diagonals use the column as the bit index and
+    // are indexed by (row+col) for (/) diagonals and (col-row+numRows-1) for (\) diagonals.
+    // The planes and masks are owned by the core; these point into it.
+    ArenaBlock storage;                         // the core followed by the undo stack
+    BoardCore* core = nullptr;
+    LineBits* linePlanes[2][NUM_DIRS];
+    const LineBits* lineMasks[NUM_DIRS];        // bits that lie on the board for each line
+    int numLines[NUM_DIRS];
+
+    // undo information for a single recorded move
+    struct MoveRecord {
+        int row;
+        int col;
+        std::tuple<int, int> prevLastMove;
+    };
 
-    // creates a list that sums up all pieces in a row (given last played piece)
-    std::vector<std::tuple<int, PieceDirection, std::tuple<int, int>, std::tuple<int, int>>> enumerateInARow(void);
+    // fixed-capacity undo stack (one slot per cell, as every move fills a cell)
+    MoveRecord* moveStack = nullptr;
+    int moveCount = 0;
 
-    // queries a specific row or column and returns a vector containing the requisite values
-    const std::vector<CellState> getRowVec(int rowInd);
-    const std::vector<CellState> getColVec(int colInd);
+    // Zobrist key of the current position, updated on every placement and removal
+    std::uint64_t hashKey = 0;
+    // pieces-only keys of the position under every symmetry, updated along with hashKey
+    std::uint64_t symmetryKeys[NUM_SYMMETRIES] = {};
+    int numSymmetries;
+    void updateSymmetryKeys(CellState player, int row, int col);
+
+    // builds the core and undo stack of the current size in a new block, and destroys them
+    void allocateStorage(BoardArena* arena);
+    void releaseStorage(void);
+    // copies the position and undo stack of a board of the same size into the block
+    void copyState(const MNKBoard& otherBoard);
+
+    // sums up all pieces in a row through the last played piece, one run per direction
+    std::array<Run, NUM_DIRS> enumerateInARow(void);
+
+    // queries a specific row or column and returns the requisite values
+    LineCells getRowVec(int rowInd);
+    LineCells getColVec(int colInd);
 
     // queries a particular directional diagonal given a point's placement
-    const std::vector<CellState> getForwardDiagVec(int pieceRow, int pieceCol, int windowSize = 0); // (/)-directional
-    const std::vector<CellState> getBackDiagVec(int pieceRow, int pieceCol, int windowSize = 0); // (\)-directional
-    void vectorBuilderHelper(std::vector<CellState>& toModify, int windowSize, int row, int col, int deltaY, int deltaX);
+    LineCells getForwardDiagVec(int pieceRow, int pieceCol, int windowSize = 0); // (/)-directional
+    LineCells getBackDiagVec(int pieceRow, int pieceCol, int windowSize = 0); // (\)-directional
+    LineCells lineVecHelper(PieceDirection dir, int pieceRow, int pieceCol, int windowSize);
 
-    // helps prints tuples for feedback
+    // helps prints runs for feedback
     #ifdef MNK_VERBOSE
-    void tuplePrinterHelper(std::tuple<int, PieceDirection, std::tuple<int, int>, std::tuple<int, int>>);
+    void tuplePrinterHelper(const Run& run);
     #endif
 
 public:
-    // Init m x n game of k in a row
-    MNKBoard(int m, int n, int k);
-    MNKBoard(const MNKBoard& otherBoard) = delete;
-    MNKBoard& operator=(const MNKBoard& otherBoard) = delete;
-    ~MNKBoard();
+    // Init m x n game of k in a row (with its storage from the arena, if one is given)
+    MNKBoard(int m, int n, int k, BoardArena* arena = nullptr);
+
+    // a copy is an independent board with its storage from the given arena (or the heap).
+    // Assigning a board of the same size copies in place without allocating.
+    MNKBoard(const MNKBoard& otherBoard, BoardArena* arena = nullptr);
+    MNKBoard& operator=(const MNKBoard& otherBoard);
+    // a moved-from board may only be destroyed or assigned to
+    MNKBoard(MNKBoard&& otherBoard) noexcept;
+    MNKBoard& operator=(MNKBoard&& otherBoard) noexcept;
+    virtual ~MNKBoard();
 
     // Checks for win condition (based on last move)
     bool checkWin(void);
@@ -94,17 +200,56 @@ public:
     virtual bool placePiece(int row, int col, CellState state, bool updateLast = true);
     void removePiece(int row, int col);
 
+    // recorded placements that can be taken back in reverse order with unmakeMove
+    bool makeMove(int row, int col, CellState state);
+    bool unmakeMove(void);
+
+    // number of recorded moves currently on the undo stack
+    int getMoveCount(void) const;
+
+    // reports the last placed piece
+    std::tuple<int, int> getLastMove(void) const;
+
+    // reports a recorded move (0 is the oldest one on the undo stack)
+    std::tuple<int, int> getMove(int moveInd) const;
+
+    // 64-bit Zobrist key of the position (games may mix in extra state such as the side to move)
+    std::uint64_t getHashKey(void) const;
+
+    // key shared by every symmetric image of the position (any extra state of the game
+    // mixed into the hash key included). transform receives the symmetry that maps the
+    // position onto its canonical image, the first one if several do.
+    std::uint64_t getCanonicalKey(Symmetry& transform) const;
+
+    // number of symmetries of the board (8 for square boards, 4 otherwise)
+    int getNumSymmetries(void) const;
+
+    // maps a cell through a symmetry of the board, and back
+    std::tuple<int, int> transformCell(Symmetry sym, int row, int col) const;
+    std::tuple<int, int> inverseTransformCell(Symmetry sym, int row, int col) const;
+    static Symmetry inverse(Symmetry sym);
+
+    // Zobrist keys shared by all boards: one key per player and cell, plus one for the side to move
+    static std::uint64_t zobristKey(CellState player, int row, int col);
+    static std::uint64_t zobristSideKey(void);
+
     // clears the board entirely
     void clearBoard(void);
 
     // reports the size of the board
     std::tuple<int, int> getBoardSize(void);
 
+    // reports the number of pieces in a row needed to win
+    int getWinSize(void) const;
+
     // returns whether current board position is empty
     bool isPosEmpty(int row, int col);
 
+    // returns the state of a single cell
+    CellState getCell(int row, int col) const;
+
     // prints the game board
     friend std::ostream& operator<<(std::ostream& ostream, const MNKBoard& board);
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,99 @@
+#ifndef MNKSOLVER_H
+#define MNKSOLVER_H
+
+// Required imports
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include "mnkGame.h"
+#include "dfpnSolver.h"
+
+/**
+ * MNKSolver
+ *
+ * Exhaustively solves small m,n,k games (at most 32 cells) and keeps the value of
+ * every position reachable from the start position. Positions are packed into a
+ * single word (black cells in the low half, white cells in the high half) and merged
+ * with their mirror images / rotations by keeping the smallest key of the symmetry class.
+ *
+ * The solve runs level by level on the number of pieces: the reachable positions are
+ * generated forwards from the start position, and the values are then filled in
+ * backwards from the fullest level. Every level is split over all threads by a
+ * work-stealing scheduler, and all positions live in one lock-free hash table.
+ *
+ * Black always moves first, so the side to move follows from the piece counts.
+ **/
+class MNKSolver{
+public:
+    // numThreads = 0 uses every hardware thread
+    MNKSolver(int m, int n, int k, int numThreads = 0);
+    MNKSolver(const MNKSolver& otherSolver) = delete;
+    MNKSolver& operator=(const MNKSolver& otherSolver) = delete;
+
+    // solves every position reachable from the empty board (or from the given position)
+    // and returns the value for the side to move of the start position
+    ProofValue solve(void);
+    ProofValue solve(MNKBoard& board);
+
+    // value of a solved position for the side to move (unknown if it was not reached)
+    ProofValue getValue(MNKBoard& board) const;
+    ProofValue getValue(std::uint64_t key) const;
+
+    // number of distinct positions (up to symmetry) that were solved
+    std::size_t getNumPositions(void) const;
+
+    // writes every solved position as (canonical key, value) records
+    bool saveTable(const std::string& filePath) const;
+
+    // packs a board into a position key and maps it onto its symmetry class
+    std::uint64_t positionKey(MNKBoard& board) const;
+    std::uint64_t canonicalKey(std::uint64_t key) const;
+
+private:
+    inline static const int MAX_CELLS = 32;
+    inline static const std::uint64_t EMPTY_KEY = ~std::uint64_t(0);  // black and white on every cell
+    inline static const std::size_t MIN_TABLE_SIZE = 1 << 12;
+
+    int numRows;
+    int numCols;
+    int winSize;
+    int numCells;
+    int numThreads;
+
+    // cellMaps[sym][cell] is the image of a cell under one board symmetry
+    std::vector<std::vector<int>> cellMaps;
+    // every k-cell segment of the board
+    std::vector<std::uint32_t> winMasks;
+
+    // open addressing table of positions; keys are claimed with a compare and swap
+    std::unique_ptr<std::atomic<std::uint64_t>[]> tableKeys;
+    std::unique_ptr<std::atomic<std::uint8_t>[]> tableValues;
+    std::size_t tableSize = 0;
+    std::atomic<std::size_t> numPositions;
+    std::atomic<bool> tableFull;
+
+    // positions of every level, by number of pieces
+    std::vector<std::vector<std::uint64_t>> levels;
+
+    void resetTable(std::size_t newSize);
+    void growTable(void);
+    // inserts the key with its value; returns false if the table has to grow first
+    bool insert(std::uint64_t key, ProofValue value);
+    std::size_t findSlot(std::uint64_t key) const;
+
+    // value of a position that is decided without moves (unknown otherwise)
+    ProofValue terminalValue(std::uint64_t key) const;
+    std::uint64_t transformKey(std::uint64_t key, int sym) const;
+
+    void expandLevel(int levelInd);
+    void collectLevel(int levelInd);
+    void evaluateLevel(int levelInd);
+
+    // runs work(begin, end) over [0, numItems) on every thread, stealing ranges between threads
+    void runParallel(std::size_t numItems, const std::function<void(std::size_t, std::size_t)>& work);
+};
+
+#endif
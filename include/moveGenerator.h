@@ -0,0 +1,78 @@
+#ifndef MOVEGENERATOR_H
+#define MOVEGENERATOR_H
+
+// Required imports
+#include "gomoku.h"
+
+/**
+ * MoveGenerator
+ *
+ * Generates the legal moves of the side to move among the empty cells within
+ * ThreatCache::NEAR_DIST of a piece, read from the neighbourhood the game keeps up to
+ * date on every move. Forbidden cells are left out. Moves come out in batches of
+ * decreasing urgency, each ordered by the threat scores of both players:
+ *  - cells completing five; if there are any nothing else is generated,
+ *  - cells blocking a five of the opponent; if there are any they are the only moves
+ *    that do not lose at once and nothing else is generated,
+ *  - cells forming a four or a three for either player,
+ *  - every other candidate.
+ *
+ * Batches are written into a buffer of the caller, so generating moves never allocates.
+ * The generator reads the game as it is when a batch is asked for, so the game must not
+ * change while its batches are being read.
+ **/
+class MoveGenerator{
+public:
+    enum class Stage: char{
+        wins,
+        blocks,
+        threats,
+        quiet,
+        done
+    };
+
+    // callers that order the moves by their own scores (as the Searcher does) can leave
+    // the batches in board order
+    explicit MoveGenerator(Omok& game, bool sortBatches = true);
+
+    // writes the next non-empty batch as row*cols+col (strongest first) and returns its
+    // size, or 0 once every batch was written (moves needs room for every board cell)
+    int nextBatch(int* moves);
+    // writes all remaining batches one after the other and returns the number of moves
+    int generateAll(int* moves);
+    // writes only the batch of cells completing five (if any) without going on to the
+    // other stages and returns its size
+    int generateWins(int* moves);
+
+    // every empty cell near a piece (or the center of an empty board) as row*cols+col in
+    // board order, forbidden cells included, for callers that check moves as they play them
+    static int candidateCells(Omok& game, int* moves);
+
+    // stage of the batch written last
+    Stage getStage(void) const;
+
+private:
+    typedef MNKBoard::PieceDirection PieceDirection;
+    typedef MNKBoard::LineBits LineBits;
+
+    Omok& game;
+    CellState player;
+    CellState opponent;
+    int numRows;
+    int numCols;
+    bool sortBatches;
+    Stage nextStage = Stage::wins;
+    Stage lastStage = Stage::done;
+
+    // legal candidates of one stage in board order
+    int collect(Stage stage, int* moves);
+    // every stage at once for a generator that has not written a batch yet
+    int generateFresh(int* moves);
+    bool inStage(Stage stage, int row, int col) const;
+    // whether either player forms a four or a three (or five) on the cell
+    bool isThreat(int row, int col) const;
+    int moveScore(int move) const;
+    void sortMoves(int* moves, int numMoves) const;
+};
+
+#endif
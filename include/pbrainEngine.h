@@ -0,0 +1,113 @@
+#ifndef PBRAINENGINE_H
+#define PBRAINENGINE_H
+
+// Required imports
+#include <atomic>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+#include "gomoku.h"
+#include "searcher.h"
+
+/**
+ * Time limits as given by the manager (INFO timeout_turn, timeout_match and time_left),
+ * all in milliseconds.
+ **/
+struct TimeControl {
+    int turnMs = 5000;              // 0 asks for moves as fast as possible
+    int matchMs = 0;                // 0 means no limit for the match
+    int timeLeftMs = -1;            // unknown until the manager tells
+
+    /**
+     * Time to search the next move: the turn limit, or the share of the match time left
+     * if that is smaller, less a safety margin that covers the time checks of the search
+     * and the round trip to the manager.
+     **/
+    int getMoveBudgetMs(int moveCount) const;
+
+    inline static const int MIN_MOVE_MS = 5;
+    inline static const int SAFETY_MS = 50;
+    inline static const int EXPECTED_GAME_MOVES = 120;  // moves of both players in a typical game
+    inline static const int MIN_MOVES_TO_GO = 10;
+};
+
+/**
+ * PbrainEngine
+ *
+ * Plays through the Gomocup (Piskvork) protocol: commands come in one per line and moves
+ * are exchanged as "x,y", x being the column and y the row (both 0-based). Supported are
+ * START, RESTART, BEGIN, TURN, BOARD (up to DONE), TAKEBACK, INFO, ABOUT and END.
+ *
+ * Moves are searched by a single Searcher under the budget of the TimeControl. Its
+ * transposition table is kept from one move to the next, and while the opponent thinks
+ * the engine ponders: the position is searched on a background thread with the opponent
+ * to move, which fills the table with the likely replies, and the search is stopped as
+ * soon as the next command arrives.
+ *
+ * INFO rule selects the Renju rules when its Renju bit (4) is set, and otherwise the
+ * standard rules (exactly five wins) when its bit 1 is set and the freestyle rules (five
+ * or more wins) when it is not; neither of the latter forbids any move. Without INFO rule
+ * the game is freestyle, as the protocol's default. INFO max_memory caps the table at half
+ * the given memory. Both take effect on an empty board, or else with the next START or
+ * RESTART.
+ **/
+class PbrainEngine{
+public:
+    inline static const std::size_t DEFAULT_TT_MB = 64;
+
+    explicit PbrainEngine(bool ponder = true);
+    PbrainEngine(const PbrainEngine& otherEngine) = delete;
+    PbrainEngine& operator=(const PbrainEngine& otherEngine) = delete;
+    ~PbrainEngine();
+
+    // handles commands until END or the end of the input
+    void run(std::istream& input, std::ostream& output);
+
+    // handles a single line of input, writing the reply (if any); false once END was read
+    bool handleLine(const std::string& line, std::ostream& output);
+
+    const Omok& getGame(void) const;
+    const TimeControl& getTimeControl(void) const;
+    bool isPondering(void) const;
+    std::size_t getTableSizeMB(void) const;
+
+private:
+    inline static const int BOARD_SIZE = 15;
+
+    Omok::RuleSet ruleSet = Omok::RuleSet::freestyle;
+    Omok game;
+    std::unique_ptr<Searcher> searcher;
+    std::size_t maxMemory = 0;
+    std::size_t tableSizeMB = 0;    // size of the searcher's table, 0 before START
+    TimeControl timeControl;
+
+    // stones of a BOARD command until DONE: own (field 1) and opponent (field 2) ones
+    bool readingBoard = false;
+    std::vector<std::tuple<int, int>> boardStones[2];
+
+    bool ponderEnabled;
+    Omok ponderGame;
+    std::thread ponderThread;
+    std::atomic<bool> ponderStop;
+
+    // builds a fresh game for START and RESTART, with a new table if its size changed
+    void newGame(void);
+    // builds the searcher again if INFO max_memory asks for another table size
+    void resizeTable(void);
+    // searches and plays the engine's move, then ponders on the opponent's time
+    void playMove(std::ostream& output);
+    // sets up the position of a BOARD command; false if the stones cannot come from a game
+    bool setBoard(void);
+    void handleInfo(const std::string& key, const std::string& value);
+
+    void startPondering(void);
+    void stopPondering(void);
+
+    // reads "x,y" into a board cell
+    static bool readCell(const std::string& text, int& row, int& col);
+};
+
+#endif
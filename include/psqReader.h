@@ -0,0 +1,97 @@
+#ifndef PSQREADER_H
+#define PSQREADER_H
+
+// Required imports
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "gomoku.h"
+#include "mappedFile.h"
+
+/**
+ * Piskvork game records (.psq)
+ *
+ * A record is a header line ("Piskvorky 15x15, 11:11, 0") followed by one "x,y,time"
+ * line per move (1-based coordinates, time in milliseconds) and a trailer naming the
+ * engines and the result. The trailer may hold lines such as "2,Renju", so a move line
+ * must be exactly three numbers, and the moves end at the first line that is not one.
+ *
+ * Files are memory-mapped and scanned in place: moves are read one by one straight
+ * from the mapped bytes, so reading a game allocates nothing per move.
+ **/
+
+struct PsqMove {
+    int x = 0;
+    int y = 0;
+    int time = 0;
+};
+
+// hand-written scanner over the bytes of one record
+class PsqScanner{
+public:
+    PsqScanner(const char* begin, const char* end);
+
+    // reads the header line; false if it is not a Piskvorky header
+    bool readHeader(int& width, int& height);
+
+    // reads the next move line; false once the moves have ended
+    bool nextMove(PsqMove& move);
+
+private:
+    const char* curPos;
+    const char* endPos;
+    bool movesEnded = false;
+
+    bool readNumber(int& number);
+    void skipLine(void);
+};
+
+// outcome of replaying one record
+struct PsqReport {
+    std::string filePath;
+    bool readError = false;     // file missing, bad header or not a 15x15 board
+    int numMoves = 0;           // moves played before the replay stopped
+    int illegalMove = -1;       // index of the first move the rules rejected
+    int expectedWinner = -1;    // winner given by the file name (-1 when it has none)
+    int winner = 0;             // Omok::getGameWinner after the replay
+
+    bool isRuleViolation(void) const { return illegalMove >= 0; }
+    bool isWinnerMismatch(void) const { return expectedWinner >= 0 && winner != expectedWinner; }
+    bool isValid(void) const { return !readError && !isRuleViolation() && !isWinnerMismatch(); }
+};
+
+/**
+ * PsqReplayer
+ *
+ * Replays a corpus of records through Omok across a pool of threads. Every thread owns a
+ * board and takes the next record from a shared counter, so long and short games spread
+ * evenly. A replay stops at the first move the rules reject.
+ *
+ * The expected winner is read from the file name "<a>_<b>_<c>_<winner>.psq" (0 for a draw,
+ * 1 for black, 2 for white), as in the corpus under test/SimulatedGames.
+ **/
+class PsqReplayer{
+public:
+    // numThreads = 0 uses every hardware thread
+    explicit PsqReplayer(Omok::RuleSet ruleSet = Omok::RuleSet::omok, int numThreads = 0);
+
+    // reports in the order of the paths
+    std::vector<PsqReport> replay(const std::vector<std::string>& filePaths) const;
+
+    // replays one record on the given board (cleared first)
+    static PsqReport replayFile(Omok& board, const std::string& filePath);
+
+    // every .psq file of a directory, sorted by path
+    static std::vector<std::string> listCorpus(const std::string& dirPath);
+
+    static int expectedWinner(const std::string& filePath);
+
+private:
+    inline static const int BOARD_SIZE = 15;
+    inline static const int CLAIM_SIZE = 16;    // records a thread takes at a time
+
+    Omok::RuleSet ruleSet;
+    int numThreads;
+};
+
+#endif
@@ -0,0 +1,93 @@
+#ifndef RENJURULES_H
+#define RENJURULES_H
+
+// Required imports
+#include "linePatterns.h"
+#include "mnkGame.h"
+
+/**
+ * RenjuRules
+ *
+ * The Renju restrictions for black on an empty cell, shared by the boards that play
+ * them (Omok and BatchOmok). A five always stands, an overline or two fours (possibly on
+ * the same line, as in x.xxx.x) are forbidden, and two threes are only forbidden if both
+ * are real threes once the piece is placed: a three is real if one of its straight four
+ * points is not forbidden itself.
+ *
+ * The board is read through an accessor providing
+ *  - int patternIndex(int row, int col, PieceDirection dir, int depth): the pattern
+ *    window of black through the empty cell along one direction, depth being the
+ *    nesting of the three check (0 for the cell asked about),
+ *  - void placeBlack(int row, int col) and void removeBlack(int row, int col), which put
+ *    a black piece on the cell for the three check and take it off again.
+ **/
+class RenjuRules{
+public:
+    typedef MNKBoard::PieceDirection PieceDirection;
+    typedef MNKBoard::LineBits LineBits;
+
+    // deepest nesting of the three check (deeper threes are taken as real)
+    inline static const int MAX_DEPTH = 8;
+
+    template<typename Board>
+    static bool isForbidden(Board& board, int row, int col, int depth = 0);
+
+private:
+    template<typename Board>
+    static bool isRealThree(Board& board, int row, int col, PieceDirection dir, int patternInd, int depth);
+};
+
+/**
+ * Counts the fours and threes black would form on the cell; the threes are only looked
+ * into if there are two of them and nothing else decides.
+ **/
+template<typename Board>
+bool RenjuRules::isForbidden(Board& board, int row, int col, int depth) {
+    bool isOverline = false;
+    int numFours = 0, numThrees = 0;
+    PieceDirection threeDirs[MNKBoard::NUM_DIRS];
+    int threePatterns[MNKBoard::NUM_DIRS];
+    for(int dirInd=0; dirInd<MNKBoard::NUM_DIRS; dirInd++) {
+        const PieceDirection dir = static_cast<PieceDirection>(dirInd);
+        const int patternInd = board.patternIndex(row, col, dir, depth);
+        const LinePatterns::Pattern pattern = LinePatterns::getPattern(patternInd);
+        const int bit = MNKBoard::bitIndex(dir, row, col);
+        if(pattern == LinePatterns::Pattern::five)
+            return false;
+        else if(pattern == LinePatterns::Pattern::overline)
+            isOverline = true;
+        else if(pattern == LinePatterns::Pattern::openFour)
+            numFours++;
+        else if(pattern == LinePatterns::Pattern::four)
+            numFours += __builtin_popcountll(LinePatterns::fivePoints(patternInd, bit));
+        else if(LinePatterns::straightFourPoints(patternInd, bit)) {
+            threeDirs[numThrees] = dir;
+            threePatterns[numThrees++] = patternInd;
+        }
+    }
+    if(isOverline || numFours >= 2)
+        return true;
+    if(numThrees < 2)
+        return false;
+
+    // the threes are checked with the piece on the board
+    board.placeBlack(row, col);
+    int numRealThrees = 0;
+    for(int threeInd=0; threeInd<numThrees && numRealThrees<2; threeInd++)
+        if(isRealThree(board, row, col, threeDirs[threeInd], threePatterns[threeInd], depth))
+            numRealThrees++;
+    board.removeBlack(row, col);
+    return numRealThrees >= 2;
+}
+
+template<typename Board>
+bool RenjuRules::isRealThree(Board& board, int row, int col, PieceDirection dir, int patternInd, int depth) {
+    for(LineBits fourBits=LinePatterns::straightFourPoints(patternInd, MNKBoard::bitIndex(dir, row, col)); fourBits; fourBits &= fourBits - 1) {
+        const auto [fourRow, fourCol] = MNKBoard::lineCell(dir, row, col, __builtin_ctzll(fourBits));
+        if(depth >= MAX_DEPTH || !isForbidden(board, fourRow, fourCol, depth+1))
+            return true;
+    }
+    return false;
+}
+
+#endif
@@ -0,0 +1,114 @@
+#ifndef SEARCHER_H
+#define SEARCHER_H
+
+// Required imports
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <tuple>
+#include <vector>
+#include "gomoku.h"
+#include "transTable.h"
+
+/**
+ * Searcher
+ *
+ * Implements an alpha-beta (negamax) search over Omok positions. The search is
+ * run through iterative deepening with aspiration windows around the score of the
+ * previous iteration, and uses principal variation search (null windows for every
+ * move but the first). Moves come from a MoveGenerator, which narrows forcing positions
+ * down to the fives or the blocks, and are ordered by the transposition table move, two
+ * killer moves per ply, the history heuristic and a static threat score.
+ *
+ * The searched game is modified through makeMove / unmakeMove and is left exactly
+ * as it was passed in once the search returns.
+ **/
+
+// Budget of a single search (0 means unlimited)
+struct SearchLimits {
+    int maxDepth = 64;
+    std::uint64_t maxNodes = 0;
+    int maxTimeMs = 0;
+    // the search returns as soon as possible once this flag is set (from any thread); the
+    // caller sets it up before the search starts and resets it, so no stop is ever lost
+    const std::atomic<bool>* stopFlag = nullptr;
+};
+
+// Outcome of a search
+struct SearchResult {
+    std::tuple<int, int> bestMove = std::make_tuple(-1, -1);
+    int score = 0;                              // from the point of view of the side to move
+    int depth = 0;                              // last fully completed depth
+    std::vector<std::tuple<int, int>> pv;       // principal variation starting with bestMove
+    std::uint64_t nodes = 0;
+    double elapsedMs = 0;
+    std::uint64_t nodesPerSecond = 0;
+};
+
+class Searcher{
+public:
+    inline static const int WIN_SCORE = 30000;
+    inline static const int MAX_PLY = 64;
+
+    // search with a private transposition table of the given size
+    explicit Searcher(std::size_t ttSizeMB = 16);
+    // search with a table shared with other searchers (its owner calls newSearch)
+    explicit Searcher(TransTable& sharedTable);
+    Searcher(const Searcher& otherSearcher) = delete;
+    Searcher& operator=(const Searcher& otherSearcher) = delete;
+
+    // searches the position for the side to move
+    SearchResult search(Omok& game, const SearchLimits& limits);
+
+    // per-iteration progress (depth, score, nodes, nps, pv) is written here if set
+    void setInfoStream(std::ostream* stream);
+
+    // true for scores that announce a forced win or loss
+    static bool isWinScore(int score);
+
+    // static evaluation of a position from the point of view of the side to move
+    static int evaluate(Omok& game);
+
+private:
+    inline static const int INF_SCORE = WIN_SCORE + 1;
+    inline static const int ASPIRATION_DELTA = 40;
+
+    std::unique_ptr<TransTable> ownTable;
+    TransTable* table;
+    std::ostream* infoStream = nullptr;
+
+    // state of the current search
+    int numRows = 0;
+    int numCols = 0;
+    SearchLimits curLimits;
+    std::chrono::steady_clock::time_point startTime;
+    std::uint64_t nodes = 0;
+    bool aborted = false;
+
+    // move ordering data
+    int killers[MAX_PLY][2];
+    std::vector<int> history[2];
+
+    // triangular principal variation table
+    int pvTable[MAX_PLY][MAX_PLY];
+    int pvLength[MAX_PLY];
+
+    // per-ply move buffers (avoids allocations inside the tree)
+    std::vector<int> moveBuffers[MAX_PLY];
+    std::vector<int> scoreBuffers[MAX_PLY];
+
+    int negamax(Omok& game, int depth, int alpha, int beta, int ply, bool pvNode);
+
+    // scores moves (as written by a MoveGenerator) for ordering (higher first)
+    void scoreMoves(Omok& game, const int* moves, int* scores, int numMoves, int ttMove, int ply);
+
+    bool checkAbort(void);
+    double elapsedMs(void) const;
+    int scoreToTT(int score, int ply) const;
+    int scoreFromTT(int score, int ply) const;
+    std::tuple<int, int> cellToMove(int cell) const;
+};
+
+#endif
@@ -0,0 +1,106 @@
+#ifndef THREATCACHE_H
+#define THREATCACHE_H
+
+// Required imports
+#include "boardArena.h"
+#include "mnkGame.h"
+#include "linePatterns.h"
+
+/**
+ * ThreatCache
+ *
+ * Keeps the line patterns of every cell of a five-in-a-row board up to date for both
+ * players. For every cell and direction it holds the pattern window index the player
+ * would have by playing the cell (see LinePatterns), the threat score that follows
+ * from it, and the sum of these scores over the four directions. Every line also
+ * keeps its evaluation score (the 5-cell windows each player can still complete).
+ *
+ * A piece only changes the windows of the cells up to five steps away along its four
+ * lines (the 9-cell window plus the cells just outside it that tell fives from
+ * overlines), so update() reads those cells and the four lines again and nothing else.
+ *
+ * The cache also counts the pieces within NEAR_DIST cells of every cell and keeps, for
+ * every row, the cells with at least one piece nearby, which are the candidate moves.
+ *
+ * All arrays share one block (from the arena of the board, if it has one), so copying a
+ * cache is a single memcpy.
+ **/
+class ThreatCache{
+public:
+    typedef MNKBoard::PieceDirection PieceDirection;
+    typedef MNKBoard::LineBits LineBits;
+
+    // threat score of a direction in which the move completes exactly five
+    inline static const int FIVE_SCORE = 1 << 20;
+    // lowest threat score of a direction in which the move forms a pattern (a broken three)
+    inline static const int THREE_SCORE = 60;
+    // distance (in rows and columns) up to which cells count as near a piece
+    inline static const int NEAR_DIST = 2;
+
+    ThreatCache(int numRows, int numCols, BoardArena* arena = nullptr);
+    ThreatCache(const ThreatCache& otherCache, BoardArena* arena = nullptr);
+    ThreatCache& operator=(const ThreatCache& otherCache);
+    ThreatCache(ThreatCache&& otherCache) = default;
+    ThreatCache& operator=(ThreatCache&& otherCache) = default;
+
+    // reads the whole board again
+    void reset(const MNKBoard& board);
+    // refreshes everything a piece placed on or removed from (row, col) may have changed
+    void update(const MNKBoard& board, int row, int col);
+
+    // pattern window index of the player through (row, col) along one direction
+    int getPatternIndex(CellState player, PieceDirection dir, int row, int col) const {
+        return patternInds[MNKBoard::playerIndex(player)][(int)dir][row*numCols + col];
+    }
+
+    // threat score of the player playing (row, col), summed over the four directions
+    int getCellScore(CellState player, int row, int col) const {
+        return cellScores[MNKBoard::playerIndex(player)][row*numCols + col];
+    }
+    // the same for a cell given as row*cols+col
+    int getCellScore(CellState player, int cell) const {
+        return cellScores[MNKBoard::playerIndex(player)][cell];
+    }
+
+    // sum of the line scores of the player over the whole board
+    int getLineScore(CellState player) const {
+        return totalLineScores[MNKBoard::playerIndex(player)];
+    }
+
+    // cells of the row (as column bits) within NEAR_DIST of a piece, occupied or not
+    LineBits getNearCells(int row) const {
+        return nearRows[row];
+    }
+
+private:
+    int numRows;
+    int numCols;
+
+    // block holding every array below
+    ArenaBlock storage;
+
+    // [player][direction][cell]
+    int* patternInds[2][MNKBoard::NUM_DIRS];
+    int* dirScores[2][MNKBoard::NUM_DIRS];
+    // [player][cell]
+    int* cellScores[2];
+    // [player][direction][line]
+    int* lineScores[2][MNKBoard::NUM_DIRS];
+    int totalLineScores[2] = {0, 0};
+    // [cell] number of pieces within NEAR_DIST, and [row] the cells where it is not 0
+    unsigned char* nearCounts;
+    LineBits* nearRows;
+
+    static std::size_t storageSize(int numRows, int numCols);
+    // points the arrays into the block
+    void bindArrays(void);
+
+    void refreshCell(int playerInd, int dirInd, int cellInd, LineBits ownBits, LineBits emptyBits, int bit);
+    void refreshLine(const MNKBoard& board, int playerInd, PieceDirection dir, int lineInd);
+    void addNear(int row, int col, int delta);
+
+    // score of every 5-cell window of a line that is free of opponent pieces
+    static int lineScore(LineBits ownBits, LineBits freeBits);
+};
+
+#endif
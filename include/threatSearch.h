@@ -0,0 +1,81 @@
+#ifndef THREATSEARCH_H
+#define THREATSEARCH_H
+
+// Required imports
+#include <cstdint>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+#include "gomoku.h"
+
+/**
+ * ThreatSolver
+ *
+ * Implements a threat-space search that looks for forced wins of the side to move.
+ * Only threatening moves are expanded for the attacker and only forced defenses
+ * are expanded for the defender:
+ *  - VCF (victory by continuous fours): every attacker move creates a four and the
+ *    defender has to fill the cell that would complete five.
+ *  - VCT (victory by continuous threats): attacker moves may also create open threes
+ *    (matched through the Omok open three conditions). The defender then answers by
+ *    filling an empty cell of the three or by making a four of its own.
+ *
+ * Positions that failed to produce a win are remembered (by Zobrist key) for the
+ * rest of a solve call. The game is left unchanged once a solve call returns.
+ **/
+
+// Outcome of a threat-space search
+struct ThreatSearchResult {
+    bool win = false;                               // a forced win for the side to move was proven
+    bool limitReached = false;                      // the node limit ran out before a win was found
+    std::vector<std::tuple<int, int>> sequence;     // winning line (attacker and defender moves alternate)
+    std::uint64_t nodes = 0;
+};
+
+class ThreatSolver{
+public:
+    explicit ThreatSolver(std::uint64_t nodeLimit = 1000000);
+
+    // searches for a win through continuous fours (maxDepth counts attacker moves)
+    ThreatSearchResult solveVCF(Omok& game, int maxDepth = 20);
+    // searches for a win through continuous fours and threes
+    ThreatSearchResult solveVCT(Omok& game, int maxDepth = 8);
+
+    // cells where the player would complete exactly five (cells needs room for every board cell)
+    static int findFivePoints(Omok& game, CellState player, int* cells);
+    // cells completing exactly five for the player once it has played (row, col) (at most two per direction)
+    static int fivePointsAfter(Omok& game, CellState player, int row, int col, int* cells);
+
+private:
+    inline static const int VCF_DEPTH_IN_VCT = 12;
+
+    std::uint64_t nodeLimit;
+    std::uint64_t nodes = 0;
+    bool limitReached = false;
+    int numCols = 0;
+    int numCells = 0;
+    std::unordered_map<std::uint64_t, int> failedVCF;
+    std::unordered_map<std::uint64_t, int> failedVCT;
+
+    // per-ply buffers (avoids allocations inside the tree), the winning line of a ply is left in line
+    struct PlyBuffers {
+        std::vector<int> defenderFives, candidates, fiveCells, nearCells;
+        std::vector<int> defenses, firstLine, line;
+    };
+    std::vector<PlyBuffers> plyBuffers;
+
+    bool vcf(Omok& game, int depth, int ply);
+    bool vct(Omok& game, int depth, int ply);
+
+    // empty cells of the row within dist cells of the player's pieces
+    static MNKBoard::LineBits nearRowBits(Omok& game, CellState player, int dist, int row);
+    // empty cells within dist cells of the player's pieces (cells needs room for every board cell)
+    static int collectNear(Omok& game, CellState player, int dist, int* cells);
+    // plays the move completing five for the side to move if there is one
+    bool playFive(Omok& game, int ply);
+    bool checkLimit(void);
+    void resetSearch(Omok& game, int numPlies);
+    ThreatSearchResult makeResult(bool win) const;
+};
+
+#endif
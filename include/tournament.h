@@ -0,0 +1,195 @@
+#ifndef TOURNAMENT_H
+#define TOURNAMENT_H
+
+// Required imports
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <vector>
+#include "gomoku.h"
+#include "mcts.h"
+#include "searcher.h"
+
+/**
+ * Self-play tournaments
+ *
+ * Plays two engine configurations against each other over many games at once. Every
+ * thread of the pool owns its own pair of engines and takes the next game from a shared
+ * counter, so that tens of thousands of games can be run on one machine.
+ *
+ * Games come in pairs: both games of a pair start from the same opening, taken from a
+ * book file or played at random around the centre, with the colours swapped. Each move
+ * is searched under the limits of the engine (depth, nodes or playouts, time); an
+ * engine that plays an illegal move, or runs over its move time by more than the
+ * margin, loses the game. Finished games can be written as Piskvork records (.psq).
+ *
+ * The results of the first engine are reported as wins, draws and losses, an Elo
+ * difference with its 95% interval, and a sequential probability ratio test that stops
+ * the match as soon as one of its hypotheses is accepted.
+ **/
+
+// An engine under test, given as "<ab|mcts>[:key=value,...]" (see parse)
+struct EngineConfig {
+    enum class Type: char{
+        alphaBeta,
+        mcts
+    };
+
+    // depth searched by alpha-beta when the specification sets no limit
+    inline static const int DEFAULT_DEPTH = 4;
+
+    std::string name;
+    Type type = Type::alphaBeta;
+    SearchLimits searchLimits;
+    std::size_t ttSizeMB = 16;
+    MctsConfig mctsConfig;
+    MctsLimits mctsLimits;
+
+    /**
+     * Reads a specification such as "ab:depth=6,nodes=20000" or "mcts:playouts=2000,puct=1".
+     * Alpha-beta takes depth, nodes, ms and tt (MB); MCTS takes playouts, ms, threads, c,
+     * puct and seed; both take name (the specification itself by default). MCTS given a
+     * time but no playouts searches by time only. Returns false on an unknown engine, key
+     * or value.
+     **/
+    static bool parse(const std::string& spec, EngineConfig& config);
+
+    // time limit of a move in milliseconds (0 when the engine has none)
+    int getMoveTimeMs(void) const;
+};
+
+// An engine as played in a match
+class MatchEngine{
+public:
+    explicit MatchEngine(const EngineConfig& config);
+
+    // forgets whatever was learnt from the previous game
+    void newGame(void);
+
+    // best move for the side to move under the limits of the engine
+    std::tuple<int, int> chooseMove(Omok& game);
+
+    const EngineConfig& getConfig(void) const;
+
+private:
+    EngineConfig config;
+    std::unique_ptr<Searcher> searcher;
+    std::unique_ptr<MctsSearcher> mctsSearcher;
+};
+
+// One played game
+struct MatchGame {
+    enum class Termination: char{
+        five,           // a player completed five
+        draw,           // the board or the move limit ran out
+        illegalMove,    // the engine to move played an illegal move
+        timeForfeit     // the engine to move ran out of time
+    };
+
+    std::vector<std::tuple<int, int>> moves;    // opening included
+    std::vector<int> times;                     // milliseconds per move (0 for the opening)
+    int openingLength = 0;
+    int winner = 0;                             // as Omok::getGameWinner (0 for a draw)
+    bool firstIsBlack = true;                   // whether the first engine played black
+    Termination termination = Termination::draw;
+};
+
+// Results of the first engine
+struct MatchStats {
+    long wins = 0;
+    long draws = 0;
+    long losses = 0;
+
+    void addGame(const MatchGame& game);
+
+    long getGames(void) const;
+    // points per game, a draw counting half
+    double getScore(void) const;
+    // Elo difference implied by the score and the half width of its 95% interval
+    // (infinite as long as the interval reaches a score of 0 or 1)
+    double getEloDiff(void) const;
+    double getEloError(void) const;
+    // log-likelihood ratio of elo1 against elo0 (normal approximation of the score)
+    double getLLR(double elo0, double elo1) const;
+};
+
+// Sequential probability ratio test of H0: elo = elo0 against H1: elo = elo1
+struct SprtConfig {
+    enum class Result: char{
+        running,
+        acceptH0,
+        acceptH1
+    };
+
+    bool isEnabled = false;
+    double elo0 = 0;
+    double elo1 = 5;
+    double alpha = 0.05;
+    double beta = 0.05;
+
+    double getLowerBound(void) const;
+    double getUpperBound(void) const;
+    Result check(const MatchStats& stats) const;
+};
+
+// Settings of a match
+struct TournamentConfig {
+    Omok::RuleSet ruleSet = Omok::RuleSet::omok;
+    int numThreads = 0;             // 0 uses every hardware thread
+    long numGames = 1000;           // upper bound, rounded up to whole pairs
+    std::string bookPath;           // openings, see readBook (random openings if empty)
+    int randomPlies = 4;            // length of the random openings
+    std::uint64_t seed = 0;
+    std::string psqDir;             // records are written here if set
+    int maxMoves = 225;             // the game is drawn once this many moves were played
+    int timeMarginMs = 100;         // overrun of the move time tolerated before a forfeit
+    int reportInterval = 100;       // progress is written every this many games
+    SprtConfig sprt;
+};
+
+class Tournament{
+public:
+    Tournament(const EngineConfig& first, const EngineConfig& second, const TournamentConfig& config);
+
+    // plays the match, writing progress to the stream if one is given; false if the book
+    // could not be read
+    bool run(std::ostream* progress = nullptr);
+
+    const MatchStats& getStats(void) const;
+    SprtConfig::Result getSprtResult(void) const;
+    // a line such as "+12 =3 -9  score 0.562  elo +43.7 +/- 98.1  LLR 0.21 [-2.94, 2.94]"
+    std::string summary(void) const;
+
+    /**
+     * Reads an opening book: one opening per line, as moves "x,y" separated by blanks in
+     * Piskvork coordinates (1-based, x being the row as in the .psq records). Blank lines
+     * and lines starting with '#' are skipped, and so are openings that are illegal under
+     * the rule set or already finish the game.
+     **/
+    static bool readBook(const std::string& bookPath, Omok::RuleSet ruleSet, std::vector<std::vector<std::tuple<int, int>>>& openings);
+
+    // plays one game from the opening (which must be legal)
+    static MatchGame playGame(MatchEngine& black, MatchEngine& white, const std::vector<std::tuple<int, int>>& opening,
+                              const TournamentConfig& config, Omok& game);
+
+    // writes a game as a Piskvork record, the engines named in the trailer
+    static bool writePsq(const std::string& filePath, const MatchGame& game, const std::string& blackName, const std::string& whiteName);
+
+private:
+    inline static const int BOARD_SIZE = 15;
+    inline static const int OPENING_AREA = 7;      // random openings are played in the centre square of this size
+
+    EngineConfig first;
+    EngineConfig second;
+    TournamentConfig config;
+    std::vector<std::vector<std::tuple<int, int>>> openings;
+    MatchStats stats;
+    SprtConfig::Result sprtResult = SprtConfig::Result::running;
+
+    // opening of a pair of games
+    std::vector<std::tuple<int, int>> pairOpening(long pairInd) const;
+};
+
+#endif
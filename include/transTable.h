@@ -0,0 +1,94 @@
+#ifndef TRANSTABLE_H
+#define TRANSTABLE_H
+
+// Required imports
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+
+/**
+ * TransTable
+ *
+ * Implements a shared transposition table keyed by the Zobrist key of a board.
+ * The table is an array of cache-line sized buckets holding a few entries each.
+ *
+ * Entries are packed into a single 64-bit data word that is stored next to
+ * (key ^ data). Readers only accept an entry if both words XOR back to the probed
+ * key, so threads may read and write the table concurrently without any locks:
+ * a torn write simply looks like a miss.
+ **/
+
+// Describes how a stored score relates to the true value of the position
+enum class BoundType: char{
+    none,   // only used for empty entries
+    exact,
+    lower,  // score is a lower bound (failed high)
+    upper   // score is an upper bound (failed low)
+};
+
+// Unpacked contents of an entry
+struct TTEntry {
+    int score;
+    int depth;
+    BoundType bound;
+    int move;   // -1 if no move was stored
+};
+
+class TransTable{
+public:
+    inline static const int ENTRIES_PER_BUCKET = 4;
+    inline static const int MAX_DEPTH = 255;
+    inline static const int MIN_SCORE = -32768;
+    inline static const int MAX_SCORE = 32767;
+
+    // allocates a table of (at most) sizeMB megabytes
+    explicit TransTable(std::size_t sizeMB);
+    TransTable(const TransTable& otherTable) = delete;
+    TransTable& operator=(const TransTable& otherTable) = delete;
+
+    // looks up a position. Returns true and fills entry if it was found.
+    bool probe(std::uint64_t key, TTEntry& entry) const;
+
+    // stores a search result, replacing the least valuable entry of the bucket
+    void store(std::uint64_t key, int score, int depth, BoundType bound, int move);
+
+    // hints the CPU to start loading the bucket of a key
+    void prefetch(std::uint64_t key) const;
+
+    // marks the start of a new search so that older entries get replaced first. A table
+    // shared by several searchers is advanced once per search by its owner.
+    void newSearch(void);
+
+    // age of the current search (counts the calls of newSearch, modulo 64)
+    int getAge(void) const;
+
+    // empties the table
+    void clear(void);
+
+    // permille of the sampled entries that were written during the current search
+    int hashfull(void) const;
+
+    // reports the table size
+    std::size_t getNumBuckets(void) const;
+    std::size_t getSizeBytes(void) const;
+
+private:
+    // one 64-byte bucket holds ENTRIES_PER_BUCKET pairs of (key ^ data, data)
+    struct alignas(64) Bucket {
+        std::atomic<std::uint64_t> words[2*ENTRIES_PER_BUCKET];
+    };
+
+    std::unique_ptr<Bucket[]> buckets;
+    std::size_t numBuckets;
+    std::atomic<std::uint8_t> curAge;
+
+    Bucket& getBucket(std::uint64_t key) const;
+
+    // packs / unpacks the data word of an entry
+    static std::uint64_t packEntry(int score, int depth, BoundType bound, int move, std::uint8_t age);
+    static TTEntry unpackEntry(std::uint64_t data);
+    static std::uint8_t entryAge(std::uint64_t data);
+};
+
+#endif
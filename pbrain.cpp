@@ -0,0 +1,13 @@
+#include <cstring>
+#include <iostream>
+#include "include/pbrainEngine.h"
+
+using namespace std;
+
+// Gomocup / Piskvork front end: the manager talks to the engine over stdin and stdout
+int main(int argc, char** argv) {
+    const bool ponder = !(argc > 1 && strcmp(argv[1], "--no-ponder") == 0);
+    PbrainEngine engine(ponder);
+    engine.run(cin, cout);
+    return 0;
+}
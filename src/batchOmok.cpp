@@ -0,0 +1,192 @@
+#include <algorithm>
+#include <array>
+#include "../include/batchOmok.h"
+#include "../include/renjuRules.h"
+
+namespace {
+    typedef MNKBoard::PieceDirection PieceDirection;
+
+    inline CellState otherPlayer(CellState player) {
+        return player == CellState::black ? CellState::white : CellState::black;
+    }
+}
+
+BatchOmok::BatchOmok(int numGames, Omok::RuleSet ruleSet) : numGames(std::max(numGames, 0)), ruleSet(ruleSet),
+                                                            linePlanes(std::size_t(this->numGames)*PLANES_SIZE),
+                                                            curPlayers(this->numGames), gamesFinished(this->numGames),
+                                                            moveCounts(this->numGames), stepFlags(this->numGames) {
+    clearBoards();
+}
+
+/**
+ * One pass over the games. The cheap part (bounds, occupancy and the finished flag) is
+ * read from the flat arrays; the rule check and the win check look up the pattern table
+ * on the four lines through the move, as Omok does through its threat cache.
+ **/
+const std::uint8_t* BatchOmok::placePieces(const Move* moves) {
+    for(int gameInd=0; gameInd<numGames; gameInd++) {
+        const int row = moves[gameInd].row, col = moves[gameInd].col;
+        LineWord* planes = &linePlanes[std::size_t(gameInd)*PLANES_SIZE];
+        if(gamesFinished[gameInd]) {
+            stepFlags[gameInd] = FINISHED;
+            continue;
+        }
+        if(row < 0 || row >= BOARD_SIZE || col < 0 || col >= BOARD_SIZE
+           || ((planes[row + LINE_OFFSETS[1]] | planes[NUM_LINES + row + LINE_OFFSETS[1]]) >> col) & 1) {
+            stepFlags[gameInd] = 0;
+            continue;
+        }
+
+        // the first move of a game is never forbidden
+        const CellState player = curPlayers[gameInd];
+        if(moveCounts[gameInd] > 0 && isForbidden(planes, player, row, col)) {
+            stepFlags[gameInd] = FORBIDDEN;
+            continue;
+        }
+
+        flipPiece(planes, player, row, col);
+        moveCounts[gameInd]++;
+        std::uint8_t flags = PLACED;
+        for(int dirInd=0; dirInd<MNKBoard::NUM_DIRS; dirInd++)
+            if(Omok::isWinningPattern(ruleSet, LinePatterns::getPattern(patternIndex(planes, row, col, player,
+                                                                                     static_cast<PieceDirection>(dirInd)))))
+                flags = PLACED | WIN | FINISHED;
+
+        // the winner stays the player to move, as in Omok
+        if(flags & WIN)
+            gamesFinished[gameInd] = true;
+        else
+            curPlayers[gameInd] = otherPlayer(player);
+        stepFlags[gameInd] = flags;
+    }
+    return stepFlags.data();
+}
+
+void BatchOmok::clearBoards(void) {
+    std::fill(linePlanes.begin(), linePlanes.end(), 0);
+    std::fill(curPlayers.begin(), curPlayers.end(), CellState::black);
+    std::fill(gamesFinished.begin(), gamesFinished.end(), false);
+    std::fill(moveCounts.begin(), moveCounts.end(), 0);
+    std::fill(stepFlags.begin(), stepFlags.end(), 0);
+}
+
+void BatchOmok::clearBoard(int gameInd) {
+    std::fill_n(linePlanes.begin() + std::size_t(gameInd)*PLANES_SIZE, PLANES_SIZE, 0);
+    curPlayers[gameInd] = CellState::black;
+    gamesFinished[gameInd] = false;
+    moveCounts[gameInd] = 0;
+    stepFlags[gameInd] = 0;
+}
+
+int BatchOmok::size(void) const {
+    return numGames;
+}
+
+Omok::RuleSet BatchOmok::getRuleSet(void) const {
+    return ruleSet;
+}
+
+CellState BatchOmok::getCell(int gameInd, int row, int col) const {
+    const LineWord* planes = &linePlanes[std::size_t(gameInd)*PLANES_SIZE];
+    if((planes[LINE_OFFSETS[1] + row] >> col) & 1)
+        return CellState::black;
+    if((planes[NUM_LINES + LINE_OFFSETS[1] + row] >> col) & 1)
+        return CellState::white;
+    return CellState::none;
+}
+
+CellState BatchOmok::getCurrentPlayer(int gameInd) const {
+    return curPlayers[gameInd];
+}
+
+bool BatchOmok::isFinished(int gameInd) const {
+    return gamesFinished[gameInd];
+}
+
+int BatchOmok::getGameWinner(int gameInd) const {
+    if(!gamesFinished[gameInd])
+        return 0;
+    return curPlayers[gameInd] == CellState::black ? 1 : 2;
+}
+
+int BatchOmok::getMoveCount(int gameInd) const {
+    return moveCounts[gameInd];
+}
+
+// same line numbering as MNKBoard::lineIndex, with the lines of each direction offset
+int BatchOmok::lineIndex(PieceDirection dir, int row, int col) {
+    switch(dir) {
+        case PieceDirection::VERT: return LINE_OFFSETS[0] + col;
+        case PieceDirection::HORZ: return LINE_OFFSETS[1] + row;
+        case PieceDirection::FSD:  return LINE_OFFSETS[2] + row + col;
+        default:                   return LINE_OFFSETS[3] + col - row + BOARD_SIZE - 1;
+    }
+}
+
+// diagonals use the column as bit index, so diagonal d covers columns d-14 to d
+const BatchOmok::LineWord* BatchOmok::lineMasks(void) {
+    static const std::array<LineWord, NUM_LINES> MASKS = []() {
+        std::array<LineWord, NUM_LINES> masks{};
+        for(int lineInd=0; lineInd<2*BOARD_SIZE; lineInd++)
+            masks[lineInd] = (1 << BOARD_SIZE) - 1;
+        for(int diagInd=0; diagInd<NUM_DIAGS; diagInd++) {
+            LineWord diagMask = 0;
+            for(int colInd=std::max(0, diagInd-BOARD_SIZE+1); colInd<=std::min(BOARD_SIZE-1, diagInd); colInd++)
+                diagMask |= LineWord(1) << colInd;
+            masks[LINE_OFFSETS[2] + diagInd] = masks[LINE_OFFSETS[3] + diagInd] = diagMask;
+        }
+        return masks;
+    }();
+    return MASKS.data();
+}
+
+MNKBoard::LineBits BatchOmok::getLineBits(const LineWord* planes, CellState state, PieceDirection dir, int row, int col) {
+    const int lineInd = lineIndex(dir, row, col);
+    if(state == CellState::none)
+        return lineMasks()[lineInd] & ~(planes[lineInd] | planes[NUM_LINES + lineInd]);
+    return planes[MNKBoard::playerIndex(state)*NUM_LINES + lineInd];
+}
+
+// placing and removing a piece are the same toggle of its four line bits
+void BatchOmok::flipPiece(LineWord* planes, CellState player, int row, int col) {
+    LineWord* playerPlanes = planes + MNKBoard::playerIndex(player)*NUM_LINES;
+    for(int dirInd=0; dirInd<MNKBoard::NUM_DIRS; dirInd++) {
+        const PieceDirection dir = static_cast<PieceDirection>(dirInd);
+        playerPlanes[lineIndex(dir, row, col)] ^= LineWord(1) << MNKBoard::bitIndex(dir, row, col);
+    }
+}
+
+int BatchOmok::patternIndex(const LineWord* planes, int row, int col, CellState player, PieceDirection dir) {
+    return LinePatterns::windowIndex(getLineBits(planes, player, dir, row, col), getLineBits(planes, CellState::none, dir, row, col),
+                                     MNKBoard::bitIndex(dir, row, col));
+}
+
+// as Omok::isForbidden once the game has started
+bool BatchOmok::isForbidden(LineWord* planes, CellState player, int row, int col) const {
+    if(!Omok::hasForbiddenMoves(ruleSet))
+        return false;
+    if(ruleSet == Omok::RuleSet::renju && player == CellState::black) {
+        RenjuPlanes renjuPlanes{planes};
+        return RenjuRules::isForbidden(renjuPlanes, row, col);
+    }
+
+    int numO3 = 0;
+    for(int dirInd=0; dirInd<MNKBoard::NUM_DIRS; dirInd++) {
+        const PieceDirection dir = static_cast<PieceDirection>(dirInd);
+        if(LinePatterns::threeGaps(patternIndex(planes, row, col, player, dir), MNKBoard::bitIndex(dir, row, col)))
+            numO3++;
+    }
+    return numO3 >= 2;
+}
+
+int BatchOmok::RenjuPlanes::patternIndex(int row, int col, PieceDirection dir, int) const {
+    return BatchOmok::patternIndex(planes, row, col, CellState::black, dir);
+}
+
+void BatchOmok::RenjuPlanes::placeBlack(int row, int col) {
+    flipPiece(planes, CellState::black, row, col);
+}
+
+void BatchOmok::RenjuPlanes::removeBlack(int row, int col) {
+    flipPiece(planes, CellState::black, row, col);
+}
@@ -0,0 +1,152 @@
+#include "../include/board.h"
+#include <algorithm>
+#include <cstring>
+#include <new>
+
+namespace {
+    typedef MNKBoard::LineBits LineBits;
+    typedef MNKBoard::PieceDirection PieceDirection;
+
+    inline LineBits lowBitsMask(int numBits) {
+        return numBits >= 64 ? ~LineBits(0) : ((LineBits(1) << numBits) - 1);
+    }
+
+    /**
+     * BoardCore for any other size: the same line planes, stored right after the core in
+     * its block, with every index computed from the dimensions at runtime.
+     **/
+    class DynamicBoardCore final : public BoardCore{
+    public:
+        // the planes of both players and the masks follow the core
+        static std::size_t storageSize(int m, int n) {
+            return sizeof(DynamicBoardCore) + 3*(n + m + 2*(m+n-1))*sizeof(LineBits);
+        }
+
+        DynamicBoardCore(int m, int n, int k) : numRows(m), numCols(n), winSize(k) {
+            // one line per row / column and (m+n-1) lines for each diagonal direction
+            const int dirLines[MNKBoard::NUM_DIRS] = {n, m, m+n-1, m+n-1};
+            totalLines = n + m + 2*(m+n-1);
+            LineBits* lineData = reinterpret_cast<LineBits*>(this + 1);
+            std::fill_n(lineData, 3*totalLines, 0);
+            for(int dirInd=0, lineOffset=0; dirInd<MNKBoard::NUM_DIRS; lineOffset+=dirLines[dirInd], dirInd++) {
+                planes[0][dirInd] = lineData + lineOffset;
+                planes[1][dirInd] = lineData + totalLines + lineOffset;
+                lineMasks[dirInd] = lineData + 2*totalLines + lineOffset;
+                masks[dirInd] = lineMasks[dirInd];
+                numLines[dirInd] = dirLines[dirInd];
+            }
+
+            // precompute which bits of each line actually lie on the board
+            std::fill_n(lineMasks[(int)PieceDirection::VERT], numCols, lowBitsMask(numRows));
+            std::fill_n(lineMasks[(int)PieceDirection::HORZ], numRows, lowBitsMask(numCols));
+            for(int diagInd=0; diagInd<numRows+numCols-1; diagInd++) {
+                // both diagonal directions cover the columns [d-m+1, d] clipped to the board
+                const int lowCol = std::max(0, diagInd-numRows+1);
+                const int highCol = std::min(numCols-1, diagInd);
+                const LineBits diagMask = lowBitsMask(highCol+1) & ~lowBitsMask(lowCol);
+                lineMasks[(int)PieceDirection::FSD][diagInd] = diagMask;
+                lineMasks[(int)PieceDirection::BSD][diagInd] = diagMask;
+            }
+        }
+
+        void setCell(int playerInd, int row, int col) override {
+            for(int dirInd=0; dirInd<MNKBoard::NUM_DIRS; dirInd++) {
+                const PieceDirection dir = static_cast<PieceDirection>(dirInd);
+                planes[playerInd][dirInd][lineIndex(dir, row, col)] |= LineBits(1) << MNKBoard::bitIndex(dir, row, col);
+            }
+        }
+
+        void clearCell(int row, int col) override {
+            for(int dirInd=0; dirInd<MNKBoard::NUM_DIRS; dirInd++) {
+                const PieceDirection dir = static_cast<PieceDirection>(dirInd);
+                const LineBits clearMask = ~(LineBits(1) << MNKBoard::bitIndex(dir, row, col));
+                planes[0][dirInd][lineIndex(dir, row, col)] &= clearMask;
+                planes[1][dirInd][lineIndex(dir, row, col)] &= clearMask;
+            }
+        }
+
+        bool hasRun(int playerInd, int row, int col) const override {
+            int lowBit, highBit;
+            for(int dirInd=0; dirInd<MNKBoard::NUM_DIRS; dirInd++) {
+                const PieceDirection dir = static_cast<PieceDirection>(dirInd);
+                const LineBits lineBits = planes[playerInd][dirInd][lineIndex(dir, row, col)];
+                if(MNKBoard::runLength(lineBits, MNKBoard::bitIndex(dir, row, col), lowBit, highBit) >= winSize)
+                    return true;
+            }
+            return false;
+        }
+
+        void clear(void) override {
+            std::fill_n(planes[0][0], 2*totalLines, 0);
+        }
+
+    private:
+        int numRows;
+        int numCols;
+        int winSize;
+        LineBits* lineMasks[MNKBoard::NUM_DIRS];
+
+        int lineIndex(PieceDirection dir, int row, int col) const {
+            switch(dir) {
+                case PieceDirection::VERT: return col;
+                case PieceDirection::HORZ: return row;
+                case PieceDirection::FSD:  return row + col;
+                default:                   return col - row + numRows - 1;
+            }
+        }
+    };
+
+    // a compile-time board: its size and how to build it in a block
+    struct FixedCoreType {
+        int m;
+        int n;
+        int k;
+        std::size_t size;
+        BoardCore* (*construct)(void* memory);
+    };
+
+    template<int M, int N, int K>
+    BoardCore* constructFixed(void* memory) {
+        return new(memory) FixedBoardCore<M, N, K>();
+    }
+
+    template<int M, int N, int K>
+    constexpr FixedCoreType fixedCore(void) {
+        return {M, N, K, sizeof(FixedBoardCore<M, N, K>), constructFixed<M, N, K>};
+    }
+
+    /**
+     * Omok boards and the small boards of the exhaustive solver get their own compile-time
+     * board; adding a size here is all it takes to specialise it.
+     **/
+    const FixedCoreType FIXED_CORES[] = {
+        fixedCore<15, 15, 5>(),
+        fixedCore<19, 19, 5>(),
+        fixedCore<3, 3, 3>(),
+        fixedCore<4, 4, 4>()
+    };
+
+    const FixedCoreType* findFixedCore(int m, int n, int k) {
+        for(const FixedCoreType& coreType : FIXED_CORES)
+            if(coreType.m == m && coreType.n == n && coreType.k == k)
+                return &coreType;
+        return nullptr;
+    }
+}
+
+std::size_t BoardCore::storageSize(int m, int n, int k) {
+    const FixedCoreType* coreType = findFixedCore(m, n, k);
+    return coreType ? coreType->size : DynamicBoardCore::storageSize(m, n);
+}
+
+BoardCore* BoardCore::create(int m, int n, int k, void* memory) {
+    const FixedCoreType* coreType = findFixedCore(m, n, k);
+    if(coreType)
+        return coreType->construct(memory);
+    return new(memory) DynamicBoardCore(m, n, k);
+}
+
+void BoardCore::copyFrom(const BoardCore& otherCore) {
+    std::memcpy(planes[0][0], otherCore.planes[0][0], totalLines*sizeof(LineBits));
+    std::memcpy(planes[1][0], otherCore.planes[1][0], totalLines*sizeof(LineBits));
+}
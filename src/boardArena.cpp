@@ -0,0 +1,91 @@
+#include "../include/boardArena.h"
+#include <new>
+#include <utility>
+
+BoardArena::BoardArena(std::size_t chunkSize) : chunkSize(roundSize(chunkSize)) {}
+
+BoardArena::~BoardArena() {
+    for(void* chunk : chunks)
+        ::operator delete(chunk, std::align_val_t(ALIGNMENT));
+}
+
+std::size_t BoardArena::roundSize(std::size_t size) {
+    return size == 0 ? ALIGNMENT : (size + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+}
+
+void* BoardArena::allocate(std::size_t size) {
+    size = roundSize(size);
+    for(FreeList& freeList : freeLists) {
+        if(freeList.size == size && freeList.head) {
+            void* block = freeList.head;
+            freeList.head = *static_cast<void**>(block);
+            return block;
+        }
+    }
+
+    // blocks larger than a chunk get a chunk of their own
+    if(size > chunkLeft) {
+        const std::size_t newSize = size > chunkSize ? size : chunkSize;
+        chunks.push_back(::operator new(newSize, std::align_val_t(ALIGNMENT)));
+        reservedBytes += newSize;
+        if(size > chunkSize)
+            return chunks.back();
+        chunkPos = static_cast<char*>(chunks.back());
+        chunkLeft = newSize;
+    }
+    void* block = chunkPos;
+    chunkPos += size;
+    chunkLeft -= size;
+    return block;
+}
+
+void BoardArena::release(void* memory, std::size_t size) {
+    size = roundSize(size);
+    for(FreeList& freeList : freeLists) {
+        if(freeList.size == size) {
+            *static_cast<void**>(memory) = freeList.head;
+            freeList.head = memory;
+            return;
+        }
+    }
+    *static_cast<void**>(memory) = nullptr;
+    freeLists.push_back({size, memory});
+}
+
+std::size_t BoardArena::getReservedBytes(void) const {
+    return reservedBytes;
+}
+
+ArenaBlock::ArenaBlock(std::size_t size, BoardArena* arena) : blockSize(size), arena(arena) {
+    memory = arena ? arena->allocate(size) : ::operator new(size, std::align_val_t(BoardArena::ALIGNMENT));
+}
+
+ArenaBlock::ArenaBlock(ArenaBlock&& otherBlock) noexcept : memory(otherBlock.memory), blockSize(otherBlock.blockSize),
+                                                          arena(otherBlock.arena) {
+    otherBlock.memory = nullptr;
+    otherBlock.blockSize = 0;
+}
+
+ArenaBlock& ArenaBlock::operator=(ArenaBlock&& otherBlock) noexcept {
+    if(this != &otherBlock) {
+        release();
+        memory = std::exchange(otherBlock.memory, nullptr);
+        blockSize = std::exchange(otherBlock.blockSize, 0);
+        arena = otherBlock.arena;
+    }
+    return *this;
+}
+
+ArenaBlock::~ArenaBlock() {
+    release();
+}
+
+void ArenaBlock::release(void) {
+    if(!memory)
+        return;
+    if(arena)
+        arena->release(memory, blockSize);
+    else
+        ::operator delete(memory, std::align_val_t(BoardArena::ALIGNMENT));
+    memory = nullptr;
+}
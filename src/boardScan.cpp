@@ -0,0 +1,224 @@
+#include "../include/boardScan.h"
+#include <algorithm>
+#include <cstring>
+#include <tuple>
+
+namespace {
+    typedef MNKBoard::LineBits LineBits;
+    typedef MNKBoard::PieceDirection PieceDirection;
+
+    // masks the kernel writes for every line of one player
+    enum ScanMask {
+        WINDOWS_0,              // first cells of the free windows holding 0..5 own pieces
+        FIVES = WINDOWS_0 + 6,  // first cells of the runs of exactly five
+        OPEN_FOURS,             // first cells of .xxxx.
+        OPEN_THREES,            // first pieces of the open threes
+        FIVE_POINTS,            // empty cells completing a window of four
+        FOUR_POINTS,            // empty cells in a window of three
+        NUM_MASKS,
+        NUM_COUNTED = FIVE_POINTS   // masks that are counted
+    };
+
+    // lines handed to the kernel at a time, and the most lines a board can have
+    constexpr int CHUNK_LINES = 32;
+    constexpr int MAX_LINES = 4*MNKBoard::MAX_DIM + 2*(MNKBoard::MAX_DIM-1);
+
+    typedef LineBits Lanes1;
+    typedef LineBits Lanes2 __attribute__((vector_size(16)));
+    typedef LineBits Lanes4 __attribute__((vector_size(32)));
+
+    /**
+     * Computes the masks of as many lines as there are lanes. The number of own pieces
+     * of every window is summed bit-sliced: the five shifted planes go through two full
+     * adders into a 3-bit count per window start.
+     **/
+    template<typename Lanes>
+    __attribute__((always_inline)) inline void scanLanes(const LineBits* own, const LineBits* empty, LineBits* const* masks, int lineInd) {
+        Lanes ownBits, emptyBits;
+        std::memcpy(&ownBits, own + lineInd, sizeof(Lanes));
+        std::memcpy(&emptyBits, empty + lineInd, sizeof(Lanes));
+        const Lanes freeBits = ownBits | emptyBits;
+
+        const Lanes own1 = ownBits >> 1, own2 = ownBits >> 2, own3 = ownBits >> 3, own4 = ownBits >> 4;
+        const Lanes freeWindows = freeBits & (freeBits >> 1) & (freeBits >> 2) & (freeBits >> 3) & (freeBits >> 4);
+
+        // count = bit0 + 2*bit1 + 4*bit2
+        const Lanes sum0 = ownBits ^ own1 ^ own2;
+        const Lanes carry0 = (ownBits & own1) | (own2 & (ownBits ^ own1));
+        const Lanes bit0 = sum0 ^ own3 ^ own4;
+        const Lanes carry1 = (sum0 & own3) | (own4 & (sum0 ^ own3));
+        const Lanes bit1 = carry0 ^ carry1;
+        const Lanes bit2 = carry0 & carry1;
+
+        Lanes windows[6];
+        windows[0] = freeWindows & ~(bit0 | bit1 | bit2);
+        windows[1] = freeWindows & bit0 & ~(bit1 | bit2);
+        windows[2] = freeWindows & bit1 & ~(bit0 | bit2);
+        windows[3] = freeWindows & bit0 & bit1;
+        windows[4] = freeWindows & bit2 & ~bit0;
+        windows[5] = freeWindows & bit2 & bit0;
+        for(int countInd=0; countInd<6; countInd++)
+            std::memcpy(masks[WINDOWS_0 + countInd] + lineInd, &windows[countInd], sizeof(Lanes));
+
+        // open threes: .xxx.. / ..xxx. / .x.xx. / .xx.x., each marked on its first piece
+        const Lanes empty1 = emptyBits >> 1, empty2 = emptyBits >> 2, empty3 = emptyBits >> 3;
+        const Lanes empty4 = emptyBits >> 4, empty5 = emptyBits >> 5;
+        const Lanes openEnds = emptyBits & empty5;
+        const Lanes openThrees = ((openEnds & own1 & own2 & own3 & empty4) << 1)
+                                 | ((openEnds & empty1 & own2 & own3 & own4) << 2)
+                                 | ((openEnds & own1 & empty2 & own3 & own4) << 1)
+                                 | ((openEnds & own1 & own2 & empty3 & own4) << 1);
+        const Lanes fives = windows[5] & ~(ownBits << 1) & ~(ownBits >> 5);
+        const Lanes openFours = openEnds & own1 & own2 & own3 & own4;
+
+        const Lanes fivePoints = emptyBits & (windows[4] | (windows[4] << 1) | (windows[4] << 2) | (windows[4] << 3) | (windows[4] << 4));
+        const Lanes fourPoints = emptyBits & (windows[3] | (windows[3] << 1) | (windows[3] << 2) | (windows[3] << 3) | (windows[3] << 4));
+
+        std::memcpy(masks[FIVES] + lineInd, &fives, sizeof(Lanes));
+        std::memcpy(masks[OPEN_FOURS] + lineInd, &openFours, sizeof(Lanes));
+        std::memcpy(masks[OPEN_THREES] + lineInd, &openThrees, sizeof(Lanes));
+        std::memcpy(masks[FIVE_POINTS] + lineInd, &fivePoints, sizeof(Lanes));
+        std::memcpy(masks[FOUR_POINTS] + lineInd, &fourPoints, sizeof(Lanes));
+    }
+
+    /**
+     * Runs the lines through the lanes (and the rest one by one) and adds the pattern
+     * counts up. Inlined into every kernel, so the counts use the popcount of its target.
+     **/
+    template<typename Lanes>
+    __attribute__((always_inline)) inline void scanLines(const LineBits* own, const LineBits* empty, int numLines,
+                                                         LineBits* const* masks, int* counts) {
+        const int numLanes = sizeof(Lanes) / sizeof(LineBits);
+        int lineInd = 0;
+        for(; lineInd+numLanes<=numLines; lineInd+=numLanes)
+            scanLanes<Lanes>(own, empty, masks, lineInd);
+        for(; lineInd<numLines; lineInd++)
+            scanLanes<Lanes1>(own, empty, masks, lineInd);
+
+        for(int maskInd=0; maskInd<NUM_COUNTED; maskInd++)
+            for(lineInd=0; lineInd<numLines; lineInd++)
+                counts[maskInd] += __builtin_popcountll(masks[maskInd][lineInd]);
+    }
+
+    typedef void (*ScanKernel)(const LineBits* own, const LineBits* empty, int numLines, LineBits* const* masks, int* counts);
+
+    void scanScalar(const LineBits* own, const LineBits* empty, int numLines, LineBits* const* masks, int* counts) {
+        scanLines<Lanes1>(own, empty, numLines, masks, counts);
+    }
+
+#if defined(__x86_64__) || defined(__i386__)
+    __attribute__((target("sse2")))
+    void scanSse2(const LineBits* own, const LineBits* empty, int numLines, LineBits* const* masks, int* counts) {
+        scanLines<Lanes2>(own, empty, numLines, masks, counts);
+    }
+
+    // every CPU with AVX2 also has POPCNT
+    __attribute__((target("avx2,popcnt")))
+    void scanAvx2(const LineBits* own, const LineBits* empty, int numLines, LineBits* const* masks, int* counts) {
+        scanLines<Lanes4>(own, empty, numLines, masks, counts);
+    }
+#endif
+
+    ScanKernel kernelFunction(BoardScanner::Kernel kernel) {
+#if defined(__x86_64__) || defined(__i386__)
+        if(kernel == BoardScanner::Kernel::avx2)
+            return scanAvx2;
+        if(kernel == BoardScanner::Kernel::sse2)
+            return scanSse2;
+#endif
+        return scanScalar;
+    }
+
+    // board cell of a bit of a line given by its index
+    inline int lineCellIndex(PieceDirection dir, int lineInd, int bit, int numRows, int numCols) {
+        switch(dir) {
+            case PieceDirection::VERT: return bit*numCols + lineInd;
+            case PieceDirection::HORZ: return lineInd*numCols + bit;
+            case PieceDirection::FSD:  return (lineInd-bit)*numCols + bit;
+            default:                   return (bit-lineInd+numRows-1)*numCols + bit;
+        }
+    }
+}
+
+BoardScanner::Kernel BoardScanner::bestKernel(void) {
+    static const Kernel kernel = isSupported(Kernel::avx2) ? Kernel::avx2
+                                 : isSupported(Kernel::sse2) ? Kernel::sse2 : Kernel::scalar;
+    return kernel;
+}
+
+bool BoardScanner::isSupported(Kernel kernel) {
+#if defined(__x86_64__) || defined(__i386__)
+    if(kernel == Kernel::avx2)
+        return __builtin_cpu_supports("avx2");
+    if(kernel == Kernel::sse2)
+        return __builtin_cpu_supports("sse2");
+    return true;
+#else
+    return kernel == Kernel::scalar;
+#endif
+}
+
+void BoardScanner::scan(MNKBoard& board, BoardFeatures& features, std::uint8_t* threatMaps) {
+    scan(board, features, threatMaps, bestKernel());
+}
+
+/**
+ * Lines are gathered direction by direction, so every line knows its direction and
+ * index when the threat maps are filled from the masks.
+ **/
+void BoardScanner::scan(MNKBoard& board, BoardFeatures& features, std::uint8_t* threatMaps, Kernel kernel) {
+    int numRows, numCols;
+    std::tie(numRows, numCols) = board.getBoardSize();
+    const ScanKernel scanKernel = kernelFunction(isSupported(kernel) ? kernel : Kernel::scalar);
+
+    LineBits ownLines[2][MAX_LINES], emptyLines[MAX_LINES];
+    PieceDirection lineDirs[MAX_LINES];
+    int lineInds[MAX_LINES];
+    int numLines = 0;
+    for(int dirInd=0; dirInd<MNKBoard::NUM_DIRS; dirInd++) {
+        const PieceDirection dir = static_cast<PieceDirection>(dirInd);
+        for(int lineInd=0; lineInd<board.getNumLines(dir); lineInd++, numLines++) {
+            ownLines[0][numLines] = board.getLine(CellState::black, dir, lineInd);
+            ownLines[1][numLines] = board.getLine(CellState::white, dir, lineInd);
+            emptyLines[numLines] = board.getLine(CellState::none, dir, lineInd);
+            lineDirs[numLines] = dir;
+            lineInds[numLines] = lineInd;
+        }
+    }
+
+    features = BoardFeatures();
+    if(threatMaps)
+        std::memset(threatMaps, 0, 2*numRows*numCols);
+
+    LineBits maskBuffer[NUM_MASKS][CHUNK_LINES];
+    LineBits* masks[NUM_MASKS];
+    for(int maskInd=0; maskInd<NUM_MASKS; maskInd++)
+        masks[maskInd] = maskBuffer[maskInd];
+
+    for(int playerInd=0; playerInd<2; playerInd++) {
+        int counts[NUM_COUNTED] = {};
+        for(int chunkStart=0; chunkStart<numLines; chunkStart+=CHUNK_LINES) {
+            const int chunkLines = std::min(CHUNK_LINES, numLines - chunkStart);
+            scanKernel(ownLines[playerInd] + chunkStart, emptyLines + chunkStart, chunkLines, masks, counts);
+            if(!threatMaps)
+                continue;
+
+            // threats are sparse, so the cells are visited bit by bit
+            std::uint8_t* playerMap = threatMaps + playerInd*numRows*numCols;
+            for(int lineInd=0; lineInd<chunkLines; lineInd++) {
+                const PieceDirection dir = lineDirs[chunkStart + lineInd];
+                const int boardLine = lineInds[chunkStart + lineInd];
+                for(LineBits pointBits=masks[FIVE_POINTS][lineInd]; pointBits; pointBits &= pointBits - 1)
+                    playerMap[lineCellIndex(dir, boardLine, __builtin_ctzll(pointBits), numRows, numCols)] |= FIVE_POINT;
+                for(LineBits pointBits=masks[FOUR_POINTS][lineInd]; pointBits; pointBits &= pointBits - 1)
+                    playerMap[lineCellIndex(dir, boardLine, __builtin_ctzll(pointBits), numRows, numCols)] |= FOUR_POINT;
+            }
+        }
+
+        for(int countInd=0; countInd<6; countInd++)
+            features.windows[playerInd][countInd] = counts[WINDOWS_0 + countInd];
+        features.fives[playerInd] = counts[FIVES];
+        features.openFours[playerInd] = counts[OPEN_FOURS];
+        features.openThrees[playerInd] = counts[OPEN_THREES];
+    }
+}
@@ -0,0 +1,575 @@
+#include "../include/dfpnSolver.h"
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+
+/**
+ * Interface between the solver and the rules of a game. Cells are addressed as
+ * row*numCols+col and moves are always played by the side to move.
+ **/
+class DfpnPosition {
+public:
+    int numRows;
+    int numCols;
+
+    virtual ~DfpnPosition() = default;
+
+    virtual CellState sideToMove(void) const = 0;
+    virtual std::uint64_t hashKey(void) const = 0;
+    // key of the position after the side to move plays the cell
+    virtual std::uint64_t childKey(std::uint64_t key, int cell) const = 0;
+    // true if the previous move won the game
+    virtual bool lastMoveWon(void) = 0;
+    virtual bool isEmpty(int cell) = 0;
+    // true if the cell is empty and may be played by the side to move
+    virtual bool isLegal(int cell) = 0;
+    // true if the player would win by playing the (empty) cell
+    virtual bool winsAt(CellState player, int cell) = 0;
+    virtual bool makeMove(int cell) = 0;
+    virtual void unmakeMove(void) = 0;
+    virtual int winSize(void) const = 0;
+};
+
+namespace {
+    typedef MNKBoard::PieceDirection PieceDirection;
+    typedef MNKBoard::LineBits LineBits;
+
+    inline CellState otherPlayer(CellState player) {
+        return player == CellState::black ? CellState::white : CellState::black;
+    }
+
+    // length of the player's run through (row, col) once the cell is filled, in one direction
+    inline int runThrough(MNKBoard& board, CellState player, PieceDirection dir, int row, int col) {
+        const int bit = MNKBoard::bitIndex(dir, row, col);
+        int lowBit, highBit;
+        return MNKBoard::runLength(board.getLineBits(player, dir, row, col) | (LineBits(1) << bit), bit, lowBit, highBit);
+    }
+
+    // Omok rules: exactly five wins and double threes are forbidden for both players
+    class OmokPosition : public DfpnPosition {
+    public:
+        explicit OmokPosition(Omok& game) : game(game) {
+            std::tie(numRows, numCols) = game.getBoardSize();
+        }
+
+        // a finished game keeps the winner as its current player
+        CellState sideToMove(void) const override {
+            return game.isFinished() ? otherPlayer(game.getCurrentPlayer()) : game.getCurrentPlayer();
+        }
+        std::uint64_t hashKey(void) const override { return game.getHashKey(); }
+        std::uint64_t childKey(std::uint64_t key, int cell) const override {
+            return key ^ MNKBoard::zobristKey(game.getCurrentPlayer(), cell / numCols, cell % numCols) ^ MNKBoard::zobristSideKey();
+        }
+        bool lastMoveWon(void) override { return game.isFinished(); }
+        bool isEmpty(int cell) override { return game.isPosEmpty(cell / numCols, cell % numCols); }
+        bool isLegal(int cell) override {
+            const int row = cell / numCols, col = cell % numCols;
+            return game.isPosEmpty(row, col) && !game.isForbidden(row, col);
+        }
+        bool winsAt(CellState player, int cell) override {
+            const int row = cell / numCols, col = cell % numCols;
+            bool isFive = false, isOverline = false;
+            int numThrees = 0;
+            for(int dirInd=0; dirInd<MNKBoard::NUM_DIRS; dirInd++) {
+                const PieceDirection dir = static_cast<PieceDirection>(dirInd);
+                const int runLen = runThrough(game, player, dir, row, col);
+                isFive |= runLen == 5;
+                isOverline |= runLen > 5;
+                if(game.openThreeGaps(row, col, player, dir))
+                    numThrees++;
+            }
+            // without forbidden moves every winning line stands
+            if(!Omok::hasForbiddenMoves(game.getRuleSet()))
+                return isFive || (isOverline && Omok::overlineWins(game.getRuleSet()));
+            // a Renju five of black stands even if it also forms other patterns
+            if(game.getRuleSet() == Omok::RuleSet::renju && player == CellState::black)
+                return isFive;
+            return isFive && (numThrees < 2 || game.getMoveCount() == 0);
+        }
+        bool makeMove(int cell) override { return game.makeMove(cell / numCols, cell % numCols); }
+        void unmakeMove(void) override { game.unmakeMove(); }
+        int winSize(void) const override { return game.getWinSize(); }
+
+    private:
+        Omok& game;
+    };
+
+    // m,n,k rules: k or more in a row wins and any empty cell may be played
+    class MNKPosition : public DfpnPosition {
+    public:
+        explicit MNKPosition(MNKBoard& board) : board(board) {
+            std::tie(numRows, numCols) = board.getBoardSize();
+
+            // black moves first, so equal piece counts mean black is to move
+            int pieceDiff = 0;
+            for(int rowInd=0; rowInd<numRows; rowInd++)
+                pieceDiff += __builtin_popcountll(board.getLine(CellState::black, PieceDirection::HORZ, rowInd))
+                             - __builtin_popcountll(board.getLine(CellState::white, PieceDirection::HORZ, rowInd));
+            curPlayer = pieceDiff > 0 ? CellState::white : CellState::black;
+        }
+
+        CellState sideToMove(void) const override { return curPlayer; }
+        std::uint64_t hashKey(void) const override { return board.getHashKey(); }
+        std::uint64_t childKey(std::uint64_t key, int cell) const override {
+            return key ^ MNKBoard::zobristKey(curPlayer, cell / numCols, cell % numCols);
+        }
+        bool lastMoveWon(void) override { return board.checkWin(); }
+        bool isEmpty(int cell) override { return board.isPosEmpty(cell / numCols, cell % numCols); }
+        bool isLegal(int cell) override { return board.isPosEmpty(cell / numCols, cell % numCols); }
+        bool winsAt(CellState player, int cell) override {
+            for(int dirInd=0; dirInd<MNKBoard::NUM_DIRS; dirInd++)
+                if(runThrough(board, player, static_cast<PieceDirection>(dirInd), cell / numCols, cell % numCols) >= board.getWinSize())
+                    return true;
+            return false;
+        }
+        bool makeMove(int cell) override {
+            if(!board.makeMove(cell / numCols, cell % numCols, curPlayer))
+                return false;
+            curPlayer = otherPlayer(curPlayer);
+            return true;
+        }
+        void unmakeMove(void) override {
+            board.unmakeMove();
+            curPlayer = otherPlayer(curPlayer);
+        }
+        int winSize(void) const override { return board.getWinSize(); }
+
+    private:
+        MNKBoard& board;
+        CellState curPlayer;
+    };
+
+    /**
+     * Applies the game rules shared by the solver and the proof checker. Returns true
+     * for a finished node (attackerWins then holds the outcome), otherwise fills moves:
+     *  - a node where the side to move can win at once is a win,
+     *  - a pending win of the opponent leaves only the blocking moves (none: a loss),
+     *  - a node without legal moves is a draw.
+     **/
+    bool expandNode(DfpnPosition& pos, CellState attacker, std::vector<int>& moves, bool& attackerWins) {
+        moves.clear();
+        const CellState mover = pos.sideToMove(), opponent = otherPlayer(mover);
+        if(pos.lastMoveWon()) {
+            attackerWins = opponent == attacker;
+            return true;
+        }
+
+        for(int cell=0; cell<pos.numRows*pos.numCols; cell++) {
+            if(!pos.isLegal(cell))
+                continue;
+            if(pos.winsAt(mover, cell)) {
+                attackerWins = mover == attacker;
+                return true;
+            }
+            moves.push_back(cell);
+        }
+        if(moves.empty()) {
+            attackerWins = false;
+            return true;
+        }
+
+        // the opponent's winning cells may be forbidden for the side to move, so check every empty cell
+        bool isThreatened = false;
+        for(int cell=0; cell<pos.numRows*pos.numCols && !isThreatened; cell++)
+            isThreatened = pos.isEmpty(cell) && pos.winsAt(opponent, cell);
+        if(isThreatened) {
+            moves.erase(std::remove_if(moves.begin(), moves.end(),
+                                       [&](int cell) { return !pos.winsAt(opponent, cell); }), moves.end());
+            if(moves.empty()) {
+                attackerWins = opponent == attacker;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    inline std::uint32_t saturatedAdd(std::uint32_t lhs, std::uint32_t rhs, std::uint32_t maxVal) {
+        return lhs + rhs >= maxVal ? maxVal : lhs + rhs;
+    }
+
+    const char* valueName(ProofValue value) {
+        switch(value) {
+            case ProofValue::win: return "win";
+            case ProofValue::loss: return "loss";
+            case ProofValue::draw: return "draw";
+            default: return "unknown";
+        }
+    }
+}
+
+DfpnSolver::DfpnSolver(std::size_t ttSizeMB, std::uint64_t nodeLimit) : nodeLimit(nodeLimit) {
+    // round the table down to a power of two number of buckets
+    std::size_t numEntries = BUCKET_SIZE;
+    while(numEntries*2*sizeof(TTEntry) <= ttSizeMB*1024*1024)
+        numEntries *= 2;
+    table.resize(numEntries);
+}
+
+DfpnResult DfpnSolver::solve(Omok& game) {
+    OmokPosition pos(game);
+    return solvePosition(pos);
+}
+
+DfpnResult DfpnSolver::solve(MNKBoard& board) {
+    MNKPosition pos(board);
+    return solvePosition(pos);
+}
+
+/**
+ * First asks whether the side to move wins. If it does not, the same question is
+ * asked for the opponent: a yes is a loss, a second no is a draw.
+ **/
+DfpnResult DfpnSolver::solvePosition(DfpnPosition& pos) {
+    nodes = 0;
+    limitReached = false;
+    proofs.clear();
+    boardRows = pos.numRows;
+    boardCols = pos.numCols;
+    boardWinSize = pos.winSize();
+    rootKey = pos.hashKey();
+    rootValue = ProofValue::unknown;
+
+    DfpnResult result;
+    const CellState mover = pos.sideToMove();
+    if(runSearch(pos, mover)) {
+        rootValue = ProofValue::win;
+    } else if(!limitReached) {
+        if(runSearch(pos, otherPlayer(mover))) {
+            // the first proof is not needed to show a loss
+            proofs.erase(proofs.begin());
+            rootValue = ProofValue::loss;
+        } else if(!limitReached) {
+            rootValue = ProofValue::draw;
+        }
+    }
+
+    if(limitReached) {
+        rootValue = ProofValue::unknown;
+        proofs.clear();
+    } else if(rootValue != ProofValue::loss && !proofs.empty()) {
+        // the side to move chooses at the root of the last proof
+        auto choiceIt = proofs.back().choices.find(rootKey);
+        if(choiceIt != proofs.back().choices.end())
+            result.bestMove = std::make_tuple(choiceIt->second / boardCols, choiceIt->second % boardCols);
+    }
+
+    result.value = rootValue;
+    result.nodes = nodes;
+    result.limitReached = limitReached;
+    return result;
+}
+
+bool DfpnSolver::runSearch(DfpnPosition& pos, CellState searchAttacker) {
+    std::fill(table.begin(), table.end(), TTEntry());
+    attacker = searchAttacker;
+
+    const std::uint64_t key = pos.hashKey();
+    mid(pos, key, INF_NUM, INF_NUM);
+    if(limitReached)
+        return false;
+
+    std::uint32_t phi, delta;
+    lookup(key, phi, delta);
+    const bool moverReachesGoal = phi == 0;
+    const bool attackerWins = moverReachesGoal == (pos.sideToMove() == attacker);
+
+    // keep the proof while the table still holds the search
+    Proof proof = {attacker, attackerWins, {}};
+    std::unordered_set<std::uint64_t> visited;
+    if(collectProof(pos, key, proof, visited))
+        proofs.push_back(std::move(proof));
+    return attackerWins;
+}
+
+/**
+ * Multiple iterative deepening: expands the most proving child until the proof or
+ * disproof number of the node reaches its threshold.
+ **/
+void DfpnSolver::mid(DfpnPosition& pos, std::uint64_t key, std::uint32_t thPhi, std::uint32_t thDelta) {
+    if(checkLimit())
+        return;
+
+    const std::uint64_t nodesBefore = nodes;
+    std::vector<int> moves;
+    bool attackerWins;
+    if(expandNode(pos, attacker, moves, attackerWins)) {
+        const bool moverWins = attackerWins == (pos.sideToMove() == attacker);
+        store(key, moverWins ? 0 : INF_NUM, moverWins ? INF_NUM : 0, 1);
+        return;
+    }
+
+    std::vector<std::uint64_t> childKeys(moves.size());
+    for(std::size_t moveInd=0; moveInd<moves.size(); moveInd++)
+        childKeys[moveInd] = pos.childKey(key, moves[moveInd]);
+
+    while(true) {
+        // phi is the smallest delta of the children and delta the sum of their phis
+        std::uint32_t phi = INF_NUM, secondDelta = INF_NUM, delta = 0, bestPhi = 0;
+        int bestInd = 0;
+        for(std::size_t moveInd=0; moveInd<moves.size(); moveInd++) {
+            std::uint32_t childPhi, childDelta;
+            lookup(childKeys[moveInd], childPhi, childDelta);
+            delta = saturatedAdd(delta, childPhi, INF_NUM);
+            if(childDelta < phi) {
+                secondDelta = phi;
+                phi = childDelta;
+                bestPhi = childPhi;
+                bestInd = moveInd;
+            } else if(childDelta < secondDelta) {
+                secondDelta = childDelta;
+            }
+        }
+
+        if(phi >= thPhi || delta >= thDelta || limitReached) {
+            store(key, phi, delta, nodes - nodesBefore + 1);
+            return;
+        }
+
+        // the child may grow until it is no longer the best one or the node reaches its thresholds
+        const std::uint32_t childThPhi = thDelta >= INF_NUM ? INF_NUM : thDelta - delta + bestPhi;
+        const std::uint32_t childThDelta = std::min(thPhi, saturatedAdd(secondDelta, 1, INF_NUM));
+        pos.makeMove(moves[bestInd]);
+        mid(pos, childKeys[bestInd], childThPhi, childThDelta);
+        pos.unmakeMove();
+    }
+}
+
+/**
+ * Nodes where the side to move reaches its goal only need one proven child (the
+ * recorded choice), all other nodes need every child to be proven.
+ **/
+bool DfpnSolver::collectProof(DfpnPosition& pos, std::uint64_t key, Proof& proof, std::unordered_set<std::uint64_t>& visited) {
+    if(visited.count(key))
+        return true;
+
+    std::vector<int> moves;
+    bool attackerWins;
+    if(expandNode(pos, attacker, moves, attackerWins))
+        return attackerWins == proof.attackerWins;
+
+    if((pos.sideToMove() == attacker) == proof.attackerWins) {
+        // a child whose side to move cannot reach its goal, preferring the ones still in the table
+        for(int pass=0; pass<2; pass++) {
+            for(int move : moves) {
+                const std::uint64_t childKey = pos.childKey(key, move);
+                std::uint32_t childPhi, childDelta;
+                if(pass == 0)
+                    lookup(childKey, childPhi, childDelta);
+                else
+                    resolveChild(pos, move, childKey, childPhi, childDelta);
+                if(limitReached)
+                    return false;
+                if(childDelta != 0)
+                    continue;
+
+                pos.makeMove(move);
+                const bool isProven = collectProof(pos, childKey, proof, visited);
+                pos.unmakeMove();
+                if(!isProven)
+                    return false;
+                proof.choices[key] = move;
+                visited.insert(key);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    for(int move : moves) {
+        const std::uint64_t childKey = pos.childKey(key, move);
+        std::uint32_t childPhi, childDelta;
+        resolveChild(pos, move, childKey, childPhi, childDelta);
+        if(limitReached || childPhi != 0)
+            return false;
+
+        pos.makeMove(move);
+        const bool isProven = collectProof(pos, childKey, proof, visited);
+        pos.unmakeMove();
+        if(!isProven)
+            return false;
+    }
+
+    visited.insert(key);
+    return true;
+}
+
+void DfpnSolver::resolveChild(DfpnPosition& pos, int move, std::uint64_t childKey, std::uint32_t& phi, std::uint32_t& delta) {
+    lookup(childKey, phi, delta);
+    if(phi != 0 && delta != 0) {
+        pos.makeMove(move);
+        mid(pos, childKey, INF_NUM, INF_NUM);
+        pos.unmakeMove();
+        lookup(childKey, phi, delta);
+    }
+}
+
+void DfpnSolver::lookup(std::uint64_t key, std::uint32_t& phi, std::uint32_t& delta) const {
+    const std::size_t bucketStart = key & (table.size() - BUCKET_SIZE);
+    for(int entryInd=0; entryInd<BUCKET_SIZE; entryInd++) {
+        const TTEntry& entry = table[bucketStart + entryInd];
+        if(entry.work && entry.key == key) {
+            phi = entry.phi;
+            delta = entry.delta;
+            return;
+        }
+    }
+
+    // unexplored nodes start out with unit numbers
+    phi = 1;
+    delta = 1;
+}
+
+/**
+ * Replaces the entry of the same position, or else the entry with the least work
+ * spent below it.
+ **/
+void DfpnSolver::store(std::uint64_t key, std::uint32_t phi, std::uint32_t delta, std::uint64_t work) {
+    const std::size_t bucketStart = key & (table.size() - BUCKET_SIZE);
+    TTEntry* replaceEntry = &table[bucketStart];
+    for(int entryInd=0; entryInd<BUCKET_SIZE; entryInd++) {
+        TTEntry& entry = table[bucketStart + entryInd];
+        if(entry.work && entry.key == key) {
+            replaceEntry = &entry;
+            work += entry.work;
+            break;
+        }
+        if(entry.work < replaceEntry->work)
+            replaceEntry = &entry;
+    }
+
+    *replaceEntry = {key, phi, delta, work};
+}
+
+bool DfpnSolver::checkLimit(void) {
+    if(++nodes > nodeLimit)
+        limitReached = true;
+    return limitReached;
+}
+
+/**
+ * File layout:
+ *  dfpn-proof
+ *  board <rows> <cols> <k>
+ *  root <key>
+ *  value <win|loss|draw>
+ *  proof <black|white> <wins|holds> <number of choices>   (one section per search)
+ *  <key> <row> <col>                                       (one line per choice)
+ **/
+bool DfpnSolver::saveProof(const std::string& filePath) const {
+    if(rootValue == ProofValue::unknown || proofs.empty())
+        return false;
+
+    std::ofstream proofFile(filePath);
+    if(!proofFile)
+        return false;
+
+    proofFile << "dfpn-proof\n";
+    proofFile << "board " << boardRows << " " << boardCols << " " << boardWinSize << "\n";
+    proofFile << "root " << std::hex << rootKey << std::dec << "\n";
+    proofFile << "value " << valueName(rootValue) << "\n";
+    for(const Proof& proof : proofs) {
+        proofFile << "proof " << (proof.attacker == CellState::black ? "black" : "white") << " "
+                  << (proof.attackerWins ? "wins" : "holds") << " " << proof.choices.size() << "\n";
+        for(auto& choice : proof.choices)
+            proofFile << std::hex << choice.first << std::dec << " "
+                      << choice.second / boardCols << " " << choice.second % boardCols << "\n";
+    }
+    return static_cast<bool>(proofFile);
+}
+
+ProofValue DfpnSolver::checkProofFile(Omok& game, const std::string& filePath) {
+    OmokPosition pos(game);
+    return checkProof(pos, filePath);
+}
+
+ProofValue DfpnSolver::checkProofFile(MNKBoard& board, const std::string& filePath) {
+    MNKPosition pos(board);
+    return checkProof(pos, filePath);
+}
+
+ProofValue DfpnSolver::checkProof(DfpnPosition& pos, const std::string& filePath) {
+    std::ifstream proofFile(filePath);
+    std::string token, valueStr;
+    int numRows, numCols, winSize;
+    std::uint64_t fileKey;
+    if(!(proofFile >> token) || token != "dfpn-proof")
+        return ProofValue::unknown;
+    if(!(proofFile >> token >> numRows >> numCols >> winSize) || token != "board")
+        return ProofValue::unknown;
+    if(!(proofFile >> token >> std::hex >> fileKey >> std::dec) || token != "root")
+        return ProofValue::unknown;
+    if(!(proofFile >> token >> valueStr) || token != "value")
+        return ProofValue::unknown;
+
+    const std::uint64_t key = pos.hashKey();
+    if(numRows != pos.numRows || numCols != pos.numCols || winSize != pos.winSize() || fileKey != key)
+        return ProofValue::unknown;
+
+    // every proof in the file has to replay against the position
+    const CellState mover = pos.sideToMove();
+    bool moverWins = false, opponentWins = false, moverHolds = false, opponentHolds = false;
+    std::string attackerStr, outcomeStr;
+    std::size_t numChoices;
+    while(proofFile >> token >> attackerStr >> outcomeStr >> numChoices) {
+        if(token != "proof")
+            return ProofValue::unknown;
+
+        Proof proof = {attackerStr == "black" ? CellState::black : CellState::white, outcomeStr == "wins", {}};
+        for(std::size_t choiceInd=0; choiceInd<numChoices; choiceInd++) {
+            std::uint64_t choiceKey;
+            int row, col;
+            if(!(proofFile >> std::hex >> choiceKey >> std::dec >> row >> col))
+                return ProofValue::unknown;
+            proof.choices[choiceKey] = row*numCols + col;
+        }
+
+        std::unordered_set<std::uint64_t> verified;
+        if(!verifyNode(pos, key, proof, verified))
+            return ProofValue::unknown;
+
+        const bool isMover = proof.attacker == mover;
+        moverWins |= isMover && proof.attackerWins;
+        opponentWins |= !isMover && proof.attackerWins;
+        moverHolds |= !isMover && !proof.attackerWins;
+        opponentHolds |= isMover && !proof.attackerWins;
+    }
+
+    if(valueStr == "win" && moverWins)
+        return ProofValue::win;
+    if(valueStr == "loss" && opponentWins)
+        return ProofValue::loss;
+    if(valueStr == "draw" && moverHolds && opponentHolds)
+        return ProofValue::draw;
+    return ProofValue::unknown;
+}
+
+bool DfpnSolver::verifyNode(DfpnPosition& pos, std::uint64_t key, const Proof& proof, std::unordered_set<std::uint64_t>& verified) {
+    if(verified.count(key))
+        return true;
+
+    std::vector<int> moves;
+    bool attackerWins;
+    if(expandNode(pos, proof.attacker, moves, attackerWins))
+        return attackerWins == proof.attackerWins;
+
+    if((pos.sideToMove() == proof.attacker) == proof.attackerWins) {
+        // the proving side plays its recorded choice, which has to be one of the moves
+        auto choiceIt = proof.choices.find(key);
+        if(choiceIt == proof.choices.end() || std::find(moves.begin(), moves.end(), choiceIt->second) == moves.end())
+            return false;
+        moves.assign(1, choiceIt->second);
+    }
+
+    for(int move : moves) {
+        const std::uint64_t childKey = pos.childKey(key, move);
+        if(!pos.makeMove(move))
+            return false;
+        const bool isProven = verifyNode(pos, childKey, proof, verified);
+        pos.unmakeMove();
+        if(!isProven)
+            return false;
+    }
+
+    verified.insert(key);
+    return true;
+}
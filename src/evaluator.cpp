@@ -0,0 +1,184 @@
+#include "../include/evaluator.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <stdexcept>
+
+ReferenceBackend::ReferenceBackend(int numRows, int numCols, std::uint64_t seed) : numCells(numRows*numCols) {
+    const int numInputs = BatchEvaluator::NUM_PLANES*numCells;
+    std::mt19937_64 randGen(seed);
+    std::uniform_real_distribution<float> weightDist(-1.0f, 1.0f);
+    const float scale = 1.0f / std::sqrt(float(numInputs));
+
+    policyWeights.resize(std::size_t(numInputs)*numCells);
+    for(float& weight : policyWeights)
+        weight = weightDist(randGen)*scale;
+    valueWeights.resize(numInputs);
+    for(float& weight : valueWeights)
+        weight = weightDist(randGen)*scale;
+}
+
+/**
+ * Multiplies the whole batch with the weight matrix at once. The input index runs in the
+ * middle loop so that every weight row is streamed once per position and the inner loop
+ * walks both the row and the output contiguously. Occupied cells get a very low logit.
+ **/
+void ReferenceBackend::evaluate(const float* inputs, int batchSize, int numRows, int numCols,
+                                float* values, float* policies) {
+    if(numRows*numCols != numCells)
+        throw std::invalid_argument("Backend and batch disagree on the board size.");
+    const int numInputs = BatchEvaluator::NUM_PLANES*numCells;
+
+    std::fill(policies, policies + std::size_t(batchSize)*numCells, 0.0f);
+    for(int posInd=0; posInd<batchSize; posInd++) {
+        const float* input = inputs + std::size_t(posInd)*numInputs;
+        float* policy = policies + std::size_t(posInd)*numCells;
+        float valueSum = 0;
+        for(int inputInd=0; inputInd<numInputs; inputInd++) {
+            const float activation = input[inputInd];
+            if(activation == 0)
+                continue;
+            valueSum += activation*valueWeights[inputInd];
+            const float* weightRow = policyWeights.data() + std::size_t(inputInd)*numCells;
+            for(int cellInd=0; cellInd<numCells; cellInd++)
+                policy[cellInd] += activation*weightRow[cellInd];
+        }
+        values[posInd] = std::tanh(valueSum);
+
+        // mask out cells that are already taken
+        for(int cellInd=0; cellInd<numCells; cellInd++)
+            if(input[cellInd] != 0 || input[numCells + cellInd] != 0)
+                policy[cellInd] = -1e9f;
+    }
+}
+
+BatchEvaluator::BatchEvaluator(EvalBackend& backend, int batchSize, int numRows, int numCols, int maxWaitUs) :
+                               backend(backend), batchSize(batchSize), numRows(numRows), numCols(numCols),
+                               inputSize(NUM_PLANES*numRows*numCols), maxWaitUs(maxWaitUs) {
+    if(batchSize < 1)
+        throw std::invalid_argument("Batches must hold at least one position.");
+    currentBatch = makeBatch();
+}
+
+std::shared_ptr<BatchEvaluator::Batch> BatchEvaluator::makeBatch(void) const {
+    std::shared_ptr<Batch> batch = std::make_shared<Batch>();
+    batch->inputs.resize(std::size_t(batchSize)*inputSize);
+    batch->values.resize(batchSize);
+    batch->policies.resize(std::size_t(batchSize)*numRows*numCols);
+    return batch;
+}
+
+void BatchEvaluator::copyOutput(const Batch& batch, int slot, EvalOutput& output) const {
+    const int numCells = numRows*numCols;
+    output.value = batch.values[slot];
+    output.policy.assign(batch.policies.begin() + std::size_t(slot)*numCells,
+                         batch.policies.begin() + std::size_t(slot + 1)*numCells);
+}
+
+/**
+ * Claims a slot of the batch being filled, encodes the position into it outside of the
+ * lock and waits for the batch. The thread that completes a full batch evaluates it; a
+ * partial batch is closed and evaluated by the first of its threads whose wait expired.
+ **/
+void BatchEvaluator::evaluate(Omok& game, EvalOutput& output) {
+    std::unique_lock<std::mutex> lock(batchLock);
+    const std::shared_ptr<Batch> batch = currentBatch;
+    const int slot = batch->numClaimed++;
+    if(batch->numClaimed == batchSize)
+        currentBatch = makeBatch();
+    lock.unlock();
+
+    encodePosition(game, batch->inputs.data() + std::size_t(slot)*inputSize);
+
+    lock.lock();
+    batch->numWritten++;
+    batchDone.notify_all();
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::microseconds(maxWaitUs);
+    while(!batch->isEvaluated) {
+        const bool isComplete = batch->numWritten == batch->numClaimed;
+        const bool isFull = batch->numClaimed == batchSize;
+        const bool isExpired = std::chrono::steady_clock::now() >= deadline;
+        if(!batch->isRunning && isComplete && (isFull || isExpired)) {
+            // no more positions may join a batch that is being evaluated
+            if(currentBatch == batch)
+                currentBatch = makeBatch();
+            batch->isRunning = true;
+            const int numFilled = batch->numClaimed;
+            lock.unlock();
+            backend.evaluate(batch->inputs.data(), numFilled, numRows, numCols,
+                             batch->values.data(), batch->policies.data());
+            lock.lock();
+            batch->isEvaluated = true;
+            numPositions += numFilled;
+            numBatches++;
+            batchDone.notify_all();
+            break;
+        }
+
+        if(isExpired || batch->isRunning)
+            batchDone.wait(lock);
+        else
+            batchDone.wait_until(lock, deadline);
+    }
+    lock.unlock();
+
+    copyOutput(*batch, slot, output);
+}
+
+/**
+ * Single caller version: the positions are already gathered, so batches are filled
+ * straight away without any waiting.
+ **/
+void BatchEvaluator::evaluateMany(Omok* const* games, int numGames, EvalOutput* outputs) {
+    std::shared_ptr<Batch> batch = makeBatch();
+    for(int firstInd=0; firstInd<numGames; firstInd+=batchSize) {
+        const int numFilled = std::min(batchSize, numGames - firstInd);
+        for(int slot=0; slot<numFilled; slot++)
+            encodePosition(*games[firstInd + slot], batch->inputs.data() + std::size_t(slot)*inputSize);
+        backend.evaluate(batch->inputs.data(), numFilled, numRows, numCols,
+                         batch->values.data(), batch->policies.data());
+        for(int slot=0; slot<numFilled; slot++)
+            copyOutput(*batch, slot, outputs[firstInd + slot]);
+
+        std::lock_guard<std::mutex> guard(batchLock);
+        numPositions += numFilled;
+        numBatches++;
+    }
+}
+
+/**
+ * Writes the feature planes of a position for the side to move. The forbidden plane
+ * marks the empty cells where the side to move would form a double three.
+ **/
+void BatchEvaluator::encodePosition(Omok& game, float* planes) {
+    const auto [numRows, numCols] = game.getBoardSize();
+    const int numCells = numRows*numCols;
+    const CellState ownPlayer = game.getCurrentPlayer();
+    const float sideValue = ownPlayer == CellState::black ? 1.0f : 0.0f;
+
+    float* ownPlane = planes;
+    float* oppPlane = planes + numCells;
+    float* sidePlane = planes + 2*numCells;
+    float* forbiddenPlane = planes + 3*numCells;
+    for(int rowInd=0; rowInd<numRows; rowInd++) {
+        for(int colInd=0; colInd<numCols; colInd++) {
+            const int cellInd = rowInd*numCols + colInd;
+            const CellState cell = game.getCell(rowInd, colInd);
+            ownPlane[cellInd] = cell != CellState::none && cell == ownPlayer ? 1.0f : 0.0f;
+            oppPlane[cellInd] = cell != CellState::none && cell != ownPlayer ? 1.0f : 0.0f;
+            sidePlane[cellInd] = sideValue;
+            forbiddenPlane[cellInd] = cell == CellState::none && game.isForbidden(rowInd, colInd) ? 1.0f : 0.0f;
+        }
+    }
+}
+
+std::uint64_t BatchEvaluator::getNumPositions(void) const {
+    std::lock_guard<std::mutex> guard(batchLock);
+    return numPositions;
+}
+
+std::uint64_t BatchEvaluator::getNumBatches(void) const {
+    std::lock_guard<std::mutex> guard(batchLock);
+    return numBatches;
+}
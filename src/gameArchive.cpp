@@ -0,0 +1,257 @@
+#include "../include/gameArchive.h"
+#include "../include/psqReader.h"
+#include <cstring>
+
+namespace {
+    const char MAGIC[4] = {'G', 'A', 'R', 'C'};
+    const std::size_t HEADER_SIZE = 32;
+    const std::uint8_t NO_RESULT = 0xFF;
+    const int PSQ_BOARD_SIZE = 15;     // size of an archive converted from no readable record
+
+    void putFixed(char* outBytes, std::uint64_t value, int numBytes) {
+        for(int byteInd=0; byteInd<numBytes; byteInd++)
+            outBytes[byteInd] = static_cast<char>(value >> (8*byteInd));
+    }
+
+    std::uint64_t getFixed(const char* inBytes, int numBytes) {
+        std::uint64_t value = 0;
+        for(int byteInd=0; byteInd<numBytes; byteInd++)
+            value |= std::uint64_t(static_cast<unsigned char>(inBytes[byteInd])) << (8*byteInd);
+        return value;
+    }
+
+    void putVarint(std::vector<char>& outBytes, std::uint64_t value) {
+        while(value >= 0x80) {
+            outBytes.push_back(static_cast<char>(value | 0x80));
+            value >>= 7;
+        }
+        outBytes.push_back(static_cast<char>(value));
+    }
+
+    // false if the varint runs past the end or does not fit in 64 bits
+    bool getVarint(const char*& curPos, const char* endPos, std::uint64_t& value) {
+        value = 0;
+        for(int shiftVal=0; curPos<endPos && shiftVal<64; shiftVal+=7) {
+            const unsigned char curByte = static_cast<unsigned char>(*curPos++);
+            value |= std::uint64_t(curByte & 0x7F) << shiftVal;
+            if(!(curByte & 0x80))
+                return true;
+        }
+        return false;
+    }
+
+    // moves take one byte each when every cell index fits in one
+    inline bool byteCells(int rows, int cols) {
+        return rows*cols <= 256;
+    }
+}
+
+GameArchiveWriter::GameArchiveWriter(const std::string& filePath, int rows, int cols, std::uint32_t flags)
+    : numRows(rows), numCols(cols), flags(flags) {
+    // checked before opening, so a bad size leaves an existing file untouched
+    if(rows <= 0 || cols <= 0 || rows > MNKBoard::MAX_DIM || cols > MNKBoard::MAX_DIM) {
+        archiveFile.setstate(std::ios::failbit);
+        return;
+    }
+    archiveFile.open(filePath, std::ios::binary);
+
+    // the header is written by finish, once the index is known
+    const char emptyHeader[HEADER_SIZE] = {};
+    archiveFile.write(emptyHeader, HEADER_SIZE);
+    offsets.push_back(HEADER_SIZE);
+}
+
+bool GameArchiveWriter::isOpen(void) const {
+    return static_cast<bool>(archiveFile) && !isFinished;
+}
+
+bool GameArchiveWriter::addGame(const ArchiveGame& game) {
+    if(!isOpen())
+        return false;
+
+    recordBuffer.clear();
+    putVarint(recordBuffer, game.moves.size());
+    for(const std::tuple<int, int>& move : game.moves) {
+        const int row = std::get<0>(move), col = std::get<1>(move);
+        if(row < 0 || row >= numRows || col < 0 || col >= numCols)
+            return false;
+        if(byteCells(numRows, numCols))
+            recordBuffer.push_back(static_cast<char>(row*numCols + col));
+        else
+            putVarint(recordBuffer, row*numCols + col);
+    }
+
+    if(flags & GameArchive::METADATA) {
+        recordBuffer.push_back(static_cast<char>(game.result >= 0 ? game.result : NO_RESULT));
+        recordBuffer.push_back(static_cast<char>(game.ruleSet));
+        putVarint(recordBuffer, game.times.size());
+        for(int moveTime : game.times)
+            putVarint(recordBuffer, static_cast<std::uint32_t>(moveTime));
+    }
+
+    archiveFile.write(recordBuffer.data(), recordBuffer.size());
+    offsets.push_back(offsets.back() + recordBuffer.size());
+    return static_cast<bool>(archiveFile);
+}
+
+bool GameArchiveWriter::finish(void) {
+    if(!isOpen())
+        return false;
+    isFinished = true;
+
+    char fieldBytes[8];
+    for(std::uint64_t offset : offsets) {
+        putFixed(fieldBytes, offset, 8);
+        archiveFile.write(fieldBytes, 8);
+    }
+
+    char header[HEADER_SIZE];
+    std::memcpy(header, MAGIC, 4);
+    putFixed(header + 4, GameArchive::VERSION, 4);
+    putFixed(header + 8, numRows, 4);
+    putFixed(header + 12, numCols, 4);
+    putFixed(header + 16, flags, 4);
+    putFixed(header + 20, offsets.size() - 1, 4);
+    putFixed(header + 24, offsets.back(), 8);
+    archiveFile.seekp(0);
+    archiveFile.write(header, HEADER_SIZE);
+    archiveFile.close();
+    return !archiveFile.fail();
+}
+
+GameArchive::GameArchive(const std::string& filePath) : archiveFile(filePath) {
+    const char* fileData = archiveFile.data();
+    const std::size_t fileSize = archiveFile.size();
+    if(!archiveFile.isOpen() || fileSize < HEADER_SIZE || std::memcmp(fileData, MAGIC, 4) != 0
+       || getFixed(fileData + 4, 4) != VERSION)
+        return;
+
+    numRows = getFixed(fileData + 8, 4);
+    numCols = getFixed(fileData + 12, 4);
+    flags = getFixed(fileData + 16, 4);
+    numGames = getFixed(fileData + 20, 4);
+    const std::uint64_t indexOffset = getFixed(fileData + 24, 8);
+    isValid = numRows > 0 && numRows <= MNKBoard::MAX_DIM && numCols > 0 && numCols <= MNKBoard::MAX_DIM
+              && indexOffset >= HEADER_SIZE && indexOffset <= fileSize
+              && (fileSize - indexOffset) / 8 >= numGames + 1;
+    if(isValid)
+        indexData = fileData + indexOffset;
+}
+
+bool GameArchive::isOpen(void) const {
+    return isValid;
+}
+
+std::size_t GameArchive::size(void) const {
+    return numGames;
+}
+
+int GameArchive::getRows(void) const {
+    return numRows;
+}
+
+int GameArchive::getCols(void) const {
+    return numCols;
+}
+
+bool GameArchive::hasMetadata(void) const {
+    return flags & METADATA;
+}
+
+bool GameArchive::getGame(std::size_t gameInd, ArchiveGame& game) const {
+    if(!isValid || gameInd >= numGames)
+        return false;
+    const std::uint64_t startOffset = getFixed(indexData + 8*gameInd, 8);
+    const std::uint64_t endOffset = getFixed(indexData + 8*(gameInd+1), 8);
+    if(startOffset < HEADER_SIZE || startOffset > endOffset || endOffset > std::uint64_t(indexData - archiveFile.data()))
+        return false;
+
+    const char* curPos = archiveFile.data() + startOffset;
+    const char* endPos = archiveFile.data() + endOffset;
+    const std::uint64_t numCells = std::uint64_t(numRows) * numCols;
+    std::uint64_t numMoves, cellInd;
+    if(!getVarint(curPos, endPos, numMoves) || numMoves > std::uint64_t(endPos - curPos))
+        return false;
+
+    game.moves.clear();
+    for(std::uint64_t moveInd=0; moveInd<numMoves; moveInd++) {
+        if(byteCells(numRows, numCols)) {
+            if(curPos >= endPos)
+                return false;
+            cellInd = static_cast<unsigned char>(*curPos++);
+        }
+        else if(!getVarint(curPos, endPos, cellInd))
+            return false;
+        if(cellInd >= numCells)
+            return false;
+        game.moves.emplace_back(cellInd / numCols, cellInd % numCols);
+    }
+
+    game.result = -1;
+    game.ruleSet = Omok::RuleSet::omok;
+    game.times.clear();
+    if(!hasMetadata())
+        return curPos == endPos;
+
+    std::uint64_t numTimes, moveTime;
+    if(endPos - curPos < 2)
+        return false;
+    const std::uint8_t result = static_cast<std::uint8_t>(*curPos++);
+    game.result = result == NO_RESULT ? -1 : result;
+    const std::uint8_t ruleSet = static_cast<std::uint8_t>(*curPos++);
+    if(ruleSet > static_cast<std::uint8_t>(Omok::RuleSet::standard))
+        return false;
+    game.ruleSet = static_cast<Omok::RuleSet>(ruleSet);
+    if(!getVarint(curPos, endPos, numTimes) || numTimes > std::uint64_t(endPos - curPos))
+        return false;
+    for(std::uint64_t timeInd=0; timeInd<numTimes; timeInd++) {
+        if(!getVarint(curPos, endPos, moveTime))
+            return false;
+        game.times.push_back(static_cast<int>(static_cast<std::uint32_t>(moveTime)));
+    }
+    return curPos == endPos;
+}
+
+long GameArchive::convertPsq(const std::vector<std::string>& psqPaths, const std::string& archivePath,
+                             Omok::RuleSet ruleSet) {
+    // the board size is that of the first readable record; records of other sizes are skipped
+    int archiveRows = 0, archiveCols = 0, width, height;
+    for(const std::string& psqPath : psqPaths) {
+        const MappedFile psqFile(psqPath);
+        PsqScanner scanner(psqFile.data(), psqFile.data() + psqFile.size());
+        if(psqFile.isOpen() && scanner.readHeader(width, height)
+           && width > 0 && width <= MNKBoard::MAX_DIM && height > 0 && height <= MNKBoard::MAX_DIM) {
+            archiveRows = width;
+            archiveCols = height;
+            break;
+        }
+    }
+
+    GameArchiveWriter writer(archivePath, archiveRows > 0 ? archiveRows : PSQ_BOARD_SIZE,
+                             archiveCols > 0 ? archiveCols : PSQ_BOARD_SIZE, METADATA);
+    if(!writer.isOpen())
+        return -1;
+
+    long numWritten = 0;
+    ArchiveGame game;
+    game.ruleSet = ruleSet;
+    PsqMove move;
+    for(const std::string& psqPath : psqPaths) {
+        const MappedFile psqFile(psqPath);
+        PsqScanner scanner(psqFile.data(), psqFile.data() + psqFile.size());
+        if(!psqFile.isOpen() || !scanner.readHeader(width, height) || width != archiveRows || height != archiveCols)
+            continue;
+
+        // Piskvork coordinates are 1-based, x being the row as in PsqReplayer
+        game.moves.clear();
+        game.times.clear();
+        game.result = PsqReplayer::expectedWinner(psqPath);
+        while(scanner.nextMove(move)) {
+            game.moves.emplace_back(move.x-1, move.y-1);
+            game.times.push_back(move.time);
+        }
+        // addGame rejects moves off the board, which skips the record
+        numWritten += writer.addGame(game);
+    }
+    return writer.finish() ? numWritten : -1;
+}
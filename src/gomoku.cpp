@@ -1,42 +1,99 @@
+#include <algorithm>
 #include <iostream>
 #include <utility>
 #include <tuple>
 #include <vector>
-#include <unordered_map>
 #include "gomoku.h"
+#include "renjuRules.h"
 
 // initializes an omok game based on an mnk game
-Omok::Omok():MNKBoard(BOARD_SIZE, BOARD_SIZE, KSIZE), curPlayer(CellState::black) {}
+Omok::Omok(RuleSet ruleSet, BoardArena* arena):MNKBoard(BOARD_SIZE, BOARD_SIZE, KSIZE, arena), curPlayer(CellState::black),
+                                               flagStorage(BOARD_SIZE*BOARD_SIZE*sizeof(GameFlags), arena),
+                                               flagStack(static_cast<GameFlags*>(flagStorage.data())),
+                                               ruleSet(ruleSet), threats(BOARD_SIZE, BOARD_SIZE, arena) {
+    threats.reset(*this);
+}
+
+Omok::Omok(const Omok& otherGame, BoardArena* arena):MNKBoard(otherGame, arena),
+                                                     flagStorage(BOARD_SIZE*BOARD_SIZE*sizeof(GameFlags), arena),
+                                                     flagStack(static_cast<GameFlags*>(flagStorage.data())),
+                                                     threats(otherGame.threats, arena) {
+    copyGameState(otherGame);
+}
+
+Omok& Omok::operator=(const Omok& otherGame) {
+    if(this == &otherGame)
+        return *this;
+    MNKBoard::operator=(otherGame);
+    if(!flagStorage.data()) {
+        flagStorage = ArenaBlock(BOARD_SIZE*BOARD_SIZE*sizeof(GameFlags), flagStorage.getArena());
+        flagStack = static_cast<GameFlags*>(flagStorage.data());
+    }
+    copyGameState(otherGame);
+    threats = otherGame.threats;
+    return *this;
+}
+
+// the board and the threat cache are copied by their own classes
+void Omok::copyGameState(const Omok& otherGame) {
+    std::copy(otherGame.flagStack, otherGame.flagStack + otherGame.moveCount, flagStack);
+    curPlayer = otherGame.curPlayer;
+    gameFinished = otherGame.gameFinished;
+    gameStarted = otherGame.gameStarted;
+    ruleSet = otherGame.ruleSet;
+}
 
 // overloads placePiece for the current game format
 bool Omok::placePiece(int row, int col) {
+    return makeMove(row, col);
+}
+
+// places a piece following the game rules while recording the move for unmakeMove
+bool Omok::makeMove(int row, int col) {
     // make sure you can place a pice in the first place
     if(!isPosEmpty(row, col) || isFinished())
         return false;
 
     // check rules for potential placement of piece
-    bool d3Present;
-    if(gameStarted) {
-        d3Present = isDoubleThree(row, col);
-    } else {
-        gameStarted = true;
-        d3Present = false;
-    }
+    const bool isIllegal = isForbidden(row, col);
+    const bool wasStarted = gameStarted;
+    gameStarted = true;
 
     // place piece and toggle player for next move if possible
-    if(!d3Present) {
-        MNKBoard::placePiece(row, col, curPlayer);
+    if(!isIllegal) {
+        flagStack[moveCount] = {curPlayer, gameFinished, wasStarted};
+        MNKBoard::makeMove(row, col, curPlayer);
+        threats.update(*this, row, col);
 
         // check for win condition following the piece placement
         checkWin();
 
-        // if the win has yet to occur, then swap the player state
-        if(!gameFinished)
+        // if the win has yet to occur, then swap the player state (and the side in the hash key)
+        if(!gameFinished) {
             curPlayer = curPlayer==CellState::black ? CellState::white : CellState::black;
+            hashKey ^= zobristSideKey();
+        }
     }
 
     // return True if a piece was placed or false otherwise
-    return !d3Present;
+    return !isIllegal;
+}
+
+// takes back the last recorded move along with the game state before it
+bool Omok::unmakeMove(void) {
+    if(moveCount == 0)
+        return false;
+    const auto [row, col] = getMove(moveCount-1);
+    MNKBoard::unmakeMove();
+    threats.update(*this, row, col);
+
+    const GameFlags& flags = flagStack[moveCount];
+    if(curPlayer != flags.curPlayer)
+        hashKey ^= zobristSideKey();
+    curPlayer = flags.curPlayer;
+    gameFinished = flags.gameFinished;
+    gameStarted = flags.gameStarted;
+    return true;
 }
 
 // reports the winner based on the value of the player
@@ -53,98 +110,118 @@ void Omok::clearBoard(void) {
     gameFinished = false;
     gameStarted = false;
     curPlayer = CellState::black;
+    threats.reset(*this);
 }
 
-// checks to see if the current move produces a 3n3 sequence
-bool Omok::isDoubleThree(int row, int col) {
-    // Hypothetically place the move without restriction
-    MNKBoard::placePiece(row, col, curPlayer, false);
-
-    // Now extract the four directions of moves and analyze them. Remember that
-    // given a point we check four spaces behind and in front of it to determine
-    // it's state as a potential "open three"
-    auto relRowSec = getRowVec(row);
-    bool rowO3 = openThreeCheck(std::vector<CellState>(relRowSec.begin()+std::max(0,row-4),
-                                    relRowSec.begin()+std::min(BOARD_SIZE-1, row+4)));
-    auto relColSec = getColVec(col);
-    bool colO3 = openThreeCheck(std::vector<CellState>(relColSec.begin()+std::max(0,col-4),
-                                    relColSec.begin()+std::min(BOARD_SIZE-1, col+4)));
-    
-    // diagonals require a bit more work to extract or desired portions as they aren't stored
-    // in bitmap arrays to make this easier
-    auto relFSDSec = getForwardDiagVec(row, col, 4);
-    auto relBSDSec = getBackDiagVec(row, col, 4);
-    bool FSDO3 = openThreeCheck(relFSDSec);
-    bool BSDO3 = openThreeCheck(relBSDSec);
-    
-    // remove the piece after analysis
-    MNKBoard::removePiece(row, col);
-
-    return ((rowO3?1:0) + (colO3?1:0) + (FSDO3?1:0) + (BSDO3?1:0)) >= 2;
-}
-
-// checks to see if one of the combinations is a open 3 sequence
-bool Omok::openThreeCheck(const std::vector<CellState>& pieceArr) {
-    // trivially false if array not big enough to match sequence
-    if(pieceArr.size() < O3CondsContainer::SIZE)
+bool Omok::setPosition(const std::vector<std::tuple<int, int>>& blackStones,
+                       const std::vector<std::tuple<int, int>>& whiteStones) {
+    clearBoard();
+    if(blackStones.size() != whiteStones.size() && blackStones.size() != whiteStones.size() + 1)
         return false;
 
-    // pass through the current array and comb for possible sequences
-    for(int indOff=0; indOff <= pieceArr.size() - O3CondsContainer::SIZE; indOff++) {
-        // possible o3 sequences
-        std::vector<std::vector<CellState>> o3PossConds = {O3CondsContainer::o3Cond1(curPlayer), O3CondsContainer::o3Cond2(curPlayer), 
-                                                            O3CondsContainer::o3Cond3(curPlayer), O3CondsContainer::o3Cond4(curPlayer)};
-        
-        // proceed with checking + offset manipulation
-        int arrInd = 0;
-        while(!o3PossConds.empty() && arrInd < O3CondsContainer::SIZE) {
-            for(auto o3it=o3PossConds.begin(); o3it != o3PossConds.end();) {
-                // if not equal, remove from possible sequence to limit the future checks
-                if((*o3it)[arrInd] != pieceArr[arrInd + indOff])
-                    o3it = o3PossConds.erase(o3it);
-                else
-                    ++o3it;
-            }
+    const std::vector<std::tuple<int, int>>* stones[2] = {&blackStones, &whiteStones};
+    const int numStones = static_cast<int>(blackStones.size() + whiteStones.size());
+    for(int stoneInd=0; stoneInd<numStones; stoneInd++) {
+        const auto [row, col] = (*stones[stoneInd % 2])[stoneInd / 2];
+        flagStack[moveCount] = {curPlayer, false, gameStarted};
+        if(!MNKBoard::makeMove(row, col, curPlayer)) {
+            clearBoard();
+            return false;
+        }
+        gameStarted = true;
+        curPlayer = curPlayer==CellState::black ? CellState::white : CellState::black;
+        hashKey ^= zobristSideKey();
+    }
+    threats.reset(*this);
 
-            // increase index of array being checked
-            arrInd++;
+    // a game with a winning line on the board is over already
+    for(int stoneInd=0; stoneInd<numStones; stoneInd++) {
+        const auto [row, col] = getMove(stoneInd);
+        for(int dirInd=0; dirInd<NUM_DIRS; dirInd++) {
+            if(isWinningPattern(ruleSet, getLinePattern(row, col, getCell(row, col), static_cast<PieceDirection>(dirInd)))) {
+                clearBoard();
+                return false;
+            }
         }
+    }
+    return true;
+}
 
-        // if o3PossConds not empty, then a match has been found
-        // otherwise continue the search with additional offset
-        if(!o3PossConds.empty())
-            return true;
+// checks to see if the current move produces a 3n3 sequence
+bool Omok::isDoubleThree(int row, int col) {
+    int numO3 = 0;
+    for(int dirInd=0; dirInd<NUM_DIRS; dirInd++)
+        if(openThreeGaps(row, col, curPlayer, static_cast<PieceDirection>(dirInd)))
+            numO3++;
+
+    return numO3 >= 2;
+}
+
+bool Omok::isForbidden(int row, int col) {
+    if(!gameStarted || !hasForbiddenMoves(ruleSet))
+        return false;
+    if(ruleSet == RuleSet::renju && curPlayer == CellState::black) {
+        RenjuBoard renjuBoard{*this};
+        return RenjuRules::isForbidden(renjuBoard, row, col);
     }
+    return isDoubleThree(row, col);
+}
 
-    return false;
+int Omok::getForbiddenPoints(int* cells) {
+    int numPoints = 0;
+    for(int rowInd=0; gameStarted && rowInd<BOARD_SIZE; rowInd++)
+        for(int colInd=0; colInd<BOARD_SIZE; colInd++)
+            if(isPosEmpty(rowInd, colInd) && isForbidden(rowInd, colInd))
+                cells[numPoints++] = rowInd*BOARD_SIZE + colInd;
+    return numPoints;
 }
 
-/**
- * Caches results from the o3Cond func in order to prevent constant creation of the elements for any given player
- **/
-std::vector<CellState>& Omok::O3CondsContainer::o3Cond1(CellState& player) {
-    if(!O3CondsContainer::cacheMap1.count(player))
-        O3CondsContainer::cacheMap1[player] = {CellState::none, CellState::none, player, 
-                                              player, player, CellState::none};
-    return O3CondsContainer::cacheMap1[player];
-}
-std::vector<CellState>& Omok::O3CondsContainer::o3Cond2(CellState& player) {
-    if(!O3CondsContainer::cacheMap2.count(player))
-        O3CondsContainer::cacheMap2[player] = {CellState::none, player, player, 
-                                                player, CellState::none, CellState::none};
-    return O3CondsContainer::cacheMap2[player];
-}
-std::vector<CellState>& Omok::O3CondsContainer::o3Cond3(CellState& player) {
-    if(!O3CondsContainer::cacheMap3.count(player))
-        O3CondsContainer::cacheMap3[player] = {CellState::none, player, CellState::none, 
-                                               player, player, CellState::none};
-    return O3CondsContainer::cacheMap3[player];
-}
-std::vector<CellState>& Omok::O3CondsContainer::o3Cond4(CellState& player) {
-    if(!O3CondsContainer::cacheMap4.count(player))
-        O3CondsContainer::cacheMap4[player] = {CellState::none, player, player, 
-                                               CellState::none, player, CellState::none};
-    return O3CondsContainer::cacheMap4[player];
+Omok::RuleSet Omok::getRuleSet(void) const {
+    return ruleSet;
+}
+
+bool Omok::hasForbiddenMoves(RuleSet ruleSet) {
+    return ruleSet == RuleSet::omok || ruleSet == RuleSet::renju;
+}
+
+bool Omok::overlineWins(RuleSet ruleSet) {
+    return ruleSet == RuleSet::freestyle;
+}
+
+bool Omok::isWinningPattern(RuleSet ruleSet, LinePatterns::Pattern pattern) {
+    return pattern == LinePatterns::Pattern::five || (pattern == LinePatterns::Pattern::overline && overlineWins(ruleSet));
+}
+
+const ThreatCache& Omok::getThreats(void) const {
+    return threats;
+}
+
+int Omok::RenjuBoard::patternIndex(int row, int col, PieceDirection dir, int depth) const {
+    return depth == 0 ? game.threats.getPatternIndex(CellState::black, dir, row, col)
+                      : game.patternIndex(row, col, CellState::black, dir);
+}
+
+void Omok::RenjuBoard::placeBlack(int row, int col) {
+    game.MNKBoard::makeMove(row, col, CellState::black);
+}
+
+void Omok::RenjuBoard::removeBlack(int, int) {
+    game.MNKBoard::unmakeMove();
+}
+
+// finds the open threes a hypothetical move would form along one direction
+MNKBoard::LineBits Omok::openThreeGaps(int row, int col, CellState player, PieceDirection dir) {
+    return LinePatterns::threeGaps(threats.getPatternIndex(player, dir, row, col), bitIndex(dir, row, col));
+}
+
+LinePatterns::Pattern Omok::getLinePattern(int row, int col, CellState player, PieceDirection dir) const {
+    return LinePatterns::getPattern(threats.getPatternIndex(player, dir, row, col));
+}
+
+// the window of the line through the cell, read with the cell holding a piece of the player
+int Omok::patternIndex(int row, int col, CellState player, PieceDirection dir) const {
+    return LinePatterns::windowIndex(getLineBits(player, dir, row, col), getLineBits(CellState::none, dir, row, col),
+                                     bitIndex(dir, row, col));
 }
 
 /**
@@ -154,22 +231,27 @@ bool Omok::isFinished(void) {
     return gameFinished;
 }
 
+CellState Omok::getCurrentPlayer(void) const {
+    return curPlayer;
+}
+
 /**
  * A win could only arise depending on the last placed piece.
- * The area to check will only be the 2k x 2k window about the piece
- * 
- * Note: this function ignores overlines
+ * Only the patterns of the four lines through the piece need to be looked up, and
+ * overlines are told apart from fives by the pattern table (they win only under freestyle)
  **/
 void Omok::checkWin(void) {
-    auto winList = enumerateInARow();
+    const int row = std::get<0>(lastMove), col = std::get<1>(lastMove);
 
     // now iterate once to find possible winning direction
-    for(auto& tup:winList) {
+    for(int dirInd=0; dirInd<NUM_DIRS; dirInd++) {
+        const LinePatterns::Pattern pattern = getLinePattern(row, col, curPlayer, static_cast<PieceDirection>(dirInd));
+
         #ifdef OMOK_VERBOSE
-        std::cout << std::get<0>(tup) << " ";
+        std::cout << static_cast<int>(pattern) << " ";
         #endif
 
-        if(std::get<0>(tup) == winSize)
+        if(isWinningPattern(ruleSet, pattern))
             gameFinished = true;
     }
 
@@ -177,4 +259,3 @@ void Omok::checkWin(void) {
     std::cout << std::endl;
     #endif
 }
-
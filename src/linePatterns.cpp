@@ -0,0 +1,135 @@
+#include "../include/linePatterns.h"
+
+namespace {
+    typedef LinePatterns::Pattern Pattern;
+
+    // open three patterns over 6 cells: the cells holding pieces and the cells that must be empty
+    constexpr int THREE_SIZE = 6;
+    constexpr int NUM_THREES = 4;
+    constexpr std::uint32_t THREE_PIECES[NUM_THREES] = {0x1C, 0x0E, 0x1A, 0x16};  // ..xxx. / .xxx.. / .x.xx. / .xx.x.
+    constexpr std::uint32_t THREE_EMPTIES[NUM_THREES] = {0x23, 0x31, 0x25, 0x29};
+    constexpr int NUM_SOLID_THREES = 2;
+
+    // bounds of the run of set bits through bit (inside bits 0..10)
+    constexpr int runBounds(std::uint32_t bits, int bit, int& lowBit, int& highBit) {
+        lowBit = bit;
+        highBit = bit;
+        while(lowBit > 0 && ((bits >> (lowBit-1)) & 1))
+            lowBit--;
+        while(highBit < 10 && ((bits >> (highBit+1)) & 1))
+            highBit++;
+        return highBit - lowBit + 1;
+    }
+
+    constexpr int runThrough(std::uint32_t bits, int bit) {
+        int lowBit = 0, highBit = 0;
+        return runBounds(bits, bit, lowBit, highBit);
+    }
+
+    constexpr std::array<std::uint16_t, 512> buildBase3(void) {
+        std::array<std::uint16_t, 512> base3{};
+        for(int bits=0; bits<512; bits++) {
+            int value = 0, digit = 1;
+            for(int cellInd=0; cellInd<LinePatterns::WINDOW_SIZE; cellInd++, digit*=3)
+                if((bits >> cellInd) & 1)
+                    value += digit;
+            base3[bits] = value;
+        }
+        return base3;
+    }
+
+    // empty cells of the open three patterns inside the window, with whether a solid one was found
+    constexpr std::uint32_t threeGapBits(std::uint32_t ownBits, std::uint32_t emptyBits, bool& isSolidThree) {
+        std::uint32_t gapBits = 0;
+        for(int startInd=0; startInd+THREE_SIZE<=LinePatterns::WINDOW_SIZE; startInd++) {
+            for(int condInd=0; condInd<NUM_THREES; condInd++) {
+                const std::uint32_t pieceMask = THREE_PIECES[condInd] << startInd;
+                const std::uint32_t emptyMask = THREE_EMPTIES[condInd] << startInd;
+                if((ownBits & pieceMask) == pieceMask && (emptyBits & emptyMask) == emptyMask) {
+                    gapBits |= emptyMask;
+                    isSolidThree |= condInd < NUM_SOLID_THREES;
+                }
+            }
+        }
+        return gapBits;
+    }
+
+    /**
+     * Classifies a window whose centre holds an own piece. Runs are measured over 11
+     * cells: the window shifted up by one, with the outside cells at bits 0 and 10.
+     **/
+    constexpr std::uint32_t classifyWindow(std::uint32_t ownBits, std::uint32_t emptyBits, int outside,
+                                           std::uint32_t gapBits, bool isSolidThree) {
+        const std::uint32_t runBits = (outside & 1) | (ownBits << 1) | ((outside >> 1) << 10);
+        const int center = LinePatterns::CENTER + 1;
+        int lowBit = 0, highBit = 0;
+        const int runLen = runBounds(runBits, center, lowBit, highBit);
+
+        // cells that complete exactly five through the centre
+        std::uint32_t fiveBits = 0;
+        for(std::uint32_t freeBits=emptyBits; runLen < 5 && freeBits; freeBits &= freeBits - 1) {
+            const int cellInd = __builtin_ctz(freeBits);
+            if(runThrough(runBits | (1u << (cellInd+1)), center) == 5)
+                fiveBits |= 1u << cellInd;
+        }
+
+        // cells that make a straight four through the centre: a run of four whose cells on
+        // both ends are empty and complete exactly five
+        std::uint32_t fourBits = 0;
+        for(std::uint32_t freeBits=emptyBits; runLen < 4 && freeBits; freeBits &= freeBits - 1) {
+            const int cellInd = __builtin_ctz(freeBits);
+            const std::uint32_t fourRun = runBits | (1u << (cellInd+1));
+            int fourLow = 0, fourHigh = 0;
+            if(runBounds(fourRun, center, fourLow, fourHigh) != 4 || cellInd+1 < fourLow || cellInd+1 > fourHigh
+               || fourLow < 2 || fourHigh > LinePatterns::WINDOW_SIZE-1)
+                continue;
+            if(((emptyBits >> (fourLow-2)) & 1) && ((emptyBits >> fourHigh) & 1)
+               && runThrough(fourRun | (1u << (fourLow-1)), center) == 5 && runThrough(fourRun | (1u << (fourHigh+1)), center) == 5)
+                fourBits |= 1u << cellInd;
+        }
+
+        Pattern pattern = Pattern::none;
+        if(runLen == 5)
+            pattern = Pattern::five;
+        else if(runLen > 5)
+            pattern = Pattern::overline;
+        else if(fiveBits) {
+            // a straight four completes five on both ends of the run
+            const bool isOpen = runLen == 4 && lowBit >= 2 && highBit <= LinePatterns::WINDOW_SIZE-1
+                                && ((fiveBits >> (lowBit-2)) & 1) && ((fiveBits >> highBit) & 1);
+            pattern = isOpen ? Pattern::openFour : Pattern::four;
+        }
+        else if(gapBits)
+            pattern = isSolidThree ? Pattern::openThree : Pattern::brokenThree;
+
+        return gapBits | (fiveBits << LinePatterns::FIVE_SHIFT) | (fourBits << LinePatterns::FOUR_SHIFT)
+               | (std::uint32_t(pattern) << LinePatterns::PATTERN_SHIFT);
+    }
+
+    /**
+     * Only windows with an own piece in the centre are ever looked up, so the table is
+     * filled by walking those directly: every set of own cells through the centre, and
+     * every set of empty cells among the rest.
+     **/
+    constexpr std::array<std::uint32_t, LinePatterns::TABLE_SIZE> buildTable(void) {
+        const std::array<std::uint16_t, 512> base3 = buildBase3();
+        const std::uint32_t centerBit = 1u << LinePatterns::CENTER;
+        std::array<std::uint32_t, LinePatterns::TABLE_SIZE> table{};
+        for(std::uint32_t ownBits=centerBit; ownBits<512; ownBits=(ownBits+1) | centerBit) {
+            const std::uint32_t restBits = 511 & ~ownBits;
+            for(std::uint32_t emptyBits=restBits; ; emptyBits=(emptyBits-1) & restBits) {
+                bool isSolidThree = false;
+                const std::uint32_t gapBits = threeGapBits(ownBits, emptyBits, isSolidThree);
+                const int index = base3[ownBits] + 2*base3[emptyBits];
+                for(int outside=0; outside<4; outside++)
+                    table[index + outside*LinePatterns::WINDOW_STATES] = classifyWindow(ownBits, emptyBits, outside, gapBits, isSolidThree);
+                if(emptyBits == 0)
+                    break;
+            }
+        }
+        return table;
+    }
+}
+
+constexpr std::array<std::uint16_t, 512> LinePatterns::BASE3 = buildBase3();
+constexpr std::array<std::uint32_t, LinePatterns::TABLE_SIZE> LinePatterns::TABLE = buildTable();
@@ -0,0 +1,61 @@
+#include "../include/mappedFile.h"
+#include <fstream>
+#include <iterator>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define MAPPED_FILE_MMAP 1
+#endif
+
+MappedFile::MappedFile(const std::string& filePath) {
+#ifdef MAPPED_FILE_MMAP
+    const int fileDesc = open(filePath.c_str(), O_RDONLY);
+    if(fileDesc >= 0) {
+        struct stat fileStat;
+        if(fstat(fileDesc, &fileStat) == 0) {
+            fileSize = fileStat.st_size;
+            isOpened = true;
+            if(fileSize > 0) {
+                void* mapped = mmap(nullptr, fileSize, PROT_READ, MAP_PRIVATE, fileDesc, 0);
+                if(mapped != MAP_FAILED) {
+                    fileData = static_cast<const char*>(mapped);
+                    isMapped = true;
+                }
+            }
+        }
+        close(fileDesc);
+        if(isMapped || !isOpened || fileSize == 0)
+            return;
+    }
+#endif
+    // read the whole file instead
+    std::ifstream inFile(filePath, std::ios::binary);
+    if(!inFile)
+        return;
+    fileBuffer.assign(std::istreambuf_iterator<char>(inFile), std::istreambuf_iterator<char>());
+    fileData = fileBuffer.data();
+    fileSize = fileBuffer.size();
+    isOpened = true;
+}
+
+MappedFile::~MappedFile() {
+#ifdef MAPPED_FILE_MMAP
+    if(isMapped)
+        munmap(const_cast<char*>(fileData), fileSize);
+#endif
+}
+
+bool MappedFile::isOpen(void) const {
+    return isOpened;
+}
+
+const char* MappedFile::data(void) const {
+    return fileData;
+}
+
+std::size_t MappedFile::size(void) const {
+    return fileSize;
+}
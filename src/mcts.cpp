@@ -0,0 +1,386 @@
+#include "../include/mcts.h"
+#include "../include/moveGenerator.h"
+#include "../include/threatSearch.h"
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <deque>
+#include <thread>
+
+namespace {
+    typedef MNKBoard::PieceDirection PieceDirection;
+    typedef MNKBoard::LineBits LineBits;
+
+    inline CellState otherPlayer(CellState player) {
+        return player == CellState::black ? CellState::white : CellState::black;
+    }
+
+    // length of the player's run through (row, col) once the cell is filled
+    inline int runThrough(Omok& game, CellState player, PieceDirection dir, int row, int col) {
+        const int bit = MNKBoard::bitIndex(dir, row, col);
+        int lowBit, highBit;
+        return MNKBoard::runLength(game.getLineBits(player, dir, row, col) | (LineBits(1) << bit), bit, lowBit, highBit);
+    }
+
+    // plays the first of the cells that is legal for the side to move
+    inline bool playFirstLegal(Omok& game, const int* cells, int numCells, int numCols) {
+        for(int cellInd=0; cellInd<numCells; cellInd++)
+            if(game.makeMove(cells[cellInd] / numCols, cells[cellInd] % numCols))
+                return true;
+        return false;
+    }
+}
+
+MctsSearcher::MctsSearcher(const MctsConfig& config) : config(config), nodes(new Node[config.maxNodes]),
+                                                       numNodes(0), numPlayouts(0), stopSearch(false) {}
+
+void MctsSearcher::clearTree(void) {
+    hasTree = false;
+}
+
+MctsResult MctsSearcher::search(Omok& game, const MctsLimits& limits) {
+    const auto startTime = std::chrono::steady_clock::now();
+    MctsResult result;
+    if(game.isFinished())
+        return result;
+
+    if(!hasTree || !reuseTree(game))
+        resetTree(game);
+    result.reusedVisits = nodes[0].visits.load();
+    numPlayouts = 0;
+    stopSearch = false;
+
+    // every extra thread plays on its own copy of the game
+    std::vector<std::unique_ptr<Omok>> replicas;
+    for(int threadInd=1; threadInd<config.numThreads; threadInd++)
+        replicas.emplace_back(new Omok(game));
+
+    std::vector<std::thread> threads;
+    for(int threadInd=1; threadInd<config.numThreads; threadInd++)
+        threads.emplace_back(&MctsSearcher::runWorker, this, std::ref(*replicas[threadInd-1]), threadInd, std::cref(limits), startTime);
+    runWorker(game, 0, limits, startTime);
+    for(std::thread& thread : threads)
+        thread.join();
+
+    // a winning move or else the most visited root move, which is the most reliable one
+    const Node& root = nodes[0];
+    const std::uint32_t firstChild = root.firstChild.load(), numChildren = root.numChildren.load();
+    std::int32_t bestVisits = -1;
+    for(std::uint32_t childInd=firstChild; root.state.load() == EXPANDED && childInd<firstChild+numChildren; childInd++) {
+        const Node& child = nodes[childInd];
+        const std::int32_t childVisits = child.state.load() == TERMINAL ? INT32_MAX : child.visits.load();
+        if(childVisits > bestVisits) {
+            bestVisits = childVisits;
+            result.bestMove = std::make_tuple(child.move / numCols, child.move % numCols);
+            if(child.visits.load() > 0)
+                result.winRate = child.score.load() / (2.0 * child.visits.load());
+        }
+    }
+
+    result.playouts = numPlayouts.load();
+    if(limits.maxPlayouts)
+        result.playouts = std::min(result.playouts, limits.maxPlayouts);
+    result.treeNodes = numNodes.load();
+    result.elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+    result.playoutsPerSecond = result.elapsedMs > 0 ? static_cast<std::uint64_t>(result.playouts * 1000.0 / result.elapsedMs) : 0;
+    return result;
+}
+
+void MctsSearcher::runWorker(Omok& game, int workerInd, const MctsLimits& limits, std::chrono::steady_clock::time_point startTime) {
+    Worker worker;
+    worker.randGen.seed(config.seed * 0x9E3779B97F4A7C15ULL + workerInd);
+    worker.moves.resize(std::get<0>(game.getBoardSize()) * numCols);
+    worker.cells.resize(worker.moves.size());
+    worker.priors.resize(worker.moves.size());
+
+    for(std::uint64_t playoutInd=0; !stopSearch.load(std::memory_order_relaxed); playoutInd++) {
+        // tickets keep the number of playouts exact across threads
+        if(limits.maxPlayouts && numPlayouts.fetch_add(1) >= limits.maxPlayouts)
+            break;
+        if(!limits.maxPlayouts)
+            numPlayouts.fetch_add(1);
+
+        playout(game, worker);
+
+        if(limits.maxTimeMs && (playoutInd & 31) == 31
+           && std::chrono::steady_clock::now() - startTime >= std::chrono::milliseconds(limits.maxTimeMs))
+            stopSearch = true;
+    }
+}
+
+/**
+ * Selects down to a leaf while adding virtual losses, expands it once it has been
+ * visited, plays it out and backs the result up along the path.
+ **/
+void MctsSearcher::playout(Omok& game, Worker& worker) {
+    const CellState rootPlayer = game.getCurrentPlayer();
+    std::uint32_t nodeInd = 0;
+    int numMade = 0;
+    bool isDecided = false;
+    CellState winner = CellState::none;
+
+    worker.path.clear();
+    worker.path.push_back(0);
+    nodes[0].virtualLosses.fetch_add(config.virtualLoss, std::memory_order_relaxed);
+    while(true) {
+        Node& node = nodes[nodeInd];
+        if(game.isFinished()) {
+            node.state.store(TERMINAL, std::memory_order_relaxed);
+            winner = game.getCurrentPlayer();
+            isDecided = true;
+            break;
+        }
+
+        std::uint8_t state = node.state.load(std::memory_order_acquire);
+        if(state == UNEXPANDED && (nodeInd == 0 || node.visits.load(std::memory_order_relaxed) > 0)
+           && expandNode(game, node, worker))
+            state = EXPANDED;
+        if(state != EXPANDED || node.numChildren.load(std::memory_order_relaxed) == 0)
+            break;
+
+        nodeInd = selectChild(node, config.usePuct);
+        Node& child = nodes[nodeInd];
+        child.virtualLosses.fetch_add(config.virtualLoss, std::memory_order_relaxed);
+        worker.path.push_back(nodeInd);
+        if(!game.makeMove(child.move / numCols, child.move % numCols))
+            break;
+        numMade++;
+    }
+
+    if(!isDecided)
+        winner = rollout(game, worker);
+
+    // the root is entered by the opponent of the side to move, and the players alternate below it
+    CellState moverIntoNode = otherPlayer(rootPlayer);
+    for(std::uint32_t pathInd : worker.path) {
+        Node& node = nodes[pathInd];
+        const int points = winner == CellState::none ? 1 : (winner == moverIntoNode ? 2 : 0);
+        node.score.fetch_add(points, std::memory_order_relaxed);
+        node.visits.fetch_add(1, std::memory_order_relaxed);
+        node.virtualLosses.fetch_sub(config.virtualLoss, std::memory_order_relaxed);
+        moverIntoNode = otherPlayer(moverIntoNode);
+    }
+
+    for(int moveInd=0; moveInd<numMade; moveInd++)
+        game.unmakeMove();
+}
+
+/**
+ * Virtual losses count as visits that were lost, which steers other threads away
+ * from the paths that are currently being played out.
+ **/
+std::uint32_t MctsSearcher::selectChild(const Node& node, bool usePriors) const {
+    const std::uint32_t firstChild = node.firstChild.load(std::memory_order_relaxed);
+    const std::uint32_t numChildren = node.numChildren.load(std::memory_order_relaxed);
+    const double parentVisits = std::max(1, node.visits.load(std::memory_order_relaxed)
+                                            + node.virtualLosses.load(std::memory_order_relaxed));
+    const double logParent = std::log(parentVisits), sqrtParent = std::sqrt(parentVisits);
+
+    std::uint32_t bestInd = firstChild;
+    double bestValue = -1;
+    for(std::uint32_t childInd=firstChild; childInd<firstChild+numChildren; childInd++) {
+        const Node& child = nodes[childInd];
+        if(child.state.load(std::memory_order_relaxed) == TERMINAL)
+            return childInd;    // a winning move needs no more exploration
+
+        const int childVisits = child.visits.load(std::memory_order_relaxed)
+                                + child.virtualLosses.load(std::memory_order_relaxed);
+        const double meanValue = childVisits ? child.score.load(std::memory_order_relaxed) / (2.0 * childVisits) : 0.5;
+
+        double value;
+        if(usePriors)
+            value = meanValue + config.exploration * child.prior * sqrtParent / (1 + childVisits);
+        else if(childVisits == 0)
+            value = 1e9 + child.prior;      // unvisited children come first
+        else
+            value = meanValue + config.exploration * std::sqrt(logParent / childVisits);
+
+        if(value > bestValue) {
+            bestValue = value;
+            bestInd = childInd;
+        }
+    }
+    return bestInd;
+}
+
+/**
+ * Children are allocated as one block of the arena. A block is only taken if it fits,
+ * so a node that does not fit stays a leaf and leaves the rest of the arena to smaller
+ * expansions.
+ **/
+bool MctsSearcher::expandNode(Omok& game, Node& node, Worker& worker) {
+    std::uint8_t expectedState = UNEXPANDED;
+    if(!node.state.compare_exchange_strong(expectedState, EXPANDING, std::memory_order_acquire))
+        return false;
+
+    // the legal moves for the side to move, narrowed down to the fives or blocks if there are any
+    const int numMoves = MoveGenerator(game, false).generateAll(worker.moves.data());
+    float weightSum = 0;
+    for(int moveInd=0; moveInd<numMoves; moveInd++) {
+        const int row = worker.moves[moveInd] / numCols, col = worker.moves[moveInd] % numCols;
+        worker.priors[moveInd] = config.usePuct ? moveWeight(game, row, col) : 1.0f;
+        weightSum += worker.priors[moveInd];
+    }
+
+    std::size_t firstChild = numNodes.load(std::memory_order_relaxed);
+    do {
+        if(firstChild + numMoves > config.maxNodes)
+            return false;
+    } while(!numNodes.compare_exchange_weak(firstChild, firstChild + numMoves, std::memory_order_relaxed));
+
+    for(int moveInd=0; moveInd<numMoves; moveInd++)
+        initNode(nodes[firstChild + moveInd], worker.moves[moveInd], worker.priors[moveInd] / weightSum);
+    node.firstChild.store(firstChild, std::memory_order_relaxed);
+    node.numChildren.store(numMoves, std::memory_order_relaxed);
+    node.state.store(EXPANDED, std::memory_order_release);
+    return true;
+}
+
+/**
+ * Random playout among the cells near the pieces. With pattern rollouts a five is
+ * always completed and a five of the opponent always blocked.
+ **/
+CellState MctsSearcher::rollout(Omok& game, Worker& worker) {
+    int numMade = 0;
+    CellState winner = CellState::none;
+    while(numMade < config.maxRolloutMoves) {
+        if(game.isFinished()) {
+            winner = game.getCurrentPlayer();
+            break;
+        }
+
+        const CellState mover = game.getCurrentPlayer();
+        if(config.patternRollouts) {
+            const int numFives = ThreatSolver::findFivePoints(game, mover, worker.cells.data());
+            const int numBlocks = numFives ? 0 : ThreatSolver::findFivePoints(game, otherPlayer(mover), worker.cells.data());
+            if((numFives || numBlocks) && playFirstLegal(game, worker.cells.data(), numFives + numBlocks, numCols)) {
+                numMade++;
+                continue;
+            }
+        }
+
+        // random legal move (forbidden cells are dropped as they come up)
+        int numMoves = MoveGenerator::candidateCells(game, worker.moves.data());
+        bool isPlayed = false;
+        while(numMoves > 0 && !isPlayed) {
+            const int moveInd = worker.randGen() % numMoves;
+            isPlayed = game.makeMove(worker.moves[moveInd] / numCols, worker.moves[moveInd] % numCols);
+            worker.moves[moveInd] = worker.moves[--numMoves];
+        }
+        if(!isPlayed)
+            break;
+        numMade++;
+    }
+
+    for(int moveInd=0; moveInd<numMade; moveInd++)
+        game.unmakeMove();
+    return winner;
+}
+
+// longer runs of either player through the cell make the move more urgent
+float MctsSearcher::moveWeight(Omok& game, int row, int col) {
+    const CellState mover = game.getCurrentPlayer();
+    float weight = 1;
+    for(int dirInd=0; dirInd<MNKBoard::NUM_DIRS; dirInd++) {
+        const PieceDirection dir = static_cast<PieceDirection>(dirInd);
+        const int ownRun = runThrough(game, mover, dir, row, col);
+        const int otherRun = runThrough(game, otherPlayer(mover), dir, row, col);
+        weight += ownRun >= 5 ? 1000 : 2*(ownRun-1)*(ownRun-1);
+        weight += otherRun >= 5 ? 500 : (otherRun-1)*(otherRun-1);
+    }
+    return weight;
+}
+
+void MctsSearcher::initNode(Node& node, int move, float prior) {
+    node.visits.store(0, std::memory_order_relaxed);
+    node.virtualLosses.store(0, std::memory_order_relaxed);
+    node.score.store(0, std::memory_order_relaxed);
+    node.firstChild.store(0, std::memory_order_relaxed);
+    node.numChildren.store(0, std::memory_order_relaxed);
+    node.state.store(UNEXPANDED, std::memory_order_relaxed);
+    node.move = move;
+    node.prior = prior;
+}
+
+void MctsSearcher::resetTree(Omok& game) {
+    numCols = std::get<1>(game.getBoardSize());
+    initNode(nodes[0], -1, 1);
+    numNodes = 1;
+
+    rootHistory.clear();
+    for(int moveInd=0; moveInd<game.getMoveCount(); moveInd++)
+        rootHistory.push_back(game.getMove(moveInd));
+    hasTree = true;
+}
+
+/**
+ * The searched position continues the history of the tree root: follow the new moves
+ * down the tree and keep the subtree that is found.
+ **/
+bool MctsSearcher::reuseTree(Omok& game) {
+    if(game.getMoveCount() < static_cast<int>(rootHistory.size()))
+        return false;
+    for(std::size_t moveInd=0; moveInd<rootHistory.size(); moveInd++)
+        if(game.getMove(moveInd) != rootHistory[moveInd])
+            return false;
+
+    std::uint32_t nodeInd = 0;
+    for(int moveInd=rootHistory.size(); moveInd<game.getMoveCount(); moveInd++) {
+        const Node& node = nodes[nodeInd];
+        if(node.state.load() != EXPANDED)
+            return false;
+
+        const int cell = std::get<0>(game.getMove(moveInd))*numCols + std::get<1>(game.getMove(moveInd));
+        const std::uint32_t firstChild = node.firstChild.load(), numChildren = node.numChildren.load();
+        std::uint32_t childInd = firstChild;
+        while(childInd < firstChild+numChildren && nodes[childInd].move != cell)
+            childInd++;
+        if(childInd == firstChild+numChildren)
+            return false;
+        nodeInd = childInd;
+    }
+
+    if(nodeInd != 0)
+        compactTree(nodeInd);
+    for(int moveInd=rootHistory.size(); moveInd<game.getMoveCount(); moveInd++)
+        rootHistory.push_back(game.getMove(moveInd));
+    return true;
+}
+
+// copies the subtree below newRoot breadth first into the spare arena and swaps the arenas
+void MctsSearcher::compactTree(std::uint32_t newRoot) {
+    if(!spareNodes)
+        spareNodes.reset(new Node[config.maxNodes]);
+
+    auto copyNode = [](const Node& srcNode, Node& dstNode) {
+        initNode(dstNode, srcNode.move, srcNode.prior);
+        dstNode.visits.store(srcNode.visits.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        dstNode.score.store(srcNode.score.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    };
+
+    std::deque<std::pair<std::uint32_t, std::uint32_t>> copyQueue;
+    copyNode(nodes[newRoot], spareNodes[0]);
+    copyQueue.emplace_back(newRoot, 0);
+    std::uint32_t numCopied = 1;
+    while(!copyQueue.empty()) {
+        const Node& srcNode = nodes[copyQueue.front().first];
+        Node& dstNode = spareNodes[copyQueue.front().second];
+        copyQueue.pop_front();
+        if(srcNode.state.load() != EXPANDED)
+            continue;
+
+        // children stay one block in the new arena
+        const std::uint32_t firstChild = srcNode.firstChild.load(), numChildren = srcNode.numChildren.load();
+        dstNode.firstChild.store(numCopied, std::memory_order_relaxed);
+        dstNode.numChildren.store(numChildren, std::memory_order_relaxed);
+        dstNode.state.store(EXPANDED, std::memory_order_relaxed);
+        for(std::uint32_t childInd=0; childInd<numChildren; childInd++) {
+            copyNode(nodes[firstChild + childInd], spareNodes[numCopied + childInd]);
+            copyQueue.emplace_back(firstChild + childInd, numCopied + childInd);
+        }
+        numCopied += numChildren;
+    }
+
+    std::swap(nodes, spareNodes);
+    numNodes = numCopied;
+}
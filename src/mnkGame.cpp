@@ -1,51 +1,153 @@
 #include "../include/mnkGame.h"
+#include "../include/board.h"
 #include <utility>
 #include <vector>
 #include <string>
 #include <tuple>
 #include <iostream>
 #include <cmath>
+#include <stdexcept>
+#include <algorithm>
+#include <array>
+
+// bit helpers used by the run detection
+namespace {
+    inline int trailingOnes(MNKBoard::LineBits bits) {
+        return ~bits == 0 ? 64 : __builtin_ctzll(~bits);
+    }
+    inline int leadingOnes(MNKBoard::LineBits bits) {
+        return ~bits == 0 ? 64 : __builtin_clzll(~bits);
+    }
 
-MNKBoard::MNKBoard(int m, int n, int k) : winSize(k), numRows(m), numCols(n), lastMove(std::make_tuple(0,0)) {
-    // initialize the board
-    board = new CellState* [numRows];
-    for(int rowInd=0; rowInd<numRows; rowInd++) {
-        board[rowInd] = new CellState [numCols];
-        for(int colInd=0; colInd<numCols; colInd++)
-            board[rowInd][colInd] = CellState::none;
+    // Zobrist keys are laid out as [player][row][col] for the largest supported board (plus the
+    // side to move key at the end) so that equal cells share keys across board sizes
+    constexpr int ZOBRIST_CELLS = MNKBoard::MAX_DIM * MNKBoard::MAX_DIM;
+    constexpr std::array<std::uint64_t, 2*ZOBRIST_CELLS+1> buildZobristTable(void) {
+        std::array<std::uint64_t, 2*ZOBRIST_CELLS+1> keyTable{};
+        std::uint64_t seedVal = 0x5EED0F60AE5D0A1DULL;
+        for(auto& key : keyTable) {
+            // splitmix64 sequence
+            seedVal += 0x9E3779B97F4A7C15ULL;
+            std::uint64_t mixVal = seedVal;
+            mixVal = (mixVal ^ (mixVal >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            mixVal = (mixVal ^ (mixVal >> 27)) * 0x94D049BB133111EBULL;
+            key = mixVal ^ (mixVal >> 31);
+        }
+        return keyTable;
     }
-    
-    // initialize flipped board
-    flippedBoard = new CellState* [numCols];
-    for(int colInd=0; colInd<numCols; colInd++) {
-        flippedBoard[colInd] = new CellState [numRows];
-        for(int rowInd=0; rowInd<numRows; rowInd++)
-            flippedBoard[colInd][rowInd] = CellState::none;
+    constexpr std::array<std::uint64_t, 2*ZOBRIST_CELLS+1> ZOBRIST_TABLE = buildZobristTable();
+}
+
+MNKBoard::MNKBoard(int m, int n, int k, BoardArena* arena) : numRows(m), numCols(n), winSize(k), lastMove(std::make_tuple(0,0)),
+                                                             numSymmetries(m == n ? NUM_SYMMETRIES : NUM_SYMMETRIES/2) {
+    if(m <= 0 || n <= 0 || m > MAX_DIM || n > MAX_DIM)
+        throw std::invalid_argument("MNKBoard dimensions must lie within [1, 64]");
+    allocateStorage(arena);
+}
+
+MNKBoard::MNKBoard(const MNKBoard& otherBoard, BoardArena* arena) : numRows(otherBoard.numRows), numCols(otherBoard.numCols),
+                                                                   winSize(otherBoard.winSize) {
+    allocateStorage(arena);
+    copyState(otherBoard);
+}
+
+// a board of another size gets a new block, from the arena the old one came from
+MNKBoard& MNKBoard::operator=(const MNKBoard& otherBoard) {
+    if(this == &otherBoard)
+        return *this;
+    if(!core || numRows != otherBoard.numRows || numCols != otherBoard.numCols || winSize != otherBoard.winSize) {
+        BoardArena* arena = storage.getArena();
+        releaseStorage();
+        numRows = otherBoard.numRows;
+        numCols = otherBoard.numCols;
+        winSize = otherBoard.winSize;
+        allocateStorage(arena);
     }
+    copyState(otherBoard);
+    return *this;
+}
+
+void MNKBoard::copyState(const MNKBoard& otherBoard) {
+    core->copyFrom(*otherBoard.core);
+    std::copy(otherBoard.moveStack, otherBoard.moveStack + otherBoard.moveCount, moveStack);
+    moveCount = otherBoard.moveCount;
+    lastMove = otherBoard.lastMove;
+    hashKey = otherBoard.hashKey;
+    std::copy(otherBoard.symmetryKeys, otherBoard.symmetryKeys+NUM_SYMMETRIES, symmetryKeys);
+    numSymmetries = otherBoard.numSymmetries;
+}
+
+// the block does not move, so the line pointers stay valid
+MNKBoard::MNKBoard(MNKBoard&& otherBoard) noexcept : numRows(otherBoard.numRows), numCols(otherBoard.numCols) {
+    *this = std::move(otherBoard);
+}
+
+MNKBoard& MNKBoard::operator=(MNKBoard&& otherBoard) noexcept {
+    if(this == &otherBoard)
+        return *this;
+    releaseStorage();
+    numRows = otherBoard.numRows;
+    numCols = otherBoard.numCols;
+    winSize = otherBoard.winSize;
+    storage = std::move(otherBoard.storage);
+    core = std::exchange(otherBoard.core, nullptr);
+    moveStack = std::exchange(otherBoard.moveStack, nullptr);
+    std::copy(&otherBoard.linePlanes[0][0], &otherBoard.linePlanes[0][0] + 2*NUM_DIRS, &linePlanes[0][0]);
+    std::copy(otherBoard.lineMasks, otherBoard.lineMasks+NUM_DIRS, lineMasks);
+    std::copy(otherBoard.numLines, otherBoard.numLines+NUM_DIRS, numLines);
+    moveCount = otherBoard.moveCount;
+    lastMove = otherBoard.lastMove;
+    hashKey = otherBoard.hashKey;
+    std::copy(otherBoard.symmetryKeys, otherBoard.symmetryKeys+NUM_SYMMETRIES, symmetryKeys);
+    numSymmetries = otherBoard.numSymmetries;
+    return *this;
 }
 
 MNKBoard::~MNKBoard() {
-    // free up memory allocated for board
-    for(int rowInd=0; rowInd<numRows; rowInd++)
-        free(board[rowInd]);
-    free(board);
-    for(int colInd=0; colInd<numCols; colInd++)
-        free(flippedBoard[colInd]);
-    free(flippedBoard);
+    releaseStorage();
+}
+
+/**
+ * The core comes first in the block and the undo stack (which never holds more moves
+ * than there are cells) right after it.
+ **/
+void MNKBoard::allocateStorage(BoardArena* arena) {
+    const std::size_t coreSize = BoardCore::storageSize(numRows, numCols, winSize);
+    const std::size_t stackOffset = (coreSize + alignof(MoveRecord) - 1) / alignof(MoveRecord) * alignof(MoveRecord);
+    storage = ArenaBlock(stackOffset + numRows*numCols*sizeof(MoveRecord), arena);
+
+    core = BoardCore::create(numRows, numCols, winSize, storage.data());
+    moveStack = reinterpret_cast<MoveRecord*>(static_cast<char*>(storage.data()) + stackOffset);
+    for(int dirInd=0; dirInd<NUM_DIRS; dirInd++) {
+        linePlanes[0][dirInd] = core->planes[0][dirInd];
+        linePlanes[1][dirInd] = core->planes[1][dirInd];
+        lineMasks[dirInd] = core->masks[dirInd];
+        numLines[dirInd] = core->numLines[dirInd];
+    }
+}
+
+void MNKBoard::releaseStorage(void) {
+    if(core)
+        core->~BoardCore();
+    core = nullptr;
+    moveStack = nullptr;
+    storage = ArenaBlock();
 }
 
 bool MNKBoard::placePiece(int row, int col, CellState state, bool updateLast) {
     if(row < 0 || row >= numRows || col < 0 || col >= numCols || state == CellState::none)
         return false; // this line should be used to throw a proper exception instead
 
-    if(board[row][col] == CellState::none) {
-        // update board
-        board[row][col] = state;
-        flippedBoard[col][row] = state;
+    if(isPosEmpty(row, col)) {
+        hashKey ^= zobristKey(state, row, col);
+        updateSymmetryKeys(state, row, col);
+
+        // update every rotated plane of the player
+        core->setCell(playerIndex(state), row, col);
 
         // update last placed piece
         if(updateLast) {
-            std::get<0>(lastMove) = row; 
+            std::get<0>(lastMove) = row;
             std::get<1>(lastMove) = col;
         }
         return true;
@@ -55,51 +157,163 @@ bool MNKBoard::placePiece(int row, int col, CellState state, bool updateLast) {
 }
 
 /**
- * Helper only used for testing piece placements
+ * Clears a single cell without touching the undo stack. Recorded moves should
+ * be taken back with unmakeMove instead.
  * */
 void MNKBoard::removePiece(int row, int col) {
-    board[row][col] = CellState::none;
+    const CellState prevState = getCell(row, col);
+    if(prevState != CellState::none) {
+        hashKey ^= zobristKey(prevState, row, col);
+        updateSymmetryKeys(prevState, row, col);
+    }
+    core->clearCell(row, col);
+}
+
+/**
+ * Places a piece and records it on the undo stack so that it can be taken
+ * back later with unmakeMove
+ **/
+bool MNKBoard::makeMove(int row, int col, CellState state) {
+    const std::tuple<int, int> prevLastMove = lastMove;
+    if(!MNKBoard::placePiece(row, col, state))
+        return false;
+
+    moveStack[moveCount++] = {row, col, prevLastMove};
+    return true;
+}
+
+/**
+ * Takes back the most recent recorded move, restoring the board and the last
+ * move. Returns false if there is no move left to take back.
+ **/
+bool MNKBoard::unmakeMove(void) {
+    if(moveCount == 0)
+        return false;
+
+    const MoveRecord& record = moveStack[--moveCount];
+    removePiece(record.row, record.col);
+    lastMove = record.prevLastMove;
+    return true;
+}
+
+int MNKBoard::getMoveCount(void) const {
+    return moveCount;
+}
+
+std::tuple<int, int> MNKBoard::getLastMove(void) const {
+    return lastMove;
+}
+
+std::tuple<int, int> MNKBoard::getMove(int moveInd) const {
+    return std::make_tuple(moveStack[moveInd].row, moveStack[moveInd].col);
+}
+
+std::uint64_t MNKBoard::getHashKey(void) const {
+    return hashKey;
+}
+
+/**
+ * The symmetry keys hold the pieces only, so whatever else the game mixed into the hash
+ * key (such as the side to move) is carried over from the identity key.
+ **/
+std::uint64_t MNKBoard::getCanonicalKey(Symmetry& transform) const {
+    int bestSym = 0;
+    for(int symInd=1; symInd<numSymmetries; symInd++)
+        if(symmetryKeys[symInd] < symmetryKeys[bestSym])
+            bestSym = symInd;
+    transform = static_cast<Symmetry>(bestSym);
+    return symmetryKeys[bestSym] ^ (hashKey ^ symmetryKeys[0]);
+}
+
+int MNKBoard::getNumSymmetries(void) const {
+    return numSymmetries;
+}
+
+std::tuple<int, int> MNKBoard::transformCell(Symmetry sym, int row, int col) const {
+    const int symInd = static_cast<int>(sym);
+    int newRow = symInd & 4 ? col : row, newCol = symInd & 4 ? row : col;
+    if(symInd & 1)
+        newRow = numRows-1 - newRow;
+    if(symInd & 2)
+        newCol = numCols-1 - newCol;
+    return std::make_tuple(newRow, newCol);
+}
+
+std::tuple<int, int> MNKBoard::inverseTransformCell(Symmetry sym, int row, int col) const {
+    return transformCell(inverse(sym), row, col);
+}
+
+// every symmetry but the quarter turns undoes itself
+MNKBoard::Symmetry MNKBoard::inverse(Symmetry sym) {
+    if(sym == Symmetry::rotate90)
+        return Symmetry::rotate270;
+    if(sym == Symmetry::rotate270)
+        return Symmetry::rotate90;
+    return sym;
+}
+
+void MNKBoard::updateSymmetryKeys(CellState player, int row, int col) {
+    for(int symInd=0; symInd<numSymmetries; symInd++) {
+        const auto [symRow, symCol] = transformCell(static_cast<Symmetry>(symInd), row, col);
+        symmetryKeys[symInd] ^= zobristKey(player, symRow, symCol);
+    }
+}
+
+std::uint64_t MNKBoard::zobristKey(CellState player, int row, int col) {
+    return ZOBRIST_TABLE[playerIndex(player)*ZOBRIST_CELLS + row*MAX_DIM + col];
+}
+
+std::uint64_t MNKBoard::zobristSideKey(void) {
+    return ZOBRIST_TABLE[2*ZOBRIST_CELLS];
 }
 
 /**
  * A win could only arise depending on the last placed piece.
- * The area to check will only be the 2k x 2k window about the piece
- * 
+ * Only the four lines passing through the piece need to be checked, which
+ * the core does with the win masks of the board size.
+ *
  * Note: this function accepts overlines
  **/
 bool MNKBoard::checkWin(void) {
     // edge quick eval case: no move has been made yet (=> no winner)
-    if(board[std::get<0>(lastMove)][std::get<1>(lastMove)] == CellState::none)
+    const int row = std::get<0>(lastMove), col = std::get<1>(lastMove);
+    const CellState curPlayer = getCell(row, col);
+    if(curPlayer == CellState::none)
         return false;
 
-    auto winList = enumerateInARow();
-
-    // now iterate once to find possible winning direction
-    for(auto& tup:winList) 
-        if(std::get<0>(tup) >= winSize)
-            return true;
-
-    return false;
+    return core->hasRun(playerIndex(curPlayer), row, col);
 }
 
 /**
  * Checks if the current position is not taken by any player
  **/
 bool MNKBoard::isPosEmpty(int row, int col) {
-    return board[row][col] == CellState::none;
+    if(row < 0 || row >= numRows || col < 0 || col >= numCols)
+        return false;
+    return getCell(row, col) == CellState::none;
+}
+
+/**
+ * Reads a single cell back out of the row planes
+ **/
+CellState MNKBoard::getCell(int row, int col) const {
+    const int hInd = (int)PieceDirection::HORZ;
+    if((linePlanes[0][hInd][row] >> col) & 1)
+        return CellState::black;
+    if((linePlanes[1][hInd][row] >> col) & 1)
+        return CellState::white;
+    return CellState::none;
 }
 
 
 /**
- * Just empties the board using a basic loop. Writes the pieces
- * to be the typical CellState::none piece.
+ * Just empties the board by zeroing every plane.
  **/
 void MNKBoard::clearBoard(void) {
-    for(int rowInd=0; rowInd<numRows; rowInd++)
-        for(int colInd=0; colInd<numCols; colInd++) {
-            board[rowInd][colInd] = CellState::none;
-            flippedBoard[colInd][rowInd] = CellState::none;
-        }
+    core->clear();
+    moveCount = 0;
+    hashKey = 0;
+    std::fill(symmetryKeys, symmetryKeys+NUM_SYMMETRIES, 0);
 }
 
 /**
@@ -110,223 +324,167 @@ std::tuple<int, int> MNKBoard::getBoardSize(void) {
 }
 
 /**
- *  Slices the board to isolate a given row
- **/ 
-const std::vector<CellState> MNKBoard::getRowVec(int rowInd) {
-    return std::vector<CellState>(board[rowInd], board[rowInd]+numRows);
+ * Reports the number of pieces in a row needed to win
+ **/
+int MNKBoard::getWinSize(void) const {
+    return winSize;
 }
 
 /**
- *  Slices the board to isolate a given column
- **/ 
-const std::vector<CellState> MNKBoard::getColVec(int colInd) {
-    return std::vector<CellState>(flippedBoard[colInd], flippedBoard[colInd]+numCols);
+ * Finds the line that a cell belongs to for a particular direction
+ **/
+int MNKBoard::lineIndex(PieceDirection dir, int row, int col) const {
+    switch(dir) {
+        case PieceDirection::VERT: return col;
+        case PieceDirection::HORZ: return row;
+        case PieceDirection::FSD:  return row + col;
+        default:                   return col - row + numRows - 1;
+    }
 }
 
-/**
- *  Slices the board to isolate a (/)-directional diagonal given a particular index.
- * 
- *  Use the window size argument to acquire only a windowed look into the diagonal
- **/ 
-const std::vector<CellState> MNKBoard::getForwardDiagVec(int pieceRow, int pieceCol, int windowSize) {
-    auto tempVec = std::vector<CellState>();
-
-    if(windowSize == 0) {
-        // adjust offset to begin from most bottom-left element we can find
-        int deltaVal = std::min((int)numRows-pieceRow, pieceCol);
-        pieceRow += deltaVal; pieceCol -= deltaVal;
-
-        // Add elements to vector as we go starting from bottom left position
-        while(pieceRow < numRows && pieceCol < numCols) {
-            tempVec.push_back(board[pieceRow][pieceCol]);
-            pieceRow -= 1; pieceCol += 1;
-        }
-    } else { // need to find vector windowSize elems left and right of cur elem and simply construct a small vec
-        tempVec.push_back(board[pieceRow][pieceCol]);
-        vectorBuilderHelper(tempVec, windowSize, pieceRow, pieceCol, 1, -1);
-        vectorBuilderHelper(tempVec, windowSize, pieceRow, pieceCol, -1, 1);
+std::tuple<int, int> MNKBoard::lineCell(PieceDirection dir, int row, int col, int bit) {
+    switch(dir) {
+        case PieceDirection::VERT: return std::make_tuple(bit, col);
+        case PieceDirection::HORZ: return std::make_tuple(row, bit);
+        case PieceDirection::FSD:  return std::make_tuple(row + col - bit, bit);
+        default:                   return std::make_tuple(row - col + bit, bit);
     }
-
-    return tempVec;
 }
 
 /**
- *  Slices the board to isolate a (\)-directional diagonal given a particular index.
- *  This is simple as any upper left element is guaranteed to exist if a lower-right element exists.
- * 
- *  A subslice can be acquired by specifying the window size argument.
- **/ 
-const std::vector<CellState> MNKBoard::getBackDiagVec(int pieceRow, int pieceCol, int windowSize) {
-    // Add elements to vector as we go starting from top left position
-    auto tempVec = std::vector<CellState>();
-
-    if(windowSize == 0) {
-        int deltaVal = std::min(pieceRow, pieceCol);
-        pieceRow -= deltaVal; pieceCol -= deltaVal;
-
-        while(pieceRow < numRows && pieceCol < numCols) {
-            tempVec.push_back(board[pieceRow][pieceCol]);
-            pieceRow += 1; pieceCol += 1;
-        }
-    } else {
-        tempVec.push_back(board[pieceRow][pieceCol]);
-        vectorBuilderHelper(tempVec, windowSize, pieceRow, pieceCol, -1, -1);
-        vectorBuilderHelper(tempVec, windowSize, pieceRow, pieceCol, 1, 1);
-    }
+ * Returns the bits of a line for the given player. Passing CellState::none
+ * returns the cells of the line that are still open.
+ **/
+MNKBoard::LineBits MNKBoard::getLineBits(CellState state, PieceDirection dir, int row, int col) const {
+    return getLine(state, dir, lineIndex(dir, row, col));
+}
 
-    return tempVec;
+MNKBoard::LineBits MNKBoard::getLine(CellState state, PieceDirection dir, int lineInd) const {
+    const int dirInd = (int)dir;
+    if(state == CellState::none)
+        return lineMasks[dirInd][lineInd] & ~(linePlanes[0][dirInd][lineInd] | linePlanes[1][dirInd][lineInd]);
+    return linePlanes[playerIndex(state)][dirInd][lineInd];
 }
 
-/**
- * Recursive helper that populates a vector with the proper elements either in the beginning or at the end...
- * */ 
-void MNKBoard::vectorBuilderHelper(std::vector<CellState>& toModify, int windowSize, int row, int col, int deltaY, int deltaX) {
-    // edge cases (ie. no need to go farther or edges of matrix reached)
-    if(windowSize <= 0 || (row == 0 && deltaY < 0) || (row == numRows-1 && deltaY > 0) 
-                       || (col == 0 && deltaX < 0) || (row == numCols-1 && deltaX > 0))
-        return;
-    
-    // Since our vector always goes from left -> right. A negative deltaX implies a prepend and a positive deltaX
-    // implies an append...
-    if(deltaX < 0)
-        toModify.emplace(toModify.begin(), board[row+deltaY][col+deltaX]);
-    else
-        toModify.emplace_back(board[row+deltaY][col+deltaX]);
-
-    // recurse with smaller window size
-    vectorBuilderHelper(toModify, windowSize-1, row+deltaY, col+deltaX, deltaY, deltaX);
+int MNKBoard::getNumLines(PieceDirection dir) const {
+    return numLines[(int)dir];
 }
 
 /**
- * Helper function that totals all "in-a-row" sequences starting from the last
- * played piece.
+ * Measures the run of set bits passing through a given bit. The bounds of the run are
+ * written into lowBit and highBit. Returns 0 if the bit itself is not set.
  **/
-std::vector<std::tuple<int, MNKBoard::PieceDirection, std::tuple<int, int>, std::tuple<int, int>>> MNKBoard::enumerateInARow(void) {
-    // Place the initial directions to branch out of
-    auto winList = std::vector<std::tuple<int, PieceDirection, std::tuple<int, int>, std::tuple<int, int>>>();
-    PieceDirection allDirs[4] = {PieceDirection::BSD, PieceDirection::FSD, PieceDirection::HORZ, PieceDirection::VERT};
-    for(auto& dir:allDirs)
-        winList.emplace_back(1, dir, lastMove, lastMove);
-    const CellState curPlayer = board[std::get<0>(lastMove)][std::get<1>(lastMove)];
-
-    // collect moves as long as moves are possible
-    bool changedArray = true;
-    int minRowCnt = 1;
-    while(changedArray && minRowCnt <= winSize) {
-        changedArray = false;
-        for(auto& tup:winList) {
-            #ifdef MNK_VERBOSE
-            tuplePrinterHelper(tup);
-            #endif
-            PieceDirection& curDir = std::get<1>(tup);
-            auto& pieceL = std::get<2>(tup);
-            auto& pieceR = std::get<3>(tup);
-            int pDelta = 0;
-
-            // update the moves and add points if necessary
-            if(curDir == PieceDirection::HORZ)
-                pDelta = updateHorzPos(curPlayer, pieceL, pieceR);
-            else if(curDir == PieceDirection::VERT)
-                pDelta = updateVertPos(curPlayer, pieceL, pieceR);
-            else if(curDir == PieceDirection::BSD)
-                pDelta = updateBSDPos(curPlayer, pieceL, pieceR);
-            else if(curDir == PieceDirection::FSD)
-                pDelta = updateFSDPos(curPlayer, pieceL, pieceR);
-
-            // was there any change?
-            if(changedArray == false)
-                changedArray = pDelta?true:false;
-            std::get<0>(tup) += pDelta;
-            minRowCnt = std::get<0>(tup)<minRowCnt ? std::get<0>(tup) : minRowCnt;
-        }
+int MNKBoard::runLength(LineBits line, int bit, int& lowBit, int& highBit) {
+    const int upLen = trailingOnes(line >> bit);
+    if(upLen == 0) {
+        lowBit = highBit = bit;
+        return 0;
     }
-
-    return winList;
+    const int downLen = leadingOnes(line << (63 - bit));
+    lowBit = bit - downLen + 1;
+    highBit = bit + upLen - 1;
+    return upLen + downLen - 1;
 }
 
-// helpers that return the pointage change for the particular tuple
-int MNKBoard::updateVertPos(const CellState player, std::tuple<int, int>& pieceL, std::tuple<int, int>& pieceR) {
-    // calculates additional chain length
-    int extLen = 0;
+/**
+ *  Slices the board to isolate a given row
+ **/
+MNKBoard::LineCells MNKBoard::getRowVec(int rowInd) {
+    return lineVecHelper(PieceDirection::HORZ, rowInd, 0, 0);
+}
 
-    if(std::get<0>(pieceL)-1 >= 0 && board[std::get<0>(pieceL)-1][std::get<1>(pieceL)] == player) {
-        std::get<0>(pieceL) -= 1;
-        extLen += 1;
-    }
-    if(std::get<0>(pieceR)+1 < numRows && board[std::get<0>(pieceR)+1][std::get<1>(pieceR)] == player) {
-        std::get<0>(pieceR) += 1;
-        extLen += 1;
-    }
+/**
+ *  Slices the board to isolate a given column
+ **/
+MNKBoard::LineCells MNKBoard::getColVec(int colInd) {
+    return lineVecHelper(PieceDirection::VERT, 0, colInd, 0);
+}
 
-    return extLen;
+/**
+ *  Slices the board to isolate a (/)-directional diagonal given a particular index.
+ *  Elements are ordered from the bottom-left element to the upper-right element.
+ *
+ *  Use the window size argument to acquire only a windowed look into the diagonal
+ **/
+MNKBoard::LineCells MNKBoard::getForwardDiagVec(int pieceRow, int pieceCol, int windowSize) {
+    return lineVecHelper(PieceDirection::FSD, pieceRow, pieceCol, windowSize);
 }
 
-int MNKBoard::updateHorzPos(const CellState player, std::tuple<int, int>& pieceL, std::tuple<int, int>& pieceR) {
-    // calculates additional chain length
-    int extLen = 0;
+/**
+ *  Slices the board to isolate a (\)-directional diagonal given a particular index.
+ *  Elements are ordered from the upper-left element to the bottom-right element.
+ *
+ *  A subslice can be acquired by specifying the window size argument.
+ **/
+MNKBoard::LineCells MNKBoard::getBackDiagVec(int pieceRow, int pieceCol, int windowSize) {
+    return lineVecHelper(PieceDirection::BSD, pieceRow, pieceCol, windowSize);
+}
 
-    if(std::get<1>(pieceL)-1 >= 0 && board[std::get<0>(pieceL)][std::get<1>(pieceL)-1] == player) {
-        std::get<1>(pieceL) -= 1;
-        extLen += 1;
+/**
+ * Unpacks the bits of a line (or the window of windowSize elements on each side of
+ * the given piece) into its cells ordered by increasing bit index.
+ * */
+MNKBoard::LineCells MNKBoard::lineVecHelper(PieceDirection dir, int pieceRow, int pieceCol, int windowSize) {
+    const LineBits lineMask = lineMasks[(int)dir][lineIndex(dir, pieceRow, pieceCol)];
+    const LineBits blackBits = getLineBits(CellState::black, dir, pieceRow, pieceCol);
+    const LineBits whiteBits = getLineBits(CellState::white, dir, pieceRow, pieceCol);
+
+    int lowBit = __builtin_ctzll(lineMask), highBit = 63 - __builtin_clzll(lineMask);
+    if(windowSize > 0) {
+        const int pieceBit = bitIndex(dir, pieceRow, pieceCol);
+        lowBit = std::max(lowBit, pieceBit - windowSize);
+        highBit = std::min(highBit, pieceBit + windowSize);
     }
-    if(std::get<1>(pieceR)+1 < numCols && board[std::get<0>(pieceR)][std::get<1>(pieceR)+1] == player) {
-        std::get<1>(pieceR) += 1;
-        extLen += 1;
+
+    LineCells lineCells;
+    for(int bit=lowBit; bit<=highBit; bit++) {
+        if((blackBits >> bit) & 1)
+            lineCells.cells[lineCells.numCells++] = CellState::black;
+        else if((whiteBits >> bit) & 1)
+            lineCells.cells[lineCells.numCells++] = CellState::white;
+        else
+            lineCells.cells[lineCells.numCells++] = CellState::none;
     }
 
-    return extLen;
+    return lineCells;
 }
 
-int MNKBoard::updateFSDPos(const CellState player, std::tuple<int, int>& pieceL, std::tuple<int, int>& pieceR) {
-    // calculates additional chain length
-    int extLen = 0;
-
-    if((std::get<0>(pieceL)+1 < numRows && std::get<1>(pieceL)-1 >=0) 
-                                         && board[std::get<0>(pieceL)+1][std::get<1>(pieceL)-1] == player) {
-        std::get<0>(pieceL) += 1;
-        std::get<1>(pieceL) -= 1;
-        extLen += 1;
-    }
-    if((std::get<0>(pieceR)-1 >= 0 && std::get<1>(pieceR)+1 < numCols)
-                                   && board[std::get<0>(pieceR)-1][std::get<1>(pieceR)+1] == player) {
-        std::get<0>(pieceR) -= 1;
-        std::get<1>(pieceR) += 1;
-        extLen += 1;
-    }
+/**
+ * Helper function that totals all "in-a-row" sequences starting from the last
+ * played piece. Each run holds its length, its direction and both of its end
+ * points, in the order BSD, FSD, HORZ, VERT.
+ **/
+std::array<MNKBoard::Run, MNKBoard::NUM_DIRS> MNKBoard::enumerateInARow(void) {
+    std::array<Run, NUM_DIRS> winList;
+    PieceDirection allDirs[4] = {PieceDirection::BSD, PieceDirection::FSD, PieceDirection::HORZ, PieceDirection::VERT};
+    const int row = std::get<0>(lastMove), col = std::get<1>(lastMove);
+    const CellState curPlayer = getCell(row, col);
 
-    return extLen;
-}
+    for(int dirInd=0; dirInd<NUM_DIRS; dirInd++) {
+        const PieceDirection dir = allDirs[dirInd];
+        int lowBit, highBit;
+        int runLen = runLength(getLineBits(curPlayer, dir, row, col), bitIndex(dir, row, col), lowBit, highBit);
 
-int MNKBoard::updateBSDPos(const CellState player, std::tuple<int, int>& pieceL, std::tuple<int, int>& pieceR) {
-    // calculates additional chain length
-    int extLen = 0;
+        // translate the run bounds back into board coordinates
+        winList[dirInd] = {runLen, dir, lineCell(dir, row, col, lowBit), lineCell(dir, row, col, highBit)};
 
-    if((std::get<0>(pieceL)-1 >= 0 && std::get<1>(pieceL)-1 >= 0) 
-                                   && board[std::get<0>(pieceL)-1][std::get<1>(pieceL)-1] == player) {
-        std::get<0>(pieceL) -= 1;
-        std::get<1>(pieceL) -= 1;
-        extLen += 1;
-    }
-    if((std::get<0>(pieceR)+1 < numRows && std::get<1>(pieceR)+1 < numCols) 
-                                         && board[std::get<0>(pieceR)+1][std::get<1>(pieceR)+1] == player) {
-        std::get<0>(pieceR) += 1;
-        std::get<1>(pieceR) += 1;
-        extLen += 1;
+        #ifdef MNK_VERBOSE
+        tuplePrinterHelper(winList[dirInd]);
+        #endif
     }
 
-    return extLen;
+    return winList;
 }
 
-// helper function for a known tuple format
+// helper function for a known run format
 #ifdef MNK_VERBOSE
-    void MNKBoard::tuplePrinterHelper(std::tuple<int, PieceDirection, std::tuple<int, int>, std::tuple<int, int>> tup) {
-            int inARowLen = std::get<0>(tup);
-            PieceDirection& curDir = std::get<1>(tup);
-            auto& pieceL = std::get<2>(tup);
-            auto& pieceR = std::get<3>(tup);
-
-            std::cout << "Updated tuple of length " << inARowLen << " located from loc (" << std::get<0>(pieceL) 
-                      << "," << std::get<1>(pieceL) << ") to loc (" << std::get<0>(pieceR) << "," 
+    void MNKBoard::tuplePrinterHelper(const Run& run) {
+            int inARowLen = run.length;
+            auto& pieceL = run.lowEnd;
+            auto& pieceR = run.highEnd;
+
+            std::cout << "Updated tuple of length " << inARowLen << " located from loc (" << std::get<0>(pieceL)
+                      << "," << std::get<1>(pieceL) << ") to loc (" << std::get<0>(pieceR) << ","
                       << std::get<1>(pieceR) << ")" << std::endl;
     }
 #endif
@@ -339,15 +497,16 @@ int MNKBoard::updateBSDPos(const CellState player, std::tuple<int, int>& pieceL,
 std::ostream& operator<<(std::ostream& ostream, const MNKBoard& board) {
     // makes printing the horizontal line simpler
     auto horzLPrinter = [&ostream, &board]() -> void {ostream << std::string(2*board.numCols+1, '-') << std::endl;};
-    
+
     // prints the board now
     horzLPrinter();
     for(int rowInd=0; rowInd<board.numRows; rowInd++) {
         ostream << "|";
         for(int colInd=0; colInd<board.numCols; colInd++) {
             std::string curPiece = " ";
-            if(board.board[rowInd][colInd] != CellState::none)
-                curPiece = board.board[rowInd][colInd]==CellState::black?"●":"○";
+            CellState cellVal = board.getCell(rowInd, colInd);
+            if(cellVal != CellState::none)
+                curPiece = cellVal==CellState::black?"●":"○";
             ostream << curPiece << "|";
         }
         ostream << std::endl;
@@ -355,4 +514,4 @@ std::ostream& operator<<(std::ostream& ostream, const MNKBoard& board) {
     }
 
     return ostream;
-}
\ No newline at end of file
+}
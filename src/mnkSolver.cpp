@@ -0,0 +1,395 @@
+#include "../include/mnkSolver.h"
+#include <algorithm>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+namespace {
+    // mixes a position key into a table index
+    inline std::uint64_t mixKey(std::uint64_t key) {
+        key ^= key >> 30;
+        key *= 0xBF58476D1CE4E5B9ULL;
+        key ^= key >> 27;
+        key *= 0x94D049BB133111EBULL;
+        return key ^ (key >> 31);
+    }
+
+    inline std::uint32_t blackBits(std::uint64_t key) { return static_cast<std::uint32_t>(key); }
+    inline std::uint32_t whiteBits(std::uint64_t key) { return static_cast<std::uint32_t>(key >> 32); }
+
+    // black is to move whenever both players have placed the same number of pieces
+    inline bool blackToMove(std::uint64_t key) {
+        return __builtin_popcount(blackBits(key)) == __builtin_popcount(whiteBits(key));
+    }
+
+    // ranges of work items owned by one thread (the owner pops the back, thieves the front)
+    struct RangeDeque {
+        std::mutex lock;
+        std::deque<std::pair<std::size_t, std::size_t>> ranges;
+    };
+}
+
+MNKSolver::MNKSolver(int m, int n, int k, int numThreads) : numRows(m), numCols(n), winSize(k),
+                                                            numCells(m*n), numThreads(numThreads),
+                                                            numPositions(0), tableFull(false) {
+    if(m <= 0 || n <= 0 || k <= 0 || m*n > MAX_CELLS)
+        throw std::invalid_argument("The solver only handles boards of at most 32 cells.");
+    if(this->numThreads <= 0)
+        this->numThreads = std::max(1u, std::thread::hardware_concurrency());
+
+    // mirror images and half turns exist for every board, quarter turns only for square ones
+    for(int transpose=0; transpose<(m == n ? 2 : 1); transpose++) {
+        for(int flipMask=0; flipMask<4; flipMask++) {
+            std::vector<int> cellMap(numCells);
+            for(int rowInd=0; rowInd<m; rowInd++) {
+                for(int colInd=0; colInd<n; colInd++) {
+                    int newRow = transpose ? colInd : rowInd, newCol = transpose ? rowInd : colInd;
+                    if(flipMask & 1)
+                        newRow = m-1 - newRow;
+                    if(flipMask & 2)
+                        newCol = n-1 - newCol;
+                    cellMap[rowInd*n + colInd] = newRow*n + newCol;
+                }
+            }
+            cellMaps.push_back(cellMap);
+        }
+    }
+
+    // collect every k-cell segment along the four directions
+    const int rowSteps[MNKBoard::NUM_DIRS] = {1, 0, -1, 1}, colSteps[MNKBoard::NUM_DIRS] = {0, 1, 1, 1};
+    for(int dirInd=0; dirInd<MNKBoard::NUM_DIRS; dirInd++) {
+        for(int rowInd=0; rowInd<m; rowInd++) {
+            for(int colInd=0; colInd<n; colInd++) {
+                const int endRow = rowInd + rowSteps[dirInd]*(k-1), endCol = colInd + colSteps[dirInd]*(k-1);
+                if(endRow < 0 || endRow >= m || endCol >= n)
+                    continue;
+
+                std::uint32_t segMask = 0;
+                for(int cellInd=0; cellInd<k; cellInd++)
+                    segMask |= std::uint32_t(1) << ((rowInd + rowSteps[dirInd]*cellInd)*n + colInd + colSteps[dirInd]*cellInd);
+                winMasks.push_back(segMask);
+            }
+        }
+    }
+}
+
+ProofValue MNKSolver::solve(void) {
+    MNKBoard board(numRows, numCols, winSize);
+    return solve(board);
+}
+
+ProofValue MNKSolver::solve(MNKBoard& board) {
+    if(std::get<0>(board.getBoardSize()) != numRows || std::get<1>(board.getBoardSize()) != numCols)
+        throw std::invalid_argument("The board does not match the solver dimensions.");
+
+    const std::uint64_t rootKey = positionKey(board);
+    const int numBlack = __builtin_popcount(blackBits(rootKey)), numWhite = __builtin_popcount(whiteBits(rootKey));
+    if(numBlack != numWhite && numBlack != numWhite + 1)
+        return ProofValue::unknown;
+
+    resetTable(MIN_TABLE_SIZE);
+    levels.assign(numCells+1, std::vector<std::uint64_t>());
+    const std::uint64_t rootCanonical = canonicalKey(rootKey);
+    insert(rootCanonical, terminalValue(rootCanonical));
+
+    // forward pass: every level is generated from the one before it
+    const int rootLevel = numBlack + numWhite;
+    levels[rootLevel].push_back(rootCanonical);
+    for(int levelInd=rootLevel; levelInd<numCells; levelInd++) {
+        expandLevel(levelInd);
+        collectLevel(levelInd+1);
+    }
+
+    // backward pass: values only depend on the next level
+    for(int levelInd=numCells; levelInd>=rootLevel; levelInd--)
+        evaluateLevel(levelInd);
+
+    return getValue(rootCanonical);
+}
+
+ProofValue MNKSolver::getValue(MNKBoard& board) const {
+    return getValue(canonicalKey(positionKey(board)));
+}
+
+ProofValue MNKSolver::getValue(std::uint64_t key) const {
+    if(tableSize == 0)
+        return ProofValue::unknown;
+    const std::size_t slot = findSlot(key);
+    if(tableKeys[slot].load(std::memory_order_relaxed) != key)
+        return ProofValue::unknown;
+    return static_cast<ProofValue>(tableValues[slot].load(std::memory_order_relaxed));
+}
+
+std::size_t MNKSolver::getNumPositions(void) const {
+    return numPositions.load();
+}
+
+/**
+ * File layout: "MNKT", the board dimensions and the number of records as 32-bit
+ * integers, then one record per position (64-bit canonical key, 8-bit value).
+ **/
+bool MNKSolver::saveTable(const std::string& filePath) const {
+    std::ofstream tableFile(filePath, std::ios::binary);
+    if(!tableFile)
+        return false;
+
+    const std::uint32_t header[4] = {static_cast<std::uint32_t>(numRows), static_cast<std::uint32_t>(numCols),
+                                     static_cast<std::uint32_t>(winSize), static_cast<std::uint32_t>(numPositions.load())};
+    tableFile.write("MNKT", 4);
+    tableFile.write(reinterpret_cast<const char*>(header), sizeof(header));
+    for(std::size_t slot=0; slot<tableSize; slot++) {
+        const std::uint64_t key = tableKeys[slot].load(std::memory_order_relaxed);
+        if(key == EMPTY_KEY)
+            continue;
+        const std::uint8_t value = tableValues[slot].load(std::memory_order_relaxed);
+        tableFile.write(reinterpret_cast<const char*>(&key), sizeof(key));
+        tableFile.write(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+    return static_cast<bool>(tableFile);
+}
+
+std::uint64_t MNKSolver::positionKey(MNKBoard& board) const {
+    std::uint64_t key = 0;
+    for(int cell=0; cell<numCells; cell++) {
+        const CellState state = board.getCell(cell / numCols, cell % numCols);
+        if(state == CellState::black)
+            key |= std::uint64_t(1) << cell;
+        else if(state == CellState::white)
+            key |= std::uint64_t(1) << (cell + 32);
+    }
+    return key;
+}
+
+std::uint64_t MNKSolver::canonicalKey(std::uint64_t key) const {
+    std::uint64_t minKey = key;
+    for(std::size_t symInd=1; symInd<cellMaps.size(); symInd++)
+        minKey = std::min(minKey, transformKey(key, symInd));
+    return minKey;
+}
+
+std::uint64_t MNKSolver::transformKey(std::uint64_t key, int sym) const {
+    const std::vector<int>& cellMap = cellMaps[sym];
+    std::uint64_t newKey = 0;
+    for(std::uint64_t pieceBits=key; pieceBits; pieceBits &= pieceBits - 1) {
+        const int bit = __builtin_ctzll(pieceBits);
+        newKey |= std::uint64_t(1) << (bit < 32 ? cellMap[bit] : cellMap[bit-32] + 32);
+    }
+    return newKey;
+}
+
+ProofValue MNKSolver::terminalValue(std::uint64_t key) const {
+    // a completed segment belongs to the player who just moved
+    for(std::uint32_t segMask : winMasks)
+        if((blackBits(key) & segMask) == segMask || (whiteBits(key) & segMask) == segMask)
+            return ProofValue::loss;
+    if(__builtin_popcountll(key) == numCells)
+        return ProofValue::draw;
+    return ProofValue::unknown;
+}
+
+void MNKSolver::resetTable(std::size_t newSize) {
+    tableSize = newSize;
+    tableKeys.reset(new std::atomic<std::uint64_t>[tableSize]);
+    tableValues.reset(new std::atomic<std::uint8_t>[tableSize]);
+    for(std::size_t slot=0; slot<tableSize; slot++) {
+        tableKeys[slot].store(EMPTY_KEY, std::memory_order_relaxed);
+        tableValues[slot].store(0, std::memory_order_relaxed);
+    }
+    numPositions = 0;
+    tableFull = false;
+}
+
+// doubles the table between parallel phases (no other thread touches it here)
+void MNKSolver::growTable(void) {
+    std::unique_ptr<std::atomic<std::uint64_t>[]> oldKeys = std::move(tableKeys);
+    std::unique_ptr<std::atomic<std::uint8_t>[]> oldValues = std::move(tableValues);
+    const std::size_t oldSize = tableSize;
+
+    resetTable(oldSize * 2);
+    for(std::size_t slot=0; slot<oldSize; slot++) {
+        const std::uint64_t key = oldKeys[slot].load(std::memory_order_relaxed);
+        if(key != EMPTY_KEY)
+            insert(key, static_cast<ProofValue>(oldValues[slot].load(std::memory_order_relaxed)));
+    }
+}
+
+/**
+ * Linear probing: a thread claims an empty slot with a compare and swap, and a thread
+ * that loses the race to the same key simply finds it in the slot.
+ **/
+bool MNKSolver::insert(std::uint64_t key, ProofValue value) {
+    std::size_t slot = mixKey(key) & (tableSize - 1);
+    while(true) {
+        std::uint64_t slotKey = tableKeys[slot].load(std::memory_order_acquire);
+        if(slotKey == key)
+            return true;
+
+        if(slotKey == EMPTY_KEY) {
+            // keep the load below 3/4 so that probe sequences stay short
+            if(numPositions.load(std::memory_order_relaxed) >= tableSize / 4 * 3) {
+                tableFull = true;
+                return false;
+            }
+            if(tableKeys[slot].compare_exchange_strong(slotKey, key, std::memory_order_acq_rel)) {
+                tableValues[slot].store(static_cast<std::uint8_t>(value), std::memory_order_relaxed);
+                numPositions.fetch_add(1, std::memory_order_relaxed);
+                return true;
+            }
+            if(slotKey == key)
+                return true;
+        }
+        slot = (slot + 1) & (tableSize - 1);
+    }
+}
+
+std::size_t MNKSolver::findSlot(std::uint64_t key) const {
+    std::size_t slot = mixKey(key) & (tableSize - 1);
+    while(true) {
+        const std::uint64_t slotKey = tableKeys[slot].load(std::memory_order_relaxed);
+        if(slotKey == key || slotKey == EMPTY_KEY)
+            return slot;
+        slot = (slot + 1) & (tableSize - 1);
+    }
+}
+
+/**
+ * Inserts the children of every undecided position of a level. Inserting is idempotent,
+ * so a level that ran out of table space is simply expanded again after growing it.
+ **/
+void MNKSolver::expandLevel(int levelInd) {
+    const std::vector<std::uint64_t>& level = levels[levelInd];
+    do {
+        if(tableFull)
+            growTable();
+
+        runParallel(level.size(), [&](std::size_t begin, std::size_t end) {
+            for(std::size_t posInd=begin; posInd<end && !tableFull; posInd++) {
+                const std::uint64_t key = level[posInd];
+                if(getValue(key) != ProofValue::unknown)
+                    continue;
+
+                const int pieceShift = blackToMove(key) ? 0 : 32;
+                for(std::uint32_t emptyBits=~(blackBits(key) | whiteBits(key)) & ((std::uint64_t(1) << numCells) - 1);
+                    emptyBits; emptyBits &= emptyBits - 1) {
+                    const std::uint64_t childKey = canonicalKey(key | (std::uint64_t(1) << (__builtin_ctz(emptyBits) + pieceShift)));
+                    if(!insert(childKey, terminalValue(childKey)))
+                        break;
+                }
+            }
+        });
+    } while(tableFull);
+}
+
+// gathers the positions of a level from the table
+void MNKSolver::collectLevel(int levelInd) {
+    std::mutex levelLock;
+    std::vector<std::uint64_t>& level = levels[levelInd];
+    level.clear();
+
+    runParallel(tableSize, [&](std::size_t begin, std::size_t end) {
+        std::vector<std::uint64_t> levelPart;
+        for(std::size_t slot=begin; slot<end; slot++) {
+            const std::uint64_t key = tableKeys[slot].load(std::memory_order_relaxed);
+            if(key != EMPTY_KEY && __builtin_popcountll(key) == levelInd)
+                levelPart.push_back(key);
+        }
+
+        std::lock_guard<std::mutex> guard(levelLock);
+        level.insert(level.end(), levelPart.begin(), levelPart.end());
+    });
+}
+
+/**
+ * Negamax over the solved children: a lost child makes the position a win, a drawn
+ * child a draw, and only children that all win make it a loss.
+ **/
+void MNKSolver::evaluateLevel(int levelInd) {
+    const std::vector<std::uint64_t>& level = levels[levelInd];
+    runParallel(level.size(), [&](std::size_t begin, std::size_t end) {
+        for(std::size_t posInd=begin; posInd<end; posInd++) {
+            const std::uint64_t key = level[posInd];
+            const std::size_t slot = findSlot(key);
+            if(tableValues[slot].load(std::memory_order_relaxed) != static_cast<std::uint8_t>(ProofValue::unknown))
+                continue;
+
+            const int pieceShift = blackToMove(key) ? 0 : 32;
+            ProofValue value = ProofValue::loss;
+            for(std::uint32_t emptyBits=~(blackBits(key) | whiteBits(key)) & ((std::uint64_t(1) << numCells) - 1);
+                emptyBits && value != ProofValue::win; emptyBits &= emptyBits - 1) {
+                const ProofValue childValue = getValue(canonicalKey(key | (std::uint64_t(1) << (__builtin_ctz(emptyBits) + pieceShift))));
+                if(childValue == ProofValue::loss)
+                    value = ProofValue::win;
+                else if(childValue == ProofValue::draw)
+                    value = ProofValue::draw;
+            }
+            tableValues[slot].store(static_cast<std::uint8_t>(value), std::memory_order_relaxed);
+        }
+    });
+}
+
+/**
+ * Every thread starts with an equal share of the items. Ranges larger than the grain
+ * are halved before they are worked on, with the upper halves pushed back onto the
+ * owner's deque where idle threads can steal them.
+ **/
+void MNKSolver::runParallel(std::size_t numItems, const std::function<void(std::size_t, std::size_t)>& work) {
+    const std::size_t grainSize = 256;
+    if(numItems <= grainSize || numThreads == 1) {
+        work(0, numItems);
+        return;
+    }
+
+    std::vector<RangeDeque> deques(numThreads);
+    for(int threadInd=0; threadInd<numThreads; threadInd++) {
+        const std::size_t begin = numItems*threadInd/numThreads, end = numItems*(threadInd+1)/numThreads;
+        if(begin < end)
+            deques[threadInd].ranges.emplace_back(begin, end);
+    }
+
+    std::atomic<std::size_t> numRemaining(numItems);
+    auto worker = [&](int selfInd) {
+        while(numRemaining.load() > 0) {
+            std::pair<std::size_t, std::size_t> range;
+            bool hasRange = false;
+            {
+                std::lock_guard<std::mutex> guard(deques[selfInd].lock);
+                if(!deques[selfInd].ranges.empty()) {
+                    range = deques[selfInd].ranges.back();
+                    deques[selfInd].ranges.pop_back();
+                    hasRange = true;
+                }
+            }
+            for(int offset=1; offset<numThreads && !hasRange; offset++) {
+                RangeDeque& victim = deques[(selfInd + offset) % numThreads];
+                std::lock_guard<std::mutex> guard(victim.lock);
+                if(!victim.ranges.empty()) {
+                    range = victim.ranges.front();
+                    victim.ranges.pop_front();
+                    hasRange = true;
+                }
+            }
+            if(!hasRange) {
+                std::this_thread::yield();
+                continue;
+            }
+
+            while(range.second - range.first > grainSize) {
+                const std::size_t midPoint = range.first + (range.second - range.first)/2;
+                std::lock_guard<std::mutex> guard(deques[selfInd].lock);
+                deques[selfInd].ranges.emplace_back(midPoint, range.second);
+                range.second = midPoint;
+            }
+            work(range.first, range.second);
+            numRemaining -= range.second - range.first;
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for(int threadInd=1; threadInd<numThreads; threadInd++)
+        threads.emplace_back(worker, threadInd);
+    worker(0);
+    for(std::thread& thread : threads)
+        thread.join();
+}
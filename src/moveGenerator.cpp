@@ -0,0 +1,201 @@
+#include <algorithm>
+#include <functional>
+#include <tuple>
+#include "../include/moveGenerator.h"
+
+namespace {
+    inline CellState otherPlayer(CellState player) {
+        return player == CellState::black ? CellState::white : CellState::black;
+    }
+}
+
+MoveGenerator::MoveGenerator(Omok& game, bool sortBatches) : game(game), player(game.getCurrentPlayer()),
+                                                             opponent(otherPlayer(game.getCurrentPlayer())),
+                                                             sortBatches(sortBatches) {
+    std::tie(numRows, numCols) = game.getBoardSize();
+    if(game.isFinished())
+        nextStage = Stage::done;
+}
+
+/**
+ * A non-empty batch of wins or blocks ends the generation. If every cell of such a stage
+ * is forbidden the game goes on with the regular moves (which lose, but are legal).
+ **/
+int MoveGenerator::nextBatch(int* moves) {
+    while(nextStage != Stage::done) {
+        const Stage stage = nextStage;
+        const int numMoves = collect(stage, moves);
+        if(numMoves > 0 && (stage == Stage::wins || stage == Stage::blocks))
+            nextStage = Stage::done;
+        else
+            nextStage = static_cast<Stage>(static_cast<int>(stage) + 1);
+
+        if(numMoves > 0) {
+            lastStage = stage;
+            sortMoves(moves, numMoves);
+            return numMoves;
+        }
+    }
+    return 0;
+}
+
+int MoveGenerator::generateAll(int* moves) {
+    if(nextStage == Stage::wins && game.getMoveCount() > 0)
+        return generateFresh(moves);
+
+    int numMoves = 0;
+    for(int batchSize=nextBatch(moves); batchSize>0; batchSize=nextBatch(moves+numMoves))
+        numMoves += batchSize;
+    return numMoves;
+}
+
+/**
+ * Reads every candidate once instead of once per stage. Fives and blocks are told by the
+ * cell scores alone, so the candidates are only written over once one of them turns out
+ * to be legal; the other moves are split into threats (in front) and quiet moves.
+ **/
+int MoveGenerator::generateFresh(int* moves) {
+    const int numCells = candidateCells(game, moves);
+    nextStage = Stage::done;
+    for(Stage stage : {Stage::wins, Stage::blocks}) {
+        int numMoves = 0;
+        for(int cellInd=0; cellInd<numCells; cellInd++) {
+            const int move = moves[cellInd];
+            if(inStage(stage, move / numCols, move % numCols) && !game.isForbidden(move / numCols, move % numCols))
+                moves[numMoves++] = move;
+        }
+        if(numMoves > 0) {
+            lastStage = stage;
+            sortMoves(moves, numMoves);
+            return numMoves;
+        }
+    }
+
+    int numMoves = 0, numThreats = 0;
+    for(int cellInd=0; cellInd<numCells; cellInd++) {
+        const int move = moves[cellInd];
+        const int row = move / numCols, col = move % numCols;
+        if(game.isForbidden(row, col))
+            continue;
+        moves[numMoves++] = move;
+        if(isThreat(row, col))
+            std::swap(moves[numThreats++], moves[numMoves-1]);
+    }
+    if(numMoves > 0)
+        lastStage = numMoves > numThreats ? Stage::quiet : Stage::threats;
+    sortMoves(moves, numThreats);
+    sortMoves(moves + numThreats, numMoves - numThreats);
+    return numMoves;
+}
+
+int MoveGenerator::generateWins(int* moves) {
+    if(nextStage != Stage::wins)
+        return 0;
+    const int numMoves = collect(Stage::wins, moves);
+    nextStage = numMoves > 0 ? Stage::done : Stage::blocks;
+    if(numMoves > 0)
+        lastStage = Stage::wins;
+    return numMoves;
+}
+
+int MoveGenerator::candidateCells(Omok& game, int* moves) {
+    const auto [numRows, numCols] = game.getBoardSize();
+
+    // the first move goes into the center
+    if(game.getMoveCount() == 0) {
+        moves[0] = (numRows/2)*numCols + numCols/2;
+        return 1;
+    }
+
+    const ThreatCache& threats = game.getThreats();
+    int numMoves = 0;
+    for(int rowInd=0; rowInd<numRows; rowInd++) {
+        LineBits nearBits = threats.getNearCells(rowInd) & game.getLine(CellState::none, PieceDirection::HORZ, rowInd);
+        for(; nearBits; nearBits &= nearBits - 1)
+            moves[numMoves++] = rowInd*numCols + __builtin_ctzll(nearBits);
+    }
+    return numMoves;
+}
+
+MoveGenerator::Stage MoveGenerator::getStage(void) const {
+    return lastStage;
+}
+
+// the candidates are filtered in place, the center of an empty board being a quiet move
+int MoveGenerator::collect(Stage stage, int* moves) {
+    if(game.getMoveCount() == 0)
+        return stage == Stage::quiet ? candidateCells(game, moves) : 0;
+
+    const int numCells = candidateCells(game, moves);
+    int numMoves = 0;
+    for(int cellInd=0; cellInd<numCells; cellInd++) {
+        const int rowInd = moves[cellInd] / numCols, colInd = moves[cellInd] % numCols;
+        if(inStage(stage, rowInd, colInd) && !game.isForbidden(rowInd, colInd))
+            moves[numMoves++] = moves[cellInd];
+    }
+    return numMoves;
+}
+
+bool MoveGenerator::inStage(Stage stage, int row, int col) const {
+    switch(stage) {
+        case Stage::wins:
+            return game.getThreats().getCellScore(player, row, col) >= ThreatCache::FIVE_SCORE;
+        case Stage::blocks:
+            return game.getThreats().getCellScore(opponent, row, col) >= ThreatCache::FIVE_SCORE;
+        case Stage::threats:
+            return isThreat(row, col);
+        case Stage::quiet:
+            return !isThreat(row, col);
+        default:
+            return false;
+    }
+}
+
+bool MoveGenerator::isThreat(int row, int col) const {
+    // the cell scores add up the directions, one of which scores at least a three if it forms a pattern
+    const ThreatCache& threats = game.getThreats();
+    if(threats.getCellScore(player, row, col) < ThreatCache::THREE_SCORE
+       && threats.getCellScore(opponent, row, col) < ThreatCache::THREE_SCORE)
+        return false;
+
+    for(CellState mover : {player, opponent}) {
+        for(int dirInd=0; dirInd<MNKBoard::NUM_DIRS; dirInd++) {
+            const LinePatterns::Pattern pattern = game.getLinePattern(row, col, mover, static_cast<PieceDirection>(dirInd));
+            if(pattern != LinePatterns::Pattern::none && pattern != LinePatterns::Pattern::overline)
+                return true;
+        }
+    }
+    return false;
+}
+
+int MoveGenerator::moveScore(int move) const {
+    const ThreatCache& threats = game.getThreats();
+    return threats.getCellScore(player, move) + threats.getCellScore(opponent, move);
+}
+
+/**
+ * Equal scores keep board order. Every move is scored once: the moves are sorted as
+ * score*cells + (cells-1-move), unless a five (only found in the short batches of fives
+ * and blocks) makes the score too large for that.
+ **/
+void MoveGenerator::sortMoves(int* moves, int numMoves) const {
+    if(!sortBatches)
+        return;
+    const int numCells = numRows*numCols;
+    bool isPacked = true;
+    for(int moveInd=0; moveInd<numMoves && isPacked; moveInd++)
+        isPacked = moveScore(moves[moveInd]) < ThreatCache::FIVE_SCORE;
+    if(!isPacked) {
+        std::sort(moves, moves + numMoves, [this](int firstMove, int secondMove) {
+            const int firstScore = moveScore(firstMove), secondScore = moveScore(secondMove);
+            return firstScore > secondScore || (firstScore == secondScore && firstMove < secondMove);
+        });
+        return;
+    }
+
+    for(int moveInd=0; moveInd<numMoves; moveInd++)
+        moves[moveInd] = moveScore(moves[moveInd])*numCells + (numCells-1 - moves[moveInd]);
+    std::sort(moves, moves + numMoves, std::greater<int>());
+    for(int moveInd=0; moveInd<numMoves; moveInd++)
+        moves[moveInd] = numCells-1 - moves[moveInd] % numCells;
+}
@@ -0,0 +1,251 @@
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <sstream>
+#include "../include/pbrainEngine.h"
+
+namespace {
+    // bits of INFO rule
+    const int EXACT_FIVE_RULE = 1;      // only exactly five wins
+    const int RENJU_RULE = 4;
+
+    std::string toUpper(std::string text) {
+        for(char& curChar : text)
+            curChar = static_cast<char>(std::toupper(static_cast<unsigned char>(curChar)));
+        return text;
+    }
+}
+
+int TimeControl::getMoveBudgetMs(int moveCount) const {
+    int budget = turnMs > 0 ? turnMs : MIN_MOVE_MS;
+    if(matchMs > 0 && timeLeftMs >= 0) {
+        const int movesToGo = std::max(MIN_MOVES_TO_GO, (EXPECTED_GAME_MOVES - moveCount) / 2);
+        budget = std::min(budget, timeLeftMs / movesToGo);
+    }
+    budget -= std::max(SAFETY_MS, budget / 10);
+    return std::max(budget, MIN_MOVE_MS);
+}
+
+PbrainEngine::PbrainEngine(bool ponder) : game(ruleSet), ponderEnabled(ponder), ponderGame(ruleSet), ponderStop(false) {}
+
+PbrainEngine::~PbrainEngine() {
+    stopPondering();
+}
+
+void PbrainEngine::run(std::istream& input, std::ostream& output) {
+    std::string line;
+    while(std::getline(input, line) && handleLine(line, output));
+    stopPondering();
+}
+
+bool PbrainEngine::handleLine(const std::string& line, std::ostream& output) {
+    std::istringstream lineStream(line);
+    std::string command, argument;
+    lineStream >> command;
+    command = toUpper(command);
+
+    // stones of a BOARD command come one per line until DONE
+    if(readingBoard) {
+        int moveX, moveY, field;
+        char firstComma, secondComma;
+        if(command == "DONE") {
+            readingBoard = false;
+            if(!searcher)
+                output << "ERROR no START received" << std::endl;
+            else if(!setBoard())
+                output << "ERROR the stones cannot come from a game" << std::endl;
+            else
+                playMove(output);
+        }
+        else if(std::sscanf(line.c_str(), "%d%c%d%c%d", &moveX, &firstComma, &moveY, &secondComma, &field) == 5
+                && firstComma == ',' && secondComma == ',' && (field == 1 || field == 2))
+            boardStones[field-1].emplace_back(moveY, moveX);
+        return true;
+    }
+
+    if(command.empty())
+        return true;
+    if(command == "END") {
+        stopPondering();
+        return false;
+    }
+    if(command == "INFO") {
+        std::string key;
+        lineStream >> key >> argument;
+        handleInfo(key, argument);
+        return true;
+    }
+    if(command == "ABOUT") {
+        output << "name=\"GomokuSolver\", version=\"1.0\", author=\"BrianMH\"" << std::endl;
+        return true;
+    }
+    if(command == "START") {
+        int boardSize = 0;
+        if(!(lineStream >> boardSize) || boardSize != BOARD_SIZE) {
+            output << "ERROR only " << BOARD_SIZE << "x" << BOARD_SIZE << " boards are supported" << std::endl;
+            return true;
+        }
+        newGame();
+        output << "OK" << std::endl;
+        return true;
+    }
+
+    // the remaining commands need a game
+    if(!searcher && (command == "RESTART" || command == "BEGIN" || command == "TURN" || command == "BOARD" || command == "TAKEBACK")) {
+        output << "ERROR no START received" << std::endl;
+        return true;
+    }
+    int row, col;
+    if(command == "RESTART") {
+        newGame();
+        output << "OK" << std::endl;
+    }
+    else if(command == "BEGIN")
+        playMove(output);
+    else if(command == "TURN") {
+        stopPondering();
+        if(!(lineStream >> argument) || !readCell(argument, row, col) || !game.placePiece(row, col))
+            output << "ERROR illegal move " << argument << std::endl;
+        else if(game.isFinished())
+            output << "ERROR the game is over" << std::endl;
+        else
+            playMove(output);
+    }
+    else if(command == "BOARD") {
+        stopPondering();
+        readingBoard = true;
+        boardStones[0].clear();
+        boardStones[1].clear();
+    }
+    else if(command == "TAKEBACK") {
+        stopPondering();
+        if(lineStream >> argument && readCell(argument, row, col) && game.getMoveCount() > 0
+           && game.getMove(game.getMoveCount()-1) == std::make_tuple(row, col)) {
+            game.unmakeMove();
+            output << "OK" << std::endl;
+        }
+        else
+            output << "ERROR only the last move can be taken back" << std::endl;
+    }
+    else
+        output << "UNKNOWN " << command << std::endl;
+    return true;
+}
+
+const Omok& PbrainEngine::getGame(void) const {
+    return game;
+}
+
+const TimeControl& PbrainEngine::getTimeControl(void) const {
+    return timeControl;
+}
+
+bool PbrainEngine::isPondering(void) const {
+    return ponderThread.joinable();
+}
+
+std::size_t PbrainEngine::getTableSizeMB(void) const {
+    return tableSizeMB;
+}
+
+void PbrainEngine::newGame(void) {
+    stopPondering();
+    readingBoard = false;
+    game = Omok(ruleSet);
+    resizeTable();
+}
+
+void PbrainEngine::resizeTable(void) {
+    std::size_t newSizeMB = DEFAULT_TT_MB;
+    if(maxMemory > 0)
+        newSizeMB = std::max<std::size_t>(1, std::min(newSizeMB, maxMemory / 2 / (1 << 20)));
+    if(searcher && newSizeMB == tableSizeMB)
+        return;
+    stopPondering();
+    searcher = std::make_unique<Searcher>(newSizeMB);
+    tableSizeMB = newSizeMB;
+}
+
+void PbrainEngine::playMove(std::ostream& output) {
+    stopPondering();
+    SearchLimits limits;
+    limits.maxTimeMs = timeControl.getMoveBudgetMs(game.getMoveCount());
+    const auto [row, col] = searcher->search(game, limits).bestMove;
+    if(!game.isPosEmpty(row, col) || !game.placePiece(row, col)) {
+        output << "ERROR no legal move" << std::endl;
+        return;
+    }
+
+    output << col << "," << row << std::endl;
+    if(!game.isFinished())
+        startPondering();
+}
+
+/**
+ * The engine is the side to move, so it plays black if both sides have as many stones
+ * and white if the opponent has one more. The manager gives the stones in no particular
+ * order, so they are set up without replaying the game under its rules.
+ **/
+bool PbrainEngine::setBoard(void) {
+    const bool isOwnBlack = boardStones[0].size() == boardStones[1].size();
+    game = Omok(ruleSet);
+    return game.setPosition(boardStones[isOwnBlack ? 0 : 1], boardStones[isOwnBlack ? 1 : 0]);
+}
+
+void PbrainEngine::handleInfo(const std::string& key, const std::string& value) {
+    long number = 0;
+    std::istringstream valueStream(value);
+    if(!(valueStream >> number))
+        return;
+
+    if(key == "timeout_turn")
+        timeControl.turnMs = static_cast<int>(number);
+    else if(key == "timeout_match")
+        timeControl.matchMs = static_cast<int>(number);
+    else if(key == "time_left")
+        timeControl.timeLeftMs = static_cast<int>(number);
+    else if(key == "max_memory") {
+        maxMemory = number;
+        // the manager sends INFO after START, so an empty board takes the new size at once
+        if(searcher && game.getMoveCount() == 0)
+            resizeTable();
+    }
+    else if(key == "rule") {
+        if(number & RENJU_RULE)
+            ruleSet = Omok::RuleSet::renju;
+        else
+            ruleSet = number & EXACT_FIVE_RULE ? Omok::RuleSet::standard : Omok::RuleSet::freestyle;
+        if(game.getMoveCount() == 0 && !isPondering())
+            game = Omok(ruleSet);
+    }
+}
+
+// searches the position with the opponent to move until the next command
+void PbrainEngine::startPondering(void) {
+    if(!ponderEnabled || !searcher)
+        return;
+    ponderStop = false;
+    ponderGame = game;
+    ponderThread = std::thread([this]() {
+        SearchLimits limits;
+        limits.stopFlag = &ponderStop;
+        searcher->search(ponderGame, limits);
+    });
+}
+
+void PbrainEngine::stopPondering(void) {
+    if(!ponderThread.joinable())
+        return;
+    ponderStop = true;
+    ponderThread.join();
+}
+
+bool PbrainEngine::readCell(const std::string& text, int& row, int& col) {
+    int moveX, moveY;
+    char comma, extra;
+    if(std::sscanf(text.c_str(), "%d%c%d%c", &moveX, &comma, &moveY, &extra) != 3 || comma != ',')
+        return false;
+    row = moveY;
+    col = moveX;
+    return true;
+}
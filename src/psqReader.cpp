@@ -0,0 +1,153 @@
+#include "../include/psqReader.h"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <filesystem>
+#include <thread>
+
+namespace fs = std::filesystem;
+
+namespace {
+    inline bool isDigit(char curChar) {
+        return curChar >= '0' && curChar <= '9';
+    }
+}
+
+PsqScanner::PsqScanner(const char* begin, const char* end) : curPos(begin), endPos(end) {}
+
+// reads up to 9 digits, so the value always fits
+bool PsqScanner::readNumber(int& number) {
+    const char* startPos = curPos;
+    number = 0;
+    while(curPos < endPos && isDigit(*curPos) && curPos - startPos < 9)
+        number = number*10 + (*curPos++ - '0');
+    return curPos > startPos && (curPos == endPos || !isDigit(*curPos));
+}
+
+void PsqScanner::skipLine(void) {
+    const void* lineEnd = curPos < endPos ? std::memchr(curPos, '\n', endPos - curPos) : nullptr;
+    curPos = lineEnd ? static_cast<const char*>(lineEnd) + 1 : endPos;
+}
+
+bool PsqScanner::readHeader(int& width, int& height) {
+    static const char HEADER[] = "Piskvorky";
+    const std::size_t headerLen = sizeof(HEADER) - 1;
+    const bool isHeader = std::size_t(endPos - curPos) > headerLen && std::memcmp(curPos, HEADER, headerLen) == 0;
+    if(isHeader) {
+        curPos += headerLen;
+        while(curPos < endPos && *curPos == ' ')
+            curPos++;
+    }
+
+    const bool isValid = isHeader && readNumber(width) && curPos < endPos && *curPos++ == 'x' && readNumber(height);
+    skipLine();
+    return isValid;
+}
+
+bool PsqScanner::nextMove(PsqMove& move) {
+    if(movesEnded || curPos >= endPos)
+        return false;
+
+    const char* lineStart = curPos;
+    bool isMove = readNumber(move.x) && curPos < endPos && *curPos++ == ','
+                  && readNumber(move.y) && curPos < endPos && *curPos++ == ','
+                  && readNumber(move.time);
+    // only trailing blanks may follow the three numbers
+    while(isMove && curPos < endPos && *curPos != '\n') {
+        if(*curPos != '\r' && *curPos != ' ')
+            isMove = false;
+        curPos++;
+    }
+
+    if(!isMove) {
+        curPos = lineStart;
+        movesEnded = true;
+        return false;
+    }
+    skipLine();
+    return true;
+}
+
+PsqReplayer::PsqReplayer(Omok::RuleSet ruleSet, int numThreads) : ruleSet(ruleSet), numThreads(numThreads) {
+    if(this->numThreads <= 0)
+        this->numThreads = std::max(1u, std::thread::hardware_concurrency());
+}
+
+std::vector<PsqReport> PsqReplayer::replay(const std::vector<std::string>& filePaths) const {
+    std::vector<PsqReport> reports(filePaths.size());
+    std::atomic<std::size_t> nextFile(0);
+
+    auto worker = [&]() {
+        Omok board(ruleSet);
+        while(true) {
+            const std::size_t firstFile = nextFile.fetch_add(CLAIM_SIZE);
+            if(firstFile >= filePaths.size())
+                break;
+            const std::size_t lastFile = std::min(firstFile + CLAIM_SIZE, filePaths.size());
+            for(std::size_t fileInd=firstFile; fileInd<lastFile; fileInd++)
+                reports[fileInd] = replayFile(board, filePaths[fileInd]);
+        }
+    };
+
+    const int poolSize = std::min<std::size_t>(numThreads, (filePaths.size() + CLAIM_SIZE - 1) / CLAIM_SIZE);
+    std::vector<std::thread> threads;
+    for(int threadInd=1; threadInd<poolSize; threadInd++)
+        threads.emplace_back(worker);
+    worker();
+    for(std::thread& thread : threads)
+        thread.join();
+    return reports;
+}
+
+PsqReport PsqReplayer::replayFile(Omok& board, const std::string& filePath) {
+    PsqReport report;
+    report.filePath = filePath;
+    report.expectedWinner = expectedWinner(filePath);
+    board.clearBoard();
+
+    const MappedFile inFile(filePath);
+    PsqScanner scanner(inFile.data(), inFile.data() + inFile.size());
+    int width, height;
+    if(!inFile.isOpen() || !scanner.readHeader(width, height) || width != BOARD_SIZE || height != BOARD_SIZE) {
+        report.readError = true;
+        return report;
+    }
+
+    // every move must be legal, the last one included
+    PsqMove move;
+    while(scanner.nextMove(move)) {
+        if(!board.placePiece(move.x-1, move.y-1)) {
+            report.illegalMove = report.numMoves;
+            break;
+        }
+        report.numMoves++;
+    }
+    report.winner = board.getGameWinner();
+    return report;
+}
+
+std::vector<std::string> PsqReplayer::listCorpus(const std::string& dirPath) {
+    std::vector<std::string> filePaths;
+    std::error_code errorCode;
+    for(fs::directory_iterator dirIter(dirPath, errorCode), dirEnd; !errorCode && dirIter != dirEnd; dirIter.increment(errorCode))
+        if(dirIter->path().extension() == ".psq")
+            filePaths.push_back(dirIter->path().string());
+    std::sort(filePaths.begin(), filePaths.end());
+    return filePaths;
+}
+
+int PsqReplayer::expectedWinner(const std::string& filePath) {
+    const std::string stem = fs::path(filePath).stem().string();
+    std::size_t fieldStart = 0;
+    for(int fieldInd=0; fieldInd<3; fieldInd++) {
+        fieldStart = stem.find('_', fieldStart);
+        if(fieldStart == std::string::npos)
+            return -1;
+        fieldStart++;
+    }
+
+    const std::string winField = stem.substr(fieldStart);
+    if(winField.size() != 1 || winField[0] < '0' || winField[0] > '2')
+        return -1;
+    return winField[0] - '0';
+}
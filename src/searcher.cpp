@@ -0,0 +1,317 @@
+#include "../include/searcher.h"
+#include "../include/moveGenerator.h"
+#include <algorithm>
+#include <iomanip>
+
+namespace {
+    const int TT_ORDER_SCORE = 1 << 26;
+    const int KILLER_ORDER_SCORE = 1 << 22;
+
+    inline CellState otherPlayer(CellState player) {
+        return player == CellState::black ? CellState::white : CellState::black;
+    }
+}
+
+Searcher::Searcher(std::size_t ttSizeMB) : ownTable(new TransTable(ttSizeMB)) {
+    table = ownTable.get();
+}
+
+Searcher::Searcher(TransTable& sharedTable) : table(&sharedTable) {}
+
+void Searcher::setInfoStream(std::ostream* stream) {
+    infoStream = stream;
+}
+
+bool Searcher::isWinScore(int score) {
+    return score >= WIN_SCORE - MAX_PLY || score <= -(WIN_SCORE - MAX_PLY);
+}
+
+/**
+ * Runs iterative deepening until the depth, node or time budget runs out. Every
+ * iteration past the second starts with a narrow aspiration window around the previous
+ * score and widens it whenever the result falls outside of it.
+ **/
+SearchResult Searcher::search(Omok& game, const SearchLimits& limits) {
+    SearchResult result;
+    std::tie(numRows, numCols) = game.getBoardSize();
+    curLimits = limits;
+    startTime = std::chrono::steady_clock::now();
+    nodes = 0;
+    aborted = false;
+
+    // reset the move ordering tables
+    for(auto& plyKillers : killers)
+        plyKillers[0] = plyKillers[1] = -1;
+    for(auto& playerHistory : history)
+        playerHistory.assign(numRows*numCols, 0);
+    for(int plyInd=0; plyInd<MAX_PLY; plyInd++) {
+        moveBuffers[plyInd].resize(numRows*numCols);
+        scoreBuffers[plyInd].resize(numRows*numCols);
+    }
+    // the age of a shared table is advanced by its owner, once for all of its searchers
+    if(ownTable)
+        table->newSearch();
+
+    if(game.isFinished())
+        return result;
+
+    // a legal fallback in case not even the first iteration completes
+    int numRootMoves = MoveGenerator(game, false).generateAll(moveBuffers[0].data());
+    if(numRootMoves == 0)
+        return result;
+    scoreMoves(game, moveBuffers[0].data(), scoreBuffers[0].data(), numRootMoves, -1, 0);
+    int fallbackMove = moveBuffers[0][std::max_element(scoreBuffers[0].begin(), scoreBuffers[0].begin()+numRootMoves)
+                                      - scoreBuffers[0].begin()];
+    result.bestMove = cellToMove(fallbackMove);
+    result.pv = {result.bestMove};
+
+    int prevScore = 0;
+    for(int depth=1; depth<=std::min(limits.maxDepth, MAX_PLY-1); depth++) {
+        int alpha = -INF_SCORE, beta = INF_SCORE;
+        int delta = ASPIRATION_DELTA;
+        if(depth >= 3 && !isWinScore(prevScore)) {
+            alpha = std::max(prevScore - delta, -INF_SCORE);
+            beta = std::min(prevScore + delta, INF_SCORE);
+        }
+
+        int score;
+        while(true) {
+            score = negamax(game, depth, alpha, beta, 0, true);
+            if(aborted)
+                break;
+
+            if(score <= alpha && alpha > -INF_SCORE) {
+                delta *= 2;
+                alpha = delta > WIN_SCORE ? -INF_SCORE : std::max(score - delta, -INF_SCORE);
+            } else if(score >= beta && beta < INF_SCORE) {
+                delta *= 2;
+                beta = delta > WIN_SCORE ? INF_SCORE : std::min(score + delta, INF_SCORE);
+            } else {
+                break;
+            }
+        }
+        if(aborted)
+            break;
+
+        // record the completed iteration
+        prevScore = score;
+        result.score = score;
+        result.depth = depth;
+        result.pv.clear();
+        for(int plyInd=0; plyInd<pvLength[0]; plyInd++)
+            result.pv.push_back(cellToMove(pvTable[0][plyInd]));
+        if(!result.pv.empty())
+            result.bestMove = result.pv.front();
+
+        if(infoStream) {
+            const double curElapsed = elapsedMs();
+            *infoStream << "depth " << depth << " score " << score << " nodes " << nodes
+                        << " nps " << (std::uint64_t)(nodes * 1000.0 / std::max(curElapsed, 1e-3))
+                        << " time " << std::fixed << std::setprecision(1) << curElapsed << " pv";
+            for(auto& move : result.pv)
+                *infoStream << " " << std::get<0>(move) << "," << std::get<1>(move);
+            *infoStream << std::endl;
+        }
+
+        // a forced result will not change with more depth
+        if(isWinScore(score))
+            break;
+    }
+
+    result.nodes = nodes;
+    result.elapsedMs = elapsedMs();
+    result.nodesPerSecond = (std::uint64_t)(nodes * 1000.0 / std::max(result.elapsedMs, 1e-3));
+    return result;
+}
+
+/**
+ * Negamax alpha-beta with principal variation search. Scores are relative to the
+ * side to move and wins are scored by their distance from the root.
+ **/
+int Searcher::negamax(Omok& game, int depth, int alpha, int beta, int ply, bool pvNode) {
+    pvLength[ply] = ply;
+    if(checkAbort())
+        return 0;
+    nodes++;
+
+    int* moves = moveBuffers[ply].data();
+    int* scores = scoreBuffers[ply].data();
+
+    // a position where the side to move completes five is won regardless of depth
+    MoveGenerator generator(game, false);
+    if(depth <= 0 || ply >= MAX_PLY-1) {
+        if(generator.generateWins(moves) > 0)
+            return WIN_SCORE - (ply+1);
+        return evaluate(game);
+    }
+
+    // in forcing positions only the fives, or else the blocks of the opponent's five, are generated
+    int numMoves = generator.generateAll(moves);
+    if(numMoves == 0)
+        return 0;   // full board (or only forbidden moves left) is a draw
+
+    // transposition table cutoffs are only taken outside of the principal variation. The
+    // table holds every position once for all of its symmetric images, with the moves
+    // stored as seen on the canonical image.
+    MNKBoard::Symmetry transform;
+    const std::uint64_t key = game.getCanonicalKey(transform);
+    int ttMove = -1;
+    TTEntry entry;
+    if(table->probe(key, entry)) {
+        if(entry.move >= 0) {
+            const auto [moveRow, moveCol] = game.inverseTransformCell(transform, entry.move / numCols, entry.move % numCols);
+            ttMove = moveRow*numCols + moveCol;
+        }
+        const int ttScore = scoreFromTT(entry.score, ply);
+        if(!pvNode && entry.depth >= depth && (entry.bound == BoundType::exact
+                                           || (entry.bound == BoundType::lower && ttScore >= beta)
+                                           || (entry.bound == BoundType::upper && ttScore <= alpha)))
+            return ttScore;
+    }
+
+    scoreMoves(game, moves, scores, numMoves, ttMove, ply);
+
+    const int origAlpha = alpha;
+    const int playerInd = MNKBoard::playerIndex(game.getCurrentPlayer());
+    int bestScore = -INF_SCORE, bestMove = -1;
+    for(int moveInd=0; moveInd<numMoves; moveInd++) {
+        // selection sort step: bring the best remaining move forward
+        int bestInd = moveInd;
+        for(int otherInd=moveInd+1; otherInd<numMoves; otherInd++)
+            if(scores[otherInd] > scores[bestInd])
+                bestInd = otherInd;
+        std::swap(moves[moveInd], moves[bestInd]);
+        std::swap(scores[moveInd], scores[bestInd]);
+
+        const int move = moves[moveInd];
+        if(!game.makeMove(move / numCols, move % numCols))
+            continue;
+
+        int score;
+        pvLength[ply+1] = ply+1;
+        if(game.isFinished()) {
+            score = WIN_SCORE - (ply+1);
+        } else if(bestMove < 0) {
+            score = -negamax(game, depth-1, -beta, -alpha, ply+1, pvNode);
+        } else {
+            score = -negamax(game, depth-1, -alpha-1, -alpha, ply+1, false);
+            if(score > alpha && score < beta)
+                score = -negamax(game, depth-1, -beta, -alpha, ply+1, true);
+        }
+        game.unmakeMove();
+        if(aborted)
+            return 0;
+
+        if(score > bestScore) {
+            bestScore = score;
+            bestMove = move;
+            if(score > alpha) {
+                alpha = score;
+
+                // extend the principal variation with the child's line
+                pvTable[ply][ply] = move;
+                for(int plyInd=ply+1; plyInd<pvLength[ply+1]; plyInd++)
+                    pvTable[ply][plyInd] = pvTable[ply+1][plyInd];
+                pvLength[ply] = std::max(pvLength[ply+1], ply+1);
+
+                if(alpha >= beta) {
+                    if(killers[ply][0] != move) {
+                        killers[ply][1] = killers[ply][0];
+                        killers[ply][0] = move;
+                    }
+                    history[playerInd][move] += depth * depth;
+                    break;
+                }
+            }
+        }
+    }
+
+    if(bestMove < 0)
+        return 0;
+
+    BoundType bound = BoundType::exact;
+    if(bestScore <= origAlpha)
+        bound = BoundType::upper;
+    else if(bestScore >= beta)
+        bound = BoundType::lower;
+    const auto [storedRow, storedCol] = game.transformCell(transform, bestMove / numCols, bestMove % numCols);
+    table->store(key, scoreToTT(bestScore, ply), depth, bound, storedRow*numCols + storedCol);
+
+    return bestScore;
+}
+
+/**
+ * Orders moves by: transposition table move, killer moves, then the threat value of the
+ * cell for both players (as kept by the game's threat cache) plus the history score.
+ **/
+void Searcher::scoreMoves(Omok& game, const int* moves, int* scores, int numMoves, int ttMove, int ply) {
+    const CellState player = game.getCurrentPlayer();
+    const CellState opponent = otherPlayer(player);
+    const int playerInd = MNKBoard::playerIndex(player);
+
+    for(int moveInd=0; moveInd<numMoves; moveInd++) {
+        const int move = moves[moveInd];
+        const int row = move / numCols, col = move % numCols;
+
+        if(move == ttMove) {
+            scores[moveInd] = TT_ORDER_SCORE;
+            continue;
+        }
+
+        const ThreatCache& threats = game.getThreats();
+        int moveScore = threats.getCellScore(player, row, col) + threats.getCellScore(opponent, row, col);
+        if(move == killers[ply][0] || move == killers[ply][1])
+            moveScore += KILLER_ORDER_SCORE;
+        scores[moveInd] = moveScore + std::min(history[playerInd][move], KILLER_ORDER_SCORE - 1);
+    }
+}
+
+/**
+ * Counts every 5-cell window of every line that a player can still complete,
+ * weighted by how many of its cells the player already holds. The sums are kept
+ * up to date by the game's threat cache.
+ **/
+int Searcher::evaluate(Omok& game) {
+    const CellState player = game.getCurrentPlayer();
+    const ThreatCache& threats = game.getThreats();
+    const int score = threats.getLineScore(player) - threats.getLineScore(otherPlayer(player));
+    return std::clamp(score, -(WIN_SCORE - 2*MAX_PLY), WIN_SCORE - 2*MAX_PLY);
+}
+
+/**
+ * Checks the node and time budgets (the clock only every few thousand nodes)
+ **/
+bool Searcher::checkAbort(void) {
+    if(aborted)
+        return true;
+    if((curLimits.stopFlag && curLimits.stopFlag->load(std::memory_order_relaxed))
+       || (curLimits.maxNodes && nodes >= curLimits.maxNodes)
+       || (curLimits.maxTimeMs && (nodes & 2047) == 0 && elapsedMs() >= curLimits.maxTimeMs))
+        aborted = true;
+    return aborted;
+}
+
+double Searcher::elapsedMs(void) const {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+}
+
+// win scores are stored relative to the node so they stay valid at other plies
+int Searcher::scoreToTT(int score, int ply) const {
+    if(score >= WIN_SCORE - MAX_PLY)
+        return score + ply;
+    if(score <= -(WIN_SCORE - MAX_PLY))
+        return score - ply;
+    return score;
+}
+
+int Searcher::scoreFromTT(int score, int ply) const {
+    if(score >= WIN_SCORE - MAX_PLY)
+        return score - ply;
+    if(score <= -(WIN_SCORE - MAX_PLY))
+        return score + ply;
+    return score;
+}
+
+std::tuple<int, int> Searcher::cellToMove(int cell) const {
+    return std::make_tuple(cell / numCols, cell % numCols);
+}
@@ -0,0 +1,194 @@
+#include "../include/threatCache.h"
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+namespace {
+    typedef LinePatterns::Pattern Pattern;
+
+    // value of a 5-cell window that is free of opponent pieces, by number of own pieces
+    const int WINDOW_SCORES[6] = {0, 1, 8, 60, 400, 400};
+
+    // threat value of the run a move creates when it forms no pattern, by run length
+    const int RUN_SCORES[5] = {0, 1, 6, 40, 300};
+    // threat value of the line pattern a move creates (none, broken three, open three,
+    // four, open four, overline); fives score FIVE_SCORE
+    const int PATTERN_SCORES[6] = {0, ThreatCache::THREE_SCORE, 120, 600, 900, 0};
+
+    /**
+     * Threat score of every pattern window. Fours and threes are scored by their pattern;
+     * shorter runs still count for a little more when their ends are open. A run that
+     * forms no pattern is at most four long, so it and its ends lie inside the window.
+     **/
+    std::vector<int> buildDirScores(void) {
+        std::vector<int> scores(LinePatterns::TABLE_SIZE);
+        for(int patternInd=0; patternInd<LinePatterns::TABLE_SIZE; patternInd++) {
+            const Pattern pattern = LinePatterns::getPattern(patternInd);
+            if(pattern == Pattern::five) {
+                scores[patternInd] = ThreatCache::FIVE_SCORE;
+                continue;
+            }
+            if(pattern != Pattern::none) {
+                scores[patternInd] = PATTERN_SCORES[static_cast<int>(pattern)];
+                continue;
+            }
+
+            // base-3 digits of the window: 0 blocked, 1 own piece, 2 empty
+            int digits[LinePatterns::WINDOW_SIZE];
+            for(int cellInd=0, rest=patternInd % LinePatterns::WINDOW_STATES; cellInd<LinePatterns::WINDOW_SIZE; cellInd++, rest/=3)
+                digits[cellInd] = rest % 3;
+            if(digits[LinePatterns::CENTER] != 1)
+                continue;
+
+            int lowBit = LinePatterns::CENTER, highBit = LinePatterns::CENTER;
+            while(lowBit > 0 && digits[lowBit-1] == 1)
+                lowBit--;
+            while(highBit < LinePatterns::WINDOW_SIZE-1 && digits[highBit+1] == 1)
+                highBit++;
+            const int runLen = std::min(highBit - lowBit + 1, 4);
+            const int openEnds = (lowBit > 0 && digits[lowBit-1] == 2) + (highBit < LinePatterns::WINDOW_SIZE-1 && digits[highBit+1] == 2);
+            scores[patternInd] = RUN_SCORES[runLen] * (openEnds + 1);
+        }
+        return scores;
+    }
+
+    const std::vector<int> DIR_SCORES = buildDirScores();
+}
+
+ThreatCache::ThreatCache(int numRows, int numCols, BoardArena* arena) : numRows(numRows), numCols(numCols),
+                                                                        storage(storageSize(numRows, numCols), arena) {
+    bindArrays();
+    std::memset(storage.data(), 0, storageSize(numRows, numCols));
+}
+
+ThreatCache::ThreatCache(const ThreatCache& otherCache, BoardArena* arena) : numRows(otherCache.numRows), numCols(otherCache.numCols),
+                                                                            storage(storageSize(numRows, numCols), arena) {
+    bindArrays();
+    *this = otherCache;
+}
+
+ThreatCache& ThreatCache::operator=(const ThreatCache& otherCache) {
+    if(this == &otherCache)
+        return *this;
+    if(!storage.data() || numRows != otherCache.numRows || numCols != otherCache.numCols) {
+        numRows = otherCache.numRows;
+        numCols = otherCache.numCols;
+        storage = ArenaBlock(storageSize(numRows, numCols), storage.getArena());
+        bindArrays();
+    }
+    std::memcpy(storage.data(), otherCache.storage.data(), storageSize(numRows, numCols));
+    totalLineScores[0] = otherCache.totalLineScores[0];
+    totalLineScores[1] = otherCache.totalLineScores[1];
+    return *this;
+}
+
+// the rows of near cells first (8-byte aligned), then the int arrays, then the near counts
+std::size_t ThreatCache::storageSize(int numRows, int numCols) {
+    const std::size_t numCells = numRows*numCols, maxLines = numRows+numCols-1;
+    const std::size_t numInts = 2*MNKBoard::NUM_DIRS*numCells*2 + 2*numCells + 2*MNKBoard::NUM_DIRS*maxLines;
+    return numRows*sizeof(LineBits) + numInts*sizeof(int) + numCells;
+}
+
+void ThreatCache::bindArrays(void) {
+    const int numCells = numRows*numCols, maxLines = numRows+numCols-1;
+    nearRows = static_cast<LineBits*>(storage.data());
+    int* intArrays = reinterpret_cast<int*>(nearRows + numRows);
+    for(int playerInd=0; playerInd<2; playerInd++) {
+        for(int dirInd=0; dirInd<MNKBoard::NUM_DIRS; dirInd++) {
+            patternInds[playerInd][dirInd] = intArrays;
+            dirScores[playerInd][dirInd] = intArrays + numCells;
+            lineScores[playerInd][dirInd] = intArrays + 2*numCells;
+            intArrays += 2*numCells + maxLines;
+        }
+        cellScores[playerInd] = intArrays;
+        intArrays += numCells;
+    }
+    nearCounts = reinterpret_cast<unsigned char*>(intArrays);
+}
+
+void ThreatCache::reset(const MNKBoard& board) {
+    const int numCells = numRows*numCols;
+    std::fill_n(nearCounts, numCells, 0);
+    std::fill_n(nearRows, numRows, 0);
+    for(int rowInd=0; rowInd<numRows; rowInd++)
+        for(int colInd=0; colInd<numCols; colInd++)
+            if(board.getCell(rowInd, colInd) != CellState::none)
+                addNear(rowInd, colInd, 1);
+
+    for(int playerInd=0; playerInd<2; playerInd++) {
+        const CellState player = playerInd == 0 ? CellState::black : CellState::white;
+        std::fill_n(cellScores[playerInd], numCells, 0);
+        totalLineScores[playerInd] = 0;
+        for(int dirInd=0; dirInd<MNKBoard::NUM_DIRS; dirInd++) {
+            const PieceDirection dir = static_cast<PieceDirection>(dirInd);
+            std::fill_n(dirScores[playerInd][dirInd], numCells, 0);
+            for(int rowInd=0; rowInd<numRows; rowInd++)
+                for(int colInd=0; colInd<numCols; colInd++)
+                    refreshCell(playerInd, dirInd, rowInd*numCols + colInd, board.getLineBits(player, dir, rowInd, colInd),
+                                board.getLineBits(CellState::none, dir, rowInd, colInd), MNKBoard::bitIndex(dir, rowInd, colInd));
+
+            std::fill_n(lineScores[playerInd][dirInd], board.getNumLines(dir), 0);
+            for(int lineInd=0; lineInd<board.getNumLines(dir); lineInd++)
+                refreshLine(board, playerInd, dir, lineInd);
+        }
+    }
+}
+
+void ThreatCache::update(const MNKBoard& board, int row, int col) {
+    addNear(row, col, board.getCell(row, col) != CellState::none ? 1 : -1);
+    for(int dirInd=0; dirInd<MNKBoard::NUM_DIRS; dirInd++) {
+        const PieceDirection dir = static_cast<PieceDirection>(dirInd);
+        const int bit = MNKBoard::bitIndex(dir, row, col);
+        const int lineInd = board.lineIndex(dir, row, col);
+        const LineBits emptyBits = board.getLine(CellState::none, dir, lineInd);
+        for(int playerInd=0; playerInd<2; playerInd++) {
+            const LineBits ownBits = board.getLine(playerInd == 0 ? CellState::black : CellState::white, dir, lineInd);
+            for(int lineBit=std::max(0, bit-LinePatterns::CENTER-1); lineBit<=bit+LinePatterns::CENTER+1; lineBit++) {
+                const auto [cellRow, cellCol] = MNKBoard::lineCell(dir, row, col, lineBit);
+                if(cellRow >= 0 && cellRow < numRows && cellCol >= 0 && cellCol < numCols)
+                    refreshCell(playerInd, dirInd, cellRow*numCols + cellCol, ownBits, emptyBits, lineBit);
+            }
+            refreshLine(board, playerInd, dir, lineInd);
+        }
+    }
+}
+
+void ThreatCache::refreshCell(int playerInd, int dirInd, int cellInd, LineBits ownBits, LineBits emptyBits, int bit) {
+    const int patternInd = LinePatterns::windowIndex(ownBits, emptyBits, bit);
+    const int score = DIR_SCORES[patternInd];
+    patternInds[playerInd][dirInd][cellInd] = patternInd;
+    cellScores[playerInd][cellInd] += score - dirScores[playerInd][dirInd][cellInd];
+    dirScores[playerInd][dirInd][cellInd] = score;
+}
+
+void ThreatCache::refreshLine(const MNKBoard& board, int playerInd, PieceDirection dir, int lineInd) {
+    const LineBits ownBits = board.getLine(playerInd == 0 ? CellState::black : CellState::white, dir, lineInd);
+    const LineBits freeBits = ownBits | board.getLine(CellState::none, dir, lineInd);
+    const int score = lineScore(ownBits, freeBits);
+    totalLineScores[playerInd] += score - lineScores[playerInd][(int)dir][lineInd];
+    lineScores[playerInd][(int)dir][lineInd] = score;
+}
+
+void ThreatCache::addNear(int row, int col, int delta) {
+    for(int nearRow=std::max(0, row-NEAR_DIST); nearRow<=std::min(numRows-1, row+NEAR_DIST); nearRow++) {
+        for(int nearCol=std::max(0, col-NEAR_DIST); nearCol<=std::min(numCols-1, col+NEAR_DIST); nearCol++) {
+            unsigned char& count = nearCounts[nearRow*numCols + nearCol];
+            count += delta;
+            if(count)
+                nearRows[nearRow] |= LineBits(1) << nearCol;
+            else
+                nearRows[nearRow] &= ~(LineBits(1) << nearCol);
+        }
+    }
+}
+
+int ThreatCache::lineScore(LineBits ownBits, LineBits freeBits) {
+    LineBits windowStarts = freeBits & (freeBits >> 1) & (freeBits >> 2) & (freeBits >> 3) & (freeBits >> 4);
+    int score = 0;
+    while(windowStarts) {
+        const int startBit = __builtin_ctzll(windowStarts);
+        score += WINDOW_SCORES[__builtin_popcountll((ownBits >> startBit) & 0x1F)];
+        windowStarts &= windowStarts - 1;
+    }
+    return score;
+}
@@ -0,0 +1,339 @@
+#include "../include/threatSearch.h"
+#include <algorithm>
+
+namespace {
+    typedef MNKBoard::PieceDirection PieceDirection;
+    typedef MNKBoard::LineBits LineBits;
+
+    // five points of a single move: at most two per direction
+    const int MAX_FIVE_POINTS = 2 * MNKBoard::NUM_DIRS;
+
+    inline CellState otherPlayer(CellState player) {
+        return player == CellState::black ? CellState::white : CellState::black;
+    }
+
+    inline void addUnique(std::vector<int>& cells, int cell) {
+        if(std::find(cells.begin(), cells.end(), cell) == cells.end())
+            cells.push_back(cell);
+    }
+}
+
+ThreatSolver::ThreatSolver(std::uint64_t nodeLimit) : nodeLimit(nodeLimit) {}
+
+ThreatSearchResult ThreatSolver::solveVCF(Omok& game, int maxDepth) {
+    resetSearch(game, std::max(0, maxDepth) + 1);
+    const bool win = !game.isFinished() && vcf(game, maxDepth, 0);
+    return makeResult(win);
+}
+
+ThreatSearchResult ThreatSolver::solveVCT(Omok& game, int maxDepth) {
+    // the VCF attempts of the deepest threat nodes run on the plies below them
+    resetSearch(game, std::max(0, maxDepth) + VCF_DEPTH_IN_VCT + 1);
+    const bool win = !game.isFinished() && vct(game, maxDepth, 0);
+    return makeResult(win);
+}
+
+/**
+ * Continuous fours: the attacker makes a four, the defender fills the five point
+ * (unless it can complete five itself) and the search continues from there.
+ **/
+bool ThreatSolver::vcf(Omok& game, int depth, int ply) {
+    if(checkLimit())
+        return false;
+    if(playFive(game, ply))
+        return true;
+    if(depth <= 0)
+        return false;
+
+    const std::uint64_t key = game.getHashKey();
+    auto failedIt = failedVCF.find(key);
+    if(failedIt != failedVCF.end() && failedIt->second >= depth)
+        return false;
+
+    const CellState attacker = game.getCurrentPlayer();
+    const CellState defender = otherPlayer(attacker);
+
+    // a pending four of the defender has to be blocked first (two cannot be blocked)
+    PlyBuffers& buffers = plyBuffers[ply];
+    int* defenderFives = buffers.defenderFives.data();
+    const int numDefenderFives = findFivePoints(game, defender, defenderFives);
+    if(numDefenderFives >= 2)
+        return false;
+
+    int* candidates = buffers.candidates.data();
+    int numCandidates = 1;
+    if(numDefenderFives == 1)
+        candidates[0] = defenderFives[0];
+    else
+        numCandidates = collectNear(game, attacker, 2, candidates);
+
+    int fivePoints[MAX_FIVE_POINTS];
+    for(int candInd=0; candInd<numCandidates; candInd++) {
+        const int row = candidates[candInd] / numCols, col = candidates[candInd] % numCols;
+        if(fivePointsAfter(game, attacker, row, col, fivePoints) == 0 || !game.makeMove(row, col))
+            continue;
+
+        // the defender wins first if it can complete five
+        if(findFivePoints(game, defender, defenderFives) > 0) {
+            game.unmakeMove();
+            continue;
+        }
+
+        // a defender that cannot legally block loses to the five point
+        const int block = fivePoints[0];
+        if(!game.makeMove(block / numCols, block % numCols)) {
+            game.unmakeMove();
+            buffers.line.assign(1, candidates[candInd]);
+            return true;
+        }
+
+        const bool isWin = vcf(game, depth-1, ply+1);
+        game.unmakeMove();
+        game.unmakeMove();
+        if(isWin) {
+            const std::vector<int>& subLine = plyBuffers[ply+1].line;
+            buffers.line.assign({candidates[candInd], block});
+            buffers.line.insert(buffers.line.end(), subLine.begin(), subLine.end());
+            return true;
+        }
+        if(limitReached)
+            return false;
+    }
+
+    failedVCF[key] = depth;
+    return false;
+}
+
+/**
+ * Continuous threats: like VCF, but the attacker may also play moves forming open threes.
+ * A three is answered by each empty cell of the matched three patterns and by every four
+ * the defender can make, and the attacker has to win against all of these replies.
+ **/
+bool ThreatSolver::vct(Omok& game, int depth, int ply) {
+    if(checkLimit())
+        return false;
+    if(playFive(game, ply))
+        return true;
+    if(depth <= 0)
+        return false;
+
+    const std::uint64_t key = game.getHashKey();
+    auto failedIt = failedVCT.find(key);
+    if(failedIt != failedVCT.end() && failedIt->second >= depth)
+        return false;
+
+    const CellState attacker = game.getCurrentPlayer();
+    const CellState defender = otherPlayer(attacker);
+
+    PlyBuffers& buffers = plyBuffers[ply];
+    int* defenderFives = buffers.defenderFives.data();
+    const int numDefenderFives = findFivePoints(game, defender, defenderFives);
+    if(numDefenderFives >= 2)
+        return false;
+
+    // fours alone are much cheaper to refute, so try them first
+    if(vcf(game, VCF_DEPTH_IN_VCT, ply+1)) {
+        buffers.line = plyBuffers[ply+1].line;
+        return true;
+    }
+    if(limitReached)
+        return false;
+
+    int* candidates = buffers.candidates.data();
+    int numCandidates = 1;
+    if(numDefenderFives == 1)
+        candidates[0] = defenderFives[0];
+    else
+        numCandidates = collectNear(game, attacker, 2, candidates);
+
+    int fivePoints[MAX_FIVE_POINTS];
+    std::vector<int>& defenses = buffers.defenses;
+    for(int candInd=0; candInd<numCandidates; candInd++) {
+        const int row = candidates[candInd] / numCols, col = candidates[candInd] % numCols;
+
+        // collect the forced replies before the move is made
+        defenses.clear();
+        const int numFivePoints = fivePointsAfter(game, attacker, row, col, fivePoints);
+        if(numFivePoints > 0) {
+            defenses.push_back(fivePoints[0]);
+        } else {
+            for(int dirInd=0; dirInd<MNKBoard::NUM_DIRS; dirInd++) {
+                const PieceDirection dir = static_cast<PieceDirection>(dirInd);
+                LineBits gapBits = game.openThreeGaps(row, col, attacker, dir);
+                while(gapBits) {
+                    const auto gapCell = MNKBoard::lineCell(dir, row, col, __builtin_ctzll(gapBits));
+                    addUnique(defenses, std::get<0>(gapCell)*numCols + std::get<1>(gapCell));
+                    gapBits &= gapBits - 1;
+                }
+            }
+        }
+        if(defenses.empty() || !game.makeMove(row, col))
+            continue;
+
+        if(findFivePoints(game, defender, defenderFives) > 0) {
+            game.unmakeMove();
+            continue;
+        }
+
+        // against a three the defender may also counter with a four of its own
+        if(numFivePoints == 0) {
+            int* nearCells = buffers.nearCells.data();
+            const int numNear = collectNear(game, defender, 2, nearCells);
+            for(int nearInd=0; nearInd<numNear; nearInd++)
+                if(fivePointsAfter(game, defender, nearCells[nearInd] / numCols, nearCells[nearInd] % numCols, fivePoints) > 0)
+                    addUnique(defenses, nearCells[nearInd]);
+        }
+
+        // every legal reply has to lose for the threat to count
+        bool allWin = true;
+        std::vector<int>& firstLine = buffers.firstLine;
+        firstLine.clear();
+        for(int defense : defenses) {
+            if(!game.makeMove(defense / numCols, defense % numCols))
+                continue;
+
+            const bool isWin = !game.isFinished() && vct(game, depth-1, ply+1);
+            game.unmakeMove();
+            if(!isWin) {
+                allWin = false;
+                break;
+            }
+            if(firstLine.empty()) {
+                const std::vector<int>& subLine = plyBuffers[ply+1].line;
+                firstLine.push_back(defense);
+                firstLine.insert(firstLine.end(), subLine.begin(), subLine.end());
+            }
+        }
+        game.unmakeMove();
+
+        if(allWin) {
+            buffers.line.assign(1, candidates[candInd]);
+            buffers.line.insert(buffers.line.end(), firstLine.begin(), firstLine.end());
+            return true;
+        }
+        if(limitReached)
+            return false;
+    }
+
+    failedVCT[key] = depth;
+    return false;
+}
+
+bool ThreatSolver::playFive(Omok& game, int ply) {
+    int* fiveCells = plyBuffers[ply].fiveCells.data();
+    const int numFives = findFivePoints(game, game.getCurrentPlayer(), fiveCells);
+    for(int fiveInd=0; fiveInd<numFives; fiveInd++) {
+        // the rules may still forbid the move
+        if(!game.makeMove(fiveCells[fiveInd] / numCols, fiveCells[fiveInd] % numCols))
+            continue;
+        const bool isWin = game.isFinished();
+        game.unmakeMove();
+        if(isWin) {
+            plyBuffers[ply].line.assign(1, fiveCells[fiveInd]);
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * A five point always touches one of the player's pieces, so only the direct
+ * neighbourhood of the pieces has to be scanned.
+ **/
+int ThreatSolver::findFivePoints(Omok& game, CellState player, int* cells) {
+    int numBoardRows, numBoardCols;
+    std::tie(numBoardRows, numBoardCols) = game.getBoardSize();
+
+    int numFives = 0;
+    for(int rowInd=0; rowInd<numBoardRows; rowInd++)
+        for(LineBits nearBits=nearRowBits(game, player, 1, rowInd); nearBits; nearBits &= nearBits - 1) {
+            const int col = __builtin_ctzll(nearBits);
+            if(game.getThreats().getCellScore(player, rowInd, col) >= ThreatCache::FIVE_SCORE)
+                cells[numFives++] = rowInd*numBoardCols + col;
+        }
+    return numFives;
+}
+
+/**
+ * Reads the cells completing exactly five together with the move from the cached
+ * pattern of every line through the move.
+ **/
+int ThreatSolver::fivePointsAfter(Omok& game, CellState player, int row, int col, int* cells) {
+    const int numBoardCols = std::get<1>(game.getBoardSize());
+    int numFives = 0;
+    for(int dirInd=0; dirInd<MNKBoard::NUM_DIRS; dirInd++) {
+        const PieceDirection dir = static_cast<PieceDirection>(dirInd);
+        const int patternInd = game.getThreats().getPatternIndex(player, dir, row, col);
+        for(LineBits fiveBits=LinePatterns::fivePoints(patternInd, MNKBoard::bitIndex(dir, row, col)); fiveBits; fiveBits &= fiveBits - 1) {
+            const auto fiveCell = MNKBoard::lineCell(dir, row, col, __builtin_ctzll(fiveBits));
+            const int cell = std::get<0>(fiveCell)*numBoardCols + std::get<1>(fiveCell);
+            if(std::find(cells, cells+numFives, cell) == cells+numFives)
+                cells[numFives++] = cell;
+        }
+    }
+    return numFives;
+}
+
+/**
+ * Dilates the rows of the player's pieces by dist cells in every direction
+ **/
+MNKBoard::LineBits ThreatSolver::nearRowBits(Omok& game, CellState player, int dist, int row) {
+    const int numBoardRows = std::get<0>(game.getBoardSize());
+    LineBits nearBits = 0;
+    for(int nearRow=std::max(0, row-dist); nearRow<=std::min(numBoardRows-1, row+dist); nearRow++) {
+        const LineBits rowBits = game.getLine(player, PieceDirection::HORZ, nearRow);
+        for(int shiftVal=0; shiftVal<=dist; shiftVal++)
+            nearBits |= (rowBits << shiftVal) | (rowBits >> shiftVal);
+    }
+    return nearBits & game.getLine(CellState::none, PieceDirection::HORZ, row);
+}
+
+int ThreatSolver::collectNear(Omok& game, CellState player, int dist, int* cells) {
+    int numBoardRows, numBoardCols;
+    std::tie(numBoardRows, numBoardCols) = game.getBoardSize();
+
+    int numCells = 0;
+    for(int rowInd=0; rowInd<numBoardRows; rowInd++)
+        for(LineBits nearBits=nearRowBits(game, player, dist, rowInd); nearBits; nearBits &= nearBits - 1)
+            cells[numCells++] = rowInd*numBoardCols + __builtin_ctzll(nearBits);
+    return numCells;
+}
+
+bool ThreatSolver::checkLimit(void) {
+    if(++nodes > nodeLimit)
+        limitReached = true;
+    return limitReached;
+}
+
+void ThreatSolver::resetSearch(Omok& game, int numPlies) {
+    nodes = 0;
+    limitReached = false;
+    int numRows;
+    std::tie(numRows, numCols) = game.getBoardSize();
+    numCells = numRows*numCols;
+    failedVCF.clear();
+    failedVCT.clear();
+
+    // a line never holds more moves than there are cells, so the reserved lines do not grow
+    if(static_cast<int>(plyBuffers.size()) < numPlies)
+        plyBuffers.resize(numPlies);
+    for(int plyInd=0; plyInd<numPlies; plyInd++) {
+        PlyBuffers& buffers = plyBuffers[plyInd];
+        for(std::vector<int>* cells : {&buffers.defenderFives, &buffers.candidates, &buffers.fiveCells, &buffers.nearCells})
+            cells->resize(numCells);
+        for(std::vector<int>* cells : {&buffers.defenses, &buffers.firstLine, &buffers.line})
+            cells->reserve(numCells);
+    }
+}
+
+ThreatSearchResult ThreatSolver::makeResult(bool win) const {
+    const std::vector<int>& line = plyBuffers[0].line;
+    ThreatSearchResult result;
+    result.win = win;
+    result.limitReached = !win && limitReached;
+    result.nodes = nodes;
+    if(win)
+        for(int cell : line)
+            result.sequence.emplace_back(cell / numCols, cell % numCols);
+    return result;
+}
@@ -0,0 +1,413 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <thread>
+#include "../include/tournament.h"
+
+namespace fs = std::filesystem;
+
+namespace {
+    const double CONFIDENCE_Z = 1.959964;     // two-sided 95%
+
+    // the whole text must be a number
+    bool readNumber(const std::string& text, double& number) {
+        char* endPos = nullptr;
+        number = std::strtod(text.c_str(), &endPos);
+        return !text.empty() && *endPos == '\0' && std::isfinite(number);
+    }
+
+    bool readCount(const std::string& text, long long& count) {
+        double number;
+        if(!readNumber(text, number) || number < 0 || number != std::floor(number) || number > 1e15)
+            return false;
+        count = static_cast<long long>(number);
+        return true;
+    }
+
+    // expected score against an opponent rated elo points lower
+    double eloToScore(double elo) {
+        return 1.0 / (1.0 + std::pow(10.0, -elo / 400.0));
+    }
+
+    double scoreToElo(double score) {
+        if(score <= 0)
+            return -std::numeric_limits<double>::infinity();
+        if(score >= 1)
+            return std::numeric_limits<double>::infinity();
+        return -400.0 * std::log10(1.0 / score - 1.0);
+    }
+
+    // variance of the points of a single game
+    double scoreVariance(const MatchStats& stats) {
+        const double score = stats.getScore();
+        return (stats.wins * (1 - score) * (1 - score) + stats.draws * (0.5 - score) * (0.5 - score)
+                + stats.losses * score * score) / stats.getGames();
+    }
+
+    bool hasLegalMove(Omok& game) {
+        const auto [numRows, numCols] = game.getBoardSize();
+        for(int rowInd=0; rowInd<numRows; rowInd++)
+            for(int colInd=0; colInd<numCols; colInd++)
+                if(game.isPosEmpty(rowInd, colInd) && !game.isForbidden(rowInd, colInd))
+                    return true;
+        return false;
+    }
+}
+
+bool EngineConfig::parse(const std::string& spec, EngineConfig& config) {
+    config = EngineConfig();
+    config.name = spec;
+    const std::size_t colonPos = spec.find(':');
+    const std::string engineType = spec.substr(0, colonPos);
+    if(engineType == "ab")
+        config.type = Type::alphaBeta;
+    else if(engineType == "mcts")
+        config.type = Type::mcts;
+    else
+        return false;
+
+    bool hasLimit = false, hasPlayouts = false;
+    std::istringstream options(colonPos == std::string::npos ? "" : spec.substr(colonPos + 1));
+    std::string option;
+    while(std::getline(options, option, ',')) {
+        const std::size_t equalPos = option.find('=');
+        if(equalPos == std::string::npos)
+            return false;
+        const std::string key = option.substr(0, equalPos), value = option.substr(equalPos + 1);
+        long long count;
+        double number;
+        if(key == "name" && !value.empty())
+            config.name = value;
+        else if(key == "ms" && readCount(value, count) && count <= std::numeric_limits<int>::max()) {
+            config.searchLimits.maxTimeMs = config.mctsLimits.maxTimeMs = static_cast<int>(count);
+            hasLimit = true;
+        }
+        else if(config.type == Type::alphaBeta) {
+            if(key == "depth" && readCount(value, count) && count > 0 && count <= Searcher::MAX_PLY)
+                config.searchLimits.maxDepth = static_cast<int>(count);
+            else if(key == "nodes" && readCount(value, count))
+                config.searchLimits.maxNodes = count;
+            else if(key == "tt" && readCount(value, count) && count > 0)
+                config.ttSizeMB = count;
+            else
+                return false;
+            hasLimit = true;
+        }
+        else if(key == "playouts" && readCount(value, count)) {
+            config.mctsLimits.maxPlayouts = count;
+            hasPlayouts = true;
+        }
+        else if(key == "threads" && readCount(value, count) && count > 0 && count <= std::numeric_limits<int>::max())
+            config.mctsConfig.numThreads = static_cast<int>(count);
+        else if(key == "c" && readNumber(value, number) && number >= 0)
+            config.mctsConfig.exploration = number;
+        else if(key == "puct" && readCount(value, count) && count <= 1)
+            config.mctsConfig.usePuct = count;
+        else if(key == "seed" && readCount(value, count))
+            config.mctsConfig.seed = count;
+        else
+            return false;
+    }
+
+    if(config.type == Type::alphaBeta && !hasLimit)
+        config.searchLimits.maxDepth = DEFAULT_DEPTH;
+    if(config.type == Type::mcts && config.mctsLimits.maxTimeMs > 0 && !hasPlayouts)
+        config.mctsLimits.maxPlayouts = 0;
+    return config.type == Type::alphaBeta || config.mctsLimits.maxPlayouts > 0 || config.mctsLimits.maxTimeMs > 0;
+}
+
+int EngineConfig::getMoveTimeMs(void) const {
+    return type == Type::alphaBeta ? searchLimits.maxTimeMs : mctsLimits.maxTimeMs;
+}
+
+MatchEngine::MatchEngine(const EngineConfig& config) : config(config) {
+    if(config.type == EngineConfig::Type::alphaBeta)
+        searcher = std::make_unique<Searcher>(config.ttSizeMB);
+    else
+        mctsSearcher = std::make_unique<MctsSearcher>(config.mctsConfig);
+}
+
+// the transposition table is kept, as its entries stay valid from one game to the next
+void MatchEngine::newGame(void) {
+    if(mctsSearcher)
+        mctsSearcher->clearTree();
+}
+
+std::tuple<int, int> MatchEngine::chooseMove(Omok& game) {
+    if(searcher)
+        return searcher->search(game, config.searchLimits).bestMove;
+    return mctsSearcher->search(game, config.mctsLimits).bestMove;
+}
+
+const EngineConfig& MatchEngine::getConfig(void) const {
+    return config;
+}
+
+void MatchStats::addGame(const MatchGame& game) {
+    if(game.winner == 0)
+        draws++;
+    else if((game.winner == 1) == game.firstIsBlack)
+        wins++;
+    else
+        losses++;
+}
+
+long MatchStats::getGames(void) const {
+    return wins + draws + losses;
+}
+
+double MatchStats::getScore(void) const {
+    return getGames() ? (wins + 0.5 * draws) / getGames() : 0.5;
+}
+
+double MatchStats::getEloDiff(void) const {
+    return scoreToElo(getScore());
+}
+
+double MatchStats::getEloError(void) const {
+    const double score = getScore();
+    if(getGames() == 0 || score <= 0 || score >= 1)
+        return std::numeric_limits<double>::infinity();
+    const double scoreError = CONFIDENCE_Z * std::sqrt(scoreVariance(*this) / getGames());
+    return (scoreToElo(score + scoreError) - scoreToElo(score - scoreError)) / 2;
+}
+
+/**
+ * The score of a game is taken as normally distributed with the variance seen so far,
+ * which gives LLR = n (s1 - s0) (2 s - s0 - s1) / (2 var) for the mean score s and the
+ * expected scores s0, s1 of the two hypotheses.
+ **/
+double MatchStats::getLLR(double elo0, double elo1) const {
+    if(getGames() == 0)
+        return 0;
+    const double variance = scoreVariance(*this);
+    if(variance <= 0)
+        return 0;
+    const double score0 = eloToScore(elo0), score1 = eloToScore(elo1);
+    return getGames() * (score1 - score0) * (2 * getScore() - score0 - score1) / (2 * variance);
+}
+
+double SprtConfig::getLowerBound(void) const {
+    return std::log(beta / (1 - alpha));
+}
+
+double SprtConfig::getUpperBound(void) const {
+    return std::log((1 - beta) / alpha);
+}
+
+SprtConfig::Result SprtConfig::check(const MatchStats& stats) const {
+    const double llr = stats.getLLR(elo0, elo1);
+    if(llr >= getUpperBound())
+        return Result::acceptH1;
+    if(llr <= getLowerBound())
+        return Result::acceptH0;
+    return Result::running;
+}
+
+Tournament::Tournament(const EngineConfig& first, const EngineConfig& second, const TournamentConfig& config)
+    : first(first), second(second), config(config) {}
+
+bool Tournament::run(std::ostream* progress) {
+    openings.clear();
+    if(!config.bookPath.empty()) {
+        if(!readBook(config.bookPath, config.ruleSet, openings) || openings.empty())
+            return false;
+        std::mt19937_64 randGen(config.seed);
+        std::shuffle(openings.begin(), openings.end(), randGen);
+    }
+    if(!config.psqDir.empty()) {
+        std::error_code errorCode;
+        fs::create_directories(config.psqDir, errorCode);
+    }
+
+    stats = MatchStats();
+    sprtResult = SprtConfig::Result::running;
+    const long numGames = 2 * ((std::max(config.numGames, 0L) + 1) / 2);
+    std::atomic<long> nextGame(0);
+    std::atomic<bool> stopMatch(false);
+    std::mutex statsMutex;
+
+    auto worker = [&]() {
+        MatchEngine firstEngine(first), secondEngine(second);
+        Omok game(config.ruleSet);
+        while(!stopMatch.load()) {
+            const long gameInd = nextGame.fetch_add(1);
+            if(gameInd >= numGames)
+                break;
+
+            // the second game of a pair swaps the colours
+            const bool firstIsBlack = gameInd % 2 == 0;
+            firstEngine.newGame();
+            secondEngine.newGame();
+            MatchGame played = firstIsBlack ? playGame(firstEngine, secondEngine, pairOpening(gameInd / 2), config, game)
+                                            : playGame(secondEngine, firstEngine, pairOpening(gameInd / 2), config, game);
+            played.firstIsBlack = firstIsBlack;
+            if(!config.psqDir.empty()) {
+                const std::string fileName = "game_" + std::to_string(gameInd) + "_" + std::to_string(played.moves.size())
+                                             + "_" + std::to_string(played.winner) + ".psq";
+                writePsq((fs::path(config.psqDir) / fileName).string(), played, firstIsBlack ? first.name : second.name,
+                         firstIsBlack ? second.name : first.name);
+            }
+
+            // games still running when the test decides are counted all the same
+            std::lock_guard<std::mutex> statsLock(statsMutex);
+            stats.addGame(played);
+            if(config.sprt.isEnabled && sprtResult == SprtConfig::Result::running) {
+                sprtResult = config.sprt.check(stats);
+                if(sprtResult != SprtConfig::Result::running)
+                    stopMatch = true;
+            }
+            if(progress && config.reportInterval > 0 && stats.getGames() % config.reportInterval == 0)
+                *progress << first.name << " vs " << second.name << "  games " << stats.getGames() << ": " << summary() << std::endl;
+        }
+    };
+
+    int numThreads = config.numThreads > 0 ? config.numThreads : std::max(1u, std::thread::hardware_concurrency());
+    numThreads = static_cast<int>(std::min<long>(numThreads, std::max(numGames, 1L)));
+    std::vector<std::thread> threads;
+    for(int threadInd=1; threadInd<numThreads; threadInd++)
+        threads.emplace_back(worker);
+    worker();
+    for(std::thread& thread : threads)
+        thread.join();
+    return true;
+}
+
+const MatchStats& Tournament::getStats(void) const {
+    return stats;
+}
+
+SprtConfig::Result Tournament::getSprtResult(void) const {
+    return sprtResult;
+}
+
+std::string Tournament::summary(void) const {
+    char line[160];
+    std::snprintf(line, sizeof(line), "+%ld =%ld -%ld  score %.3f  elo %+.1f +/- %.1f", stats.wins, stats.draws, stats.losses,
+                  stats.getScore(), stats.getEloDiff(), stats.getEloError());
+    std::string text = line;
+    if(config.sprt.isEnabled) {
+        std::snprintf(line, sizeof(line), "  LLR %.2f [%.2f, %.2f]", stats.getLLR(config.sprt.elo0, config.sprt.elo1),
+                      config.sprt.getLowerBound(), config.sprt.getUpperBound());
+        text += line;
+        if(sprtResult == SprtConfig::Result::acceptH0)
+            text += " H0 accepted";
+        else if(sprtResult == SprtConfig::Result::acceptH1)
+            text += " H1 accepted";
+    }
+    return text;
+}
+
+bool Tournament::readBook(const std::string& bookPath, Omok::RuleSet ruleSet, std::vector<std::vector<std::tuple<int, int>>>& openings) {
+    std::ifstream bookFile(bookPath);
+    if(!bookFile)
+        return false;
+
+    Omok game(ruleSet);
+    std::string line, moveText;
+    while(std::getline(bookFile, line)) {
+        std::istringstream lineStream(line);
+        std::vector<std::tuple<int, int>> opening;
+        bool isValid = true;
+        game.clearBoard();
+        while(isValid && lineStream >> moveText) {
+            if(opening.empty() && moveText[0] == '#')
+                break;
+            int moveX, moveY;
+            char comma, extra;
+            if(std::sscanf(moveText.c_str(), "%d%c%d%c", &moveX, &comma, &moveY, &extra) != 3 || comma != ','
+               || game.isFinished() || !game.placePiece(moveX-1, moveY-1))
+                isValid = false;
+            else
+                opening.emplace_back(moveX-1, moveY-1);
+        }
+        if(isValid && !opening.empty() && !game.isFinished())
+            openings.push_back(opening);
+    }
+    return true;
+}
+
+MatchGame Tournament::playGame(MatchEngine& black, MatchEngine& white, const std::vector<std::tuple<int, int>>& opening,
+                               const TournamentConfig& config, Omok& game) {
+    MatchGame played;
+    game.clearBoard();
+    for(const std::tuple<int, int>& move : opening) {
+        game.placePiece(std::get<0>(move), std::get<1>(move));
+        played.moves.push_back(move);
+        played.times.push_back(0);
+    }
+    played.openingLength = opening.size();
+
+    while(!game.isFinished()) {
+        if(game.getMoveCount() >= config.maxMoves) {
+            played.termination = MatchGame::Termination::draw;
+            return played;
+        }
+        const CellState player = game.getCurrentPlayer();
+        MatchEngine& engine = player == CellState::black ? black : white;
+        const auto startTime = std::chrono::steady_clock::now();
+        const auto [row, col] = engine.chooseMove(game);
+        const int moveTime = static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                                                  std::chrono::steady_clock::now() - startTime).count());
+
+        // the engine to move loses on time or on an illegal move, unless it had none to play
+        const int timeLimit = engine.getConfig().getMoveTimeMs();
+        const bool isLate = timeLimit > 0 && moveTime > timeLimit + config.timeMarginMs;
+        if(isLate || !game.placePiece(row, col)) {
+            if(!isLate && !hasLegalMove(game)) {
+                played.termination = MatchGame::Termination::draw;
+                return played;
+            }
+            played.termination = isLate ? MatchGame::Termination::timeForfeit : MatchGame::Termination::illegalMove;
+            played.winner = player == CellState::black ? 2 : 1;
+            return played;
+        }
+        played.moves.emplace_back(row, col);
+        played.times.push_back(moveTime);
+    }
+
+    played.termination = MatchGame::Termination::five;
+    played.winner = game.getGameWinner();
+    return played;
+}
+
+bool Tournament::writePsq(const std::string& filePath, const MatchGame& game, const std::string& blackName, const std::string& whiteName) {
+    std::ofstream psqFile(filePath);
+    psqFile << "Piskvorky " << BOARD_SIZE << "x" << BOARD_SIZE << ", 11:11, 0\n";
+    for(std::size_t moveInd=0; moveInd<game.moves.size(); moveInd++)
+        psqFile << std::get<0>(game.moves[moveInd]) + 1 << "," << std::get<1>(game.moves[moveInd]) + 1 << ","
+                << game.times[moveInd] << "\n";
+    psqFile << blackName << "\n" << whiteName << "\n-1\n";
+    return static_cast<bool>(psqFile);
+}
+
+// a random opening is played on legal cells around the centre and never finishes the game
+std::vector<std::tuple<int, int>> Tournament::pairOpening(long pairInd) const {
+    if(!openings.empty())
+        return openings[pairInd % openings.size()];
+
+    std::mt19937_64 randGen(config.seed * 0x9E3779B97F4A7C15ULL + pairInd);
+    Omok game(config.ruleSet);
+    std::vector<std::tuple<int, int>> opening;
+    const int areaStart = (BOARD_SIZE - OPENING_AREA) / 2;
+    for(int numTries=0; static_cast<int>(opening.size()) < config.randomPlies && numTries < 100*config.randomPlies; numTries++) {
+        const int row = areaStart + randGen() % OPENING_AREA, col = areaStart + randGen() % OPENING_AREA;
+        if(!game.placePiece(row, col))
+            continue;
+        if(game.isFinished()) {
+            game.unmakeMove();
+            continue;
+        }
+        opening.emplace_back(row, col);
+    }
+    return opening;
+}
@@ -0,0 +1,164 @@
+#include "../include/transTable.h"
+#include <algorithm>
+
+// layout of the packed data word
+//  bits  0-15 : score (signed)
+//  bits 16-23 : depth
+//  bits 24-25 : bound type
+//  bits 26-31 : age of the search that wrote the entry
+//  bits 32-47 : move (0xFFFF when there is no move)
+namespace {
+    const int AGE_BITS = 6;
+    const std::uint8_t AGE_MASK = (1 << AGE_BITS) - 1;
+}
+
+TransTable::TransTable(std::size_t sizeMB) : curAge(0) {
+    // round the number of buckets down to a power of two so that the index is a simple mask
+    std::size_t maxBuckets = std::max<std::size_t>(1, (sizeMB * 1024 * 1024) / sizeof(Bucket));
+    numBuckets = 1;
+    while(numBuckets * 2 <= maxBuckets)
+        numBuckets *= 2;
+
+    buckets.reset(new Bucket[numBuckets]);
+    clear();
+}
+
+/**
+ * Finds the bucket a key maps onto
+ **/
+TransTable::Bucket& TransTable::getBucket(std::uint64_t key) const {
+    return buckets[key & (numBuckets - 1)];
+}
+
+/**
+ * An entry is only accepted if its two words XOR back to the key, which
+ * rejects both foreign keys and entries torn by a concurrent write.
+ **/
+bool TransTable::probe(std::uint64_t key, TTEntry& entry) const {
+    const Bucket& bucket = getBucket(key);
+    for(int entryInd=0; entryInd<ENTRIES_PER_BUCKET; entryInd++) {
+        const std::uint64_t keyWord = bucket.words[2*entryInd].load(std::memory_order_relaxed);
+        const std::uint64_t dataWord = bucket.words[2*entryInd+1].load(std::memory_order_relaxed);
+        if((keyWord ^ dataWord) != key)
+            continue;
+
+        entry = unpackEntry(dataWord);
+        if(entry.bound != BoundType::none)
+            return true;
+    }
+
+    return false;
+}
+
+/**
+ * Replacement policy: an entry of the same position is always overwritten (keeping its
+ * move if the new result has none). Otherwise the entry with the lowest depth is replaced,
+ * where entries of older searches lose value the older they get.
+ **/
+void TransTable::store(std::uint64_t key, int score, int depth, BoundType bound, int move) {
+    Bucket& bucket = getBucket(key);
+    const std::uint8_t age = getAge();
+
+    int replaceInd = 0;
+    int replaceVal = MAX_DEPTH * 2;
+    for(int entryInd=0; entryInd<ENTRIES_PER_BUCKET; entryInd++) {
+        const std::uint64_t keyWord = bucket.words[2*entryInd].load(std::memory_order_relaxed);
+        const std::uint64_t dataWord = bucket.words[2*entryInd+1].load(std::memory_order_relaxed);
+        const TTEntry oldEntry = unpackEntry(dataWord);
+
+        if((keyWord ^ dataWord) == key) {
+            if(move < 0)
+                move = oldEntry.move;
+            replaceInd = entryInd;
+            break;
+        }
+
+        // empty entries are always the first choice
+        int entryVal = -MAX_DEPTH;
+        if(oldEntry.bound != BoundType::none)
+            entryVal = oldEntry.depth - 8 * ((age - entryAge(dataWord)) & AGE_MASK);
+        if(entryVal < replaceVal) {
+            replaceVal = entryVal;
+            replaceInd = entryInd;
+        }
+    }
+
+    const std::uint64_t dataWord = packEntry(score, depth, bound, move, age);
+    bucket.words[2*replaceInd].store(key ^ dataWord, std::memory_order_relaxed);
+    bucket.words[2*replaceInd+1].store(dataWord, std::memory_order_relaxed);
+}
+
+void TransTable::prefetch(std::uint64_t key) const {
+    __builtin_prefetch(&getBucket(key));
+}
+
+// the counter wraps at 256, a multiple of the 64 ages, so it is masked when read
+void TransTable::newSearch(void) {
+    curAge.fetch_add(1, std::memory_order_relaxed);
+}
+
+int TransTable::getAge(void) const {
+    return curAge.load(std::memory_order_relaxed) & AGE_MASK;
+}
+
+/**
+ * Zeroed words describe an empty entry (its bound type is BoundType::none)
+ **/
+void TransTable::clear(void) {
+    for(std::size_t bucketInd=0; bucketInd<numBuckets; bucketInd++)
+        for(auto& word : buckets[bucketInd].words)
+            word.store(0, std::memory_order_relaxed);
+    curAge.store(0, std::memory_order_relaxed);
+}
+
+/**
+ * Samples the first thousand buckets (or fewer for tiny tables) and reports how many
+ * of their entries, in permille, were written by the current search.
+ **/
+int TransTable::hashfull(void) const {
+    const std::size_t numSampled = std::min<std::size_t>(1000, numBuckets);
+    const std::uint8_t age = getAge();
+    std::size_t numUsed = 0;
+    for(std::size_t bucketInd=0; bucketInd<numSampled; bucketInd++)
+        for(int entryInd=0; entryInd<ENTRIES_PER_BUCKET; entryInd++) {
+            const std::uint64_t dataWord = buckets[bucketInd].words[2*entryInd+1].load(std::memory_order_relaxed);
+            if(unpackEntry(dataWord).bound != BoundType::none && entryAge(dataWord) == age)
+                numUsed++;
+        }
+
+    return (int)(numUsed * 1000 / (numSampled * ENTRIES_PER_BUCKET));
+}
+
+std::size_t TransTable::getNumBuckets(void) const {
+    return numBuckets;
+}
+
+std::size_t TransTable::getSizeBytes(void) const {
+    return numBuckets * sizeof(Bucket);
+}
+
+std::uint64_t TransTable::packEntry(int score, int depth, BoundType bound, int move, std::uint8_t age) {
+    score = std::clamp(score, MIN_SCORE, MAX_SCORE);
+    depth = std::clamp(depth, 0, MAX_DEPTH);
+    const std::uint64_t moveBits = move < 0 ? 0xFFFF : (std::uint64_t)(move & 0xFFFF);
+
+    return (std::uint64_t)(std::uint16_t)score
+         | ((std::uint64_t)depth << 16)
+         | ((std::uint64_t)bound << 24)
+         | ((std::uint64_t)(age & AGE_MASK) << 26)
+         | (moveBits << 32);
+}
+
+TTEntry TransTable::unpackEntry(std::uint64_t data) {
+    TTEntry entry;
+    entry.score = (std::int16_t)(data & 0xFFFF);
+    entry.depth = (int)((data >> 16) & 0xFF);
+    entry.bound = static_cast<BoundType>((data >> 24) & 0x3);
+    const int moveBits = (int)((data >> 32) & 0xFFFF);
+    entry.move = moveBits == 0xFFFF ? -1 : moveBits;
+    return entry;
+}
+
+std::uint8_t TransTable::entryAge(std::uint64_t data) {
+    return (std::uint8_t)((data >> 26) & AGE_MASK);
+}
@@ -0,0 +1,68 @@
+#include "allocCounter.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace {
+    std::atomic<std::uint64_t> numAllocations(0);
+}
+
+void* operator new(std::size_t size) {
+    numAllocations.fetch_add(1, std::memory_order_relaxed);
+    if(void* memory = std::malloc(size ? size : 1))
+        return memory;
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) {
+    return operator new(size);
+}
+
+void operator delete(void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete[](void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept {
+    std::free(memory);
+}
+
+void operator delete[](void* memory, std::size_t) noexcept {
+    std::free(memory);
+}
+
+// boards take their blocks through the aligned forms
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    numAllocations.fetch_add(1, std::memory_order_relaxed);
+    const std::size_t alignVal = static_cast<std::size_t>(alignment);
+    if(void* memory = std::aligned_alloc(alignVal, (size + alignVal - 1) / alignVal * alignVal))
+        return memory;
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment) {
+    return operator new(size, alignment);
+}
+
+void operator delete(void* memory, std::align_val_t) noexcept {
+    std::free(memory);
+}
+
+void operator delete[](void* memory, std::align_val_t) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t, std::align_val_t) noexcept {
+    std::free(memory);
+}
+
+void operator delete[](void* memory, std::size_t, std::align_val_t) noexcept {
+    std::free(memory);
+}
+
+std::uint64_t allocationCount(void) {
+    return numAllocations.load(std::memory_order_relaxed);
+}
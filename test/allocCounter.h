@@ -0,0 +1,16 @@
+#ifndef ALLOCCOUNTER_H
+#define ALLOCCOUNTER_H
+
+// Required imports
+#include <cstdint>
+
+/**
+ * Counting replacements of the global operator new and delete (allocCounter.cpp), linked
+ * into the test and benchmark binaries. Every allocation of the binary is counted, so a
+ * section of code can be checked for allocations by comparing the count before and after it.
+ **/
+
+// operator new calls since the start of the program
+std::uint64_t allocationCount(void);
+
+#endif
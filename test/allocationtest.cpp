@@ -0,0 +1,183 @@
+#include "gtest/gtest.h"
+#include "allocCounter.h"
+#include "gomoku.h"
+#include "psqReader.h"
+#include "threatSearch.h"
+#include <cstdint>
+#include <string>
+#include <tuple>
+#include <vector>
+
+/**
+ * Proves that placing pieces, checking the rules and checking for a win never allocate.
+ * The test binary counts every call of operator new; the counted sections only run code
+ * of the boards, so any allocation seen comes from them.
+ **/
+class AllocationTest : public ::testing::Test {
+protected:
+    // exposes the protected line readers
+    class ProbeBoard : public MNKBoard{
+    public:
+        using MNKBoard::MNKBoard;
+        using MNKBoard::enumerateInARow;
+        using MNKBoard::getRowVec;
+        using MNKBoard::getColVec;
+        using MNKBoard::getForwardDiagVec;
+        using MNKBoard::getBackDiagVec;
+    };
+
+    // testing constants
+    static const int BOARD_SIZE = 15;
+    inline static const std::string DATA_PATH = "../test/SimulatedGames/";
+
+    // moves of the corpus games, read before anything is counted
+    static std::vector<std::vector<std::tuple<int, int>>> loadGames(void) {
+        std::vector<std::vector<std::tuple<int, int>>> games;
+        int width, height;
+        PsqMove move;
+        for(const std::string& filePath : PsqReplayer::listCorpus(DATA_PATH)) {
+            const MappedFile psqFile(filePath);
+            PsqScanner scanner(psqFile.data(), psqFile.data() + psqFile.size());
+            if(!scanner.readHeader(width, height))
+                continue;
+            games.emplace_back();
+            while(scanner.nextMove(move))
+                games.back().emplace_back(move.x-1, move.y-1);
+        }
+        return games;
+    }
+};
+
+TEST_F(AllocationTest, OmokGameTest) {
+    const std::vector<std::vector<std::tuple<int, int>>> games = loadGames();
+    ASSERT_FALSE(games.empty());
+    int forbiddenCells[BOARD_SIZE*BOARD_SIZE];
+
+    for(Omok::RuleSet ruleSet : {Omok::RuleSet::omok, Omok::RuleSet::renju}) {
+        Omok game(ruleSet);
+        int numMoves = 0;
+        const std::uint64_t startCount = allocationCount();
+        for(const std::vector<std::tuple<int, int>>& moves : games) {
+            // placement, rule checks and win check through placePiece
+            game.clearBoard();
+            for(const std::tuple<int, int>& move : moves) {
+                const int row = std::get<0>(move), col = std::get<1>(move);
+                game.isDoubleThree(row, col);
+                game.isForbidden(row, col);
+                for(int dirInd=0; dirInd<MNKBoard::NUM_DIRS; dirInd++)
+                    game.getLinePattern(row, col, game.getCurrentPlayer(), static_cast<MNKBoard::PieceDirection>(dirInd));
+                game.getForbiddenPoints(forbiddenCells);
+                if(!game.placePiece(row, col))
+                    break;
+                numMoves++;
+            }
+
+            // the same through the undo stack
+            game.clearBoard();
+            int numMade = 0;
+            for(const std::tuple<int, int>& move : moves) {
+                if(!game.makeMove(std::get<0>(move), std::get<1>(move)))
+                    break;
+                numMade++;
+            }
+            while(numMade-- > 0)
+                game.unmakeMove();
+        }
+        EXPECT_EQ(0U, allocationCount() - startCount) << "in " << numMoves << " moves";
+        EXPECT_GT(numMoves, 0);
+    }
+}
+
+TEST_F(AllocationTest, LineReaderTest) {
+    for(int boardSize : {BOARD_SIZE, 12}) {
+        ProbeBoard board(boardSize, boardSize, 5);
+        const std::uint64_t startCount = allocationCount();
+        int numWins = 0;
+        for(int cellInd=0; cellInd<boardSize*boardSize; cellInd++) {
+            const int row = (cellInd * 7) % (boardSize*boardSize) / boardSize, col = (cellInd * 7) % boardSize;
+            if(!board.placePiece(row, col, cellInd % 2 ? CellState::white : CellState::black))
+                continue;
+            numWins += board.checkWin();
+
+            const std::array<MNKBoard::Run, MNKBoard::NUM_DIRS> runs = board.enumerateInARow();
+            EXPECT_TRUE(runs[2].dir == MNKBoard::PieceDirection::HORZ);
+            EXPECT_GE(runs[2].length, 1);
+
+            // the line readers must agree with the cells
+            const MNKBoard::LineCells rowCells = board.getRowVec(row);
+            const MNKBoard::LineCells colCells = board.getColVec(col);
+            ASSERT_EQ(boardSize, rowCells.size());
+            ASSERT_EQ(boardSize, colCells.size());
+            for(int lineInd=0; lineInd<boardSize; lineInd++) {
+                EXPECT_TRUE(rowCells[lineInd] == board.getCell(row, lineInd));
+                EXPECT_TRUE(colCells[lineInd] == board.getCell(lineInd, col));
+            }
+            const MNKBoard::LineCells forwardCells = board.getForwardDiagVec(row, col, 2);
+            const MNKBoard::LineCells backCells = board.getBackDiagVec(row, col);
+            EXPECT_LE(forwardCells.size(), 5);
+            EXPECT_GE(backCells.size(), 1);
+        }
+        board.clearBoard();
+        EXPECT_EQ(0U, allocationCount() - startCount);
+        EXPECT_GT(numWins, 0);
+    }
+}
+
+TEST_F(AllocationTest, SnapshotTest) {
+    Omok game(Omok::RuleSet::renju);
+    const int moves[][2] = {{7, 7}, {6, 6}, {7, 8}, {6, 8}, {8, 7}, {5, 9}};
+    for(auto& move : moves)
+        ASSERT_TRUE(game.makeMove(move[0], move[1]));
+
+    // a snapshot of the same size is refreshed in place
+    Omok snapshot(game);
+    BoardArena arena;
+    { Omok warmCopy(game, &arena); }
+    const std::uint64_t startCount = allocationCount();
+    for(int copyInd=0; copyInd<100; copyInd++) {
+        snapshot = game;
+        Omok arenaCopy(game, &arena);
+        ASSERT_TRUE(arenaCopy.makeMove(0, copyInd % 15));
+        ASSERT_TRUE(snapshot.unmakeMove());
+    }
+    EXPECT_EQ(0U, allocationCount() - startCount);
+}
+
+TEST_F(AllocationTest, ArenaResizeTest) {
+    // a board on an arena stays on it when a board of another size is assigned
+    BoardArena arena;
+    MNKBoard smallBoard(3, 3, 3), largeBoard(12, 12, 5);
+    ASSERT_TRUE(largeBoard.makeMove(11, 11, CellState::white));
+    { MNKBoard warmSmall(smallBoard, &arena), warmLarge(largeBoard, &arena); }
+    MNKBoard arenaBoard(smallBoard, &arena);
+
+    const std::uint64_t startCount = allocationCount();
+    arenaBoard = largeBoard;
+    arenaBoard = smallBoard;
+    arenaBoard = largeBoard;
+    EXPECT_EQ(0U, allocationCount() - startCount);
+    EXPECT_TRUE(arenaBoard.getCell(11, 11) == CellState::white);
+    EXPECT_EQ(largeBoard.getHashKey(), arenaBoard.getHashKey());
+}
+
+TEST_F(AllocationTest, FivePointsTest) {
+    const std::vector<std::vector<std::tuple<int, int>>> games = loadGames();
+    ASSERT_FALSE(games.empty());
+    int fiveCells[BOARD_SIZE*BOARD_SIZE];
+
+    // the threat search and the rollouts scan for five points on every node
+    Omok game(Omok::RuleSet::omok);
+    int numFives = 0;
+    const std::uint64_t startCount = allocationCount();
+    for(const std::vector<std::tuple<int, int>>& moves : games) {
+        game.clearBoard();
+        for(const std::tuple<int, int>& move : moves) {
+            numFives += ThreatSolver::findFivePoints(game, CellState::black, fiveCells);
+            numFives += ThreatSolver::findFivePoints(game, CellState::white, fiveCells);
+            if(!game.makeMove(std::get<0>(move), std::get<1>(move)))
+                break;
+        }
+    }
+    EXPECT_EQ(0U, allocationCount() - startCount);
+    EXPECT_GT(numFives, 0);
+}
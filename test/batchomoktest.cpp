@@ -0,0 +1,135 @@
+#include "gtest/gtest.h"
+#include "batchOmok.h"
+#include "psqReader.h"
+#include <random>
+#include <string>
+#include <tuple>
+#include <vector>
+
+// Implements a fixture that plays a batch in lockstep with one Omok per game
+class BatchOmokTest : public ::testing::Test {
+protected:
+    static const int BOARD_SIZE = 15;
+    static const int NUM_GAMES = 64;
+    inline static const std::string DATA_PATH = "../test/SimulatedGames/";
+
+    // steps the batch and every Omok with the same moves and compares the outcomes
+    static void stepBoth(BatchOmok& batch, std::vector<Omok>& games, const std::vector<BatchOmok::Move>& moves,
+                         int& numForbidden, int& numWins) {
+        std::vector<bool> wasFinished(games.size());
+        for(std::size_t gameInd=0; gameInd<games.size(); gameInd++)
+            wasFinished[gameInd] = games[gameInd].isFinished();
+        const std::uint8_t* flags = batch.placePieces(moves.data());
+
+        for(std::size_t gameInd=0; gameInd<games.size(); gameInd++) {
+            Omok& game = games[gameInd];
+            const int row = moves[gameInd].row, col = moves[gameInd].col;
+            const bool isForbidden = !wasFinished[gameInd] && game.isPosEmpty(row, col) && game.isForbidden(row, col);
+            const bool isPlaced = game.placePiece(row, col);
+
+            ASSERT_EQ(isPlaced, bool(flags[gameInd] & BatchOmok::PLACED)) << gameInd << ": " << row << "," << col;
+            ASSERT_EQ(isForbidden, bool(flags[gameInd] & BatchOmok::FORBIDDEN)) << gameInd << ": " << row << "," << col;
+            ASSERT_EQ(game.isFinished(), bool(flags[gameInd] & BatchOmok::FINISHED));
+            ASSERT_EQ(isPlaced && game.isFinished(), bool(flags[gameInd] & BatchOmok::WIN));
+            ASSERT_EQ(game.isFinished(), batch.isFinished(gameInd));
+            ASSERT_EQ(game.getGameWinner(), batch.getGameWinner(gameInd));
+            ASSERT_TRUE(game.getCurrentPlayer() == batch.getCurrentPlayer(gameInd));
+            ASSERT_EQ(game.getMoveCount(), batch.getMoveCount(gameInd));
+            numForbidden += isForbidden;
+            numWins += isPlaced && game.isFinished();
+        }
+    }
+};
+
+TEST_F(BatchOmokTest, RandomGameTest) {
+    for(Omok::RuleSet ruleSet : {Omok::RuleSet::omok, Omok::RuleSet::renju, Omok::RuleSet::freestyle, Omok::RuleSet::standard}) {
+        BatchOmok batch(NUM_GAMES, ruleSet);
+        std::vector<Omok> games(NUM_GAMES, Omok(ruleSet));
+        std::mt19937 rng(7);
+        std::vector<BatchOmok::Move> moves(NUM_GAMES);
+        int numForbidden = 0, numWins = 0;
+
+        // moves crowd the centre to bring up forbidden shapes; finished games restart
+        for(int stepInd=0; stepInd<600; stepInd++) {
+            for(int gameInd=0; gameInd<NUM_GAMES; gameInd++) {
+                const int spread = 5 + gameInd % 6;
+                moves[gameInd] = {7 - spread/2 + int(rng() % spread), 7 - spread/2 + int(rng() % spread)};
+                if(rng() % 50 == 0)
+                    moves[gameInd] = {-1, int(rng() % BOARD_SIZE)};
+                if(games[gameInd].isFinished() && rng() % 4 == 0) {
+                    games[gameInd].clearBoard();
+                    batch.clearBoard(gameInd);
+                }
+            }
+            stepBoth(batch, games, moves, numForbidden, numWins);
+            if(HasFatalFailure())
+                return;
+        }
+
+        // the boards themselves agree
+        for(int gameInd=0; gameInd<NUM_GAMES; gameInd++)
+            for(int rowInd=0; rowInd<BOARD_SIZE; rowInd++)
+                for(int colInd=0; colInd<BOARD_SIZE; colInd++)
+                    ASSERT_TRUE(games[gameInd].getCell(rowInd, colInd) == batch.getCell(gameInd, rowInd, colInd));
+        if(Omok::hasForbiddenMoves(ruleSet))
+            EXPECT_GT(numForbidden, 0);
+        else
+            EXPECT_EQ(0, numForbidden);
+        EXPECT_GT(numWins, 0);
+    }
+}
+
+TEST_F(BatchOmokTest, CorpusTest) {
+    // the corpus games side by side, each one its own environment
+    std::vector<std::vector<BatchOmok::Move>> corpus;
+    int width, height;
+    PsqMove move;
+    for(const std::string& filePath : PsqReplayer::listCorpus(DATA_PATH)) {
+        const MappedFile psqFile(filePath);
+        PsqScanner scanner(psqFile.data(), psqFile.data() + psqFile.size());
+        if(!scanner.readHeader(width, height))
+            continue;
+        corpus.emplace_back();
+        while(scanner.nextMove(move))
+            corpus.back().push_back({move.x-1, move.y-1});
+    }
+    ASSERT_FALSE(corpus.empty());
+
+    const int numGames = static_cast<int>(corpus.size());
+    BatchOmok batch(numGames, Omok::RuleSet::renju);
+    std::vector<Omok> games(numGames, Omok(Omok::RuleSet::renju));
+    std::vector<BatchOmok::Move> moves(numGames);
+    int numForbidden = 0, numWins = 0;
+    for(std::size_t moveInd=0; moveInd<BOARD_SIZE*BOARD_SIZE; moveInd++) {
+        // games out of moves are skipped
+        for(int gameInd=0; gameInd<numGames; gameInd++)
+            moves[gameInd] = moveInd < corpus[gameInd].size() ? corpus[gameInd][moveInd] : BatchOmok::Move{-1, -1};
+        stepBoth(batch, games, moves, numForbidden, numWins);
+        if(HasFatalFailure())
+            return;
+    }
+    EXPECT_GT(numWins, numGames / 2);
+}
+
+TEST_F(BatchOmokTest, ClearTest) {
+    BatchOmok batch(3);
+    ASSERT_EQ(3, batch.size());
+    const std::vector<BatchOmok::Move> moves = {{7, 7}, {7, 7}, {0, 14}};
+    const std::uint8_t* flags = batch.placePieces(moves.data());
+    EXPECT_EQ(BatchOmok::PLACED, flags[0]);
+    EXPECT_TRUE(batch.getCell(2, 0, 14) == CellState::black);
+    EXPECT_TRUE(batch.getCurrentPlayer(1) == CellState::white);
+
+    // a cell is only taken once
+    flags = batch.placePieces(moves.data());
+    EXPECT_EQ(0, flags[1]);
+    EXPECT_EQ(1, batch.getMoveCount(1));
+
+    batch.clearBoard(1);
+    EXPECT_TRUE(batch.getCell(1, 7, 7) == CellState::none);
+    EXPECT_TRUE(batch.getCell(0, 7, 7) == CellState::black);
+    EXPECT_TRUE(batch.getCurrentPlayer(1) == CellState::black);
+    batch.clearBoards();
+    EXPECT_EQ(0, batch.getMoveCount(0));
+    EXPECT_TRUE(batch.getCell(2, 0, 14) == CellState::none);
+}
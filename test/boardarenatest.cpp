@@ -0,0 +1,63 @@
+#include "gtest/gtest.h"
+#include "boardArena.h"
+#include "gomoku.h"
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+// Implements a fixture for the board arena
+class BoardArenaTest : public ::testing::Test {
+protected:
+    BoardArenaTest() : arena(4096) {}
+
+    BoardArena arena;
+};
+
+TEST_F(BoardArenaTest, AllocateTest) {
+    // blocks are aligned and do not overlap
+    std::vector<char*> blocks;
+    for(int blockInd=0; blockInd<20; blockInd++) {
+        blocks.push_back(static_cast<char*>(arena.allocate(100)));
+        ASSERT_EQ(0u, reinterpret_cast<std::uintptr_t>(blocks.back()) % BoardArena::ALIGNMENT);
+        for(std::size_t prevInd=0; prevInd+1<blocks.size(); prevInd++)
+            ASSERT_GE(std::abs(blocks.back() - blocks[prevInd]), 128);
+    }
+    const std::size_t reservedBytes = arena.getReservedBytes();
+    EXPECT_GE(reservedBytes, 20u * 128);
+
+    // released blocks come back to blocks of their size only
+    arena.release(blocks[3], 100);
+    arena.release(blocks[7], 100);
+    EXPECT_EQ(blocks[7], arena.allocate(128));
+    EXPECT_EQ(blocks[3], arena.allocate(65));
+    EXPECT_NE(blocks[3], arena.allocate(100));
+    EXPECT_EQ(reservedBytes, arena.getReservedBytes());
+
+    // a block larger than a chunk takes a chunk of its own
+    void* largeBlock = arena.allocate(10000);
+    EXPECT_GE(arena.getReservedBytes(), reservedBytes + 10000);
+    arena.release(largeBlock, 10000);
+    EXPECT_EQ(largeBlock, arena.allocate(10000));
+}
+
+TEST_F(BoardArenaTest, BoardReuseTest) {
+    // boards of a warmed arena take no more memory from the heap
+    std::size_t warmBytes = 0;
+    for(int roundInd=0; roundInd<2; roundInd++) {
+        std::vector<Omok> games;
+        games.reserve(50);
+        for(int gameInd=0; gameInd<50; gameInd++) {
+            games.emplace_back(Omok::RuleSet::renju, &arena);
+            ASSERT_TRUE(games.back().makeMove(gameInd % 15, gameInd / 15));
+        }
+        MNKBoard smallBoard(4, 4, 4, &arena);
+        MNKBoard dynamicBoard(12, 12, 5, &arena);
+        ASSERT_TRUE(dynamicBoard.makeMove(11, 11, CellState::black));
+        ASSERT_TRUE(smallBoard.isPosEmpty(3, 3));
+
+        if(roundInd == 0)
+            warmBytes = arena.getReservedBytes();
+        else
+            EXPECT_EQ(warmBytes, arena.getReservedBytes());
+    }
+}
@@ -0,0 +1,130 @@
+#include "gtest/gtest.h"
+#include "boardScan.h"
+#include <random>
+#include <vector>
+
+// Implements tests for the full-board pattern scanner
+class BoardScanTest : public ::testing::Test {
+protected:
+    typedef BoardScanner::Kernel Kernel;
+
+    // testing constants
+    static const int BOARD_SIZE = 15;
+    static const int NUM_CELLS = BOARD_SIZE*BOARD_SIZE;
+
+    MNKBoard board1{BOARD_SIZE, BOARD_SIZE, 5};
+
+    void fillRandom(std::mt19937& rng, int numPieces) {
+        board1.clearBoard();
+        std::uniform_int_distribution<int> cellDist(0, NUM_CELLS-1);
+        for(int pieceInd=0; pieceInd<numPieces; pieceInd++)
+            board1.placePiece(cellDist(rng) / BOARD_SIZE, cellDist(rng) % BOARD_SIZE, pieceInd % 2 == 0 ? CellState::black : CellState::white);
+    }
+
+    // walks every 5-cell window of the board cell by cell
+    void referenceScan(int windows[2][6], int fives[2], std::uint8_t* threatMaps) {
+        const int rowSteps[4] = {1, 0, -1, 1}, colSteps[4] = {0, 1, 1, 1};
+        for(int playerInd=0; playerInd<2; playerInd++) {
+            const CellState player = playerInd == 0 ? CellState::black : CellState::white;
+            for(int rowInd=0; rowInd<BOARD_SIZE; rowInd++) {
+                for(int colInd=0; colInd<BOARD_SIZE; colInd++) {
+                    for(int dirInd=0; dirInd<4; dirInd++) {
+                        const int endRow = rowInd + 4*rowSteps[dirInd], endCol = colInd + 4*colSteps[dirInd];
+                        if(endRow < 0 || endRow >= BOARD_SIZE || endCol >= BOARD_SIZE)
+                            continue;
+                        int numOwn = 0;
+                        bool isFree = true;
+                        for(int stepInd=0; stepInd<5; stepInd++) {
+                            const CellState cell = board1.getCell(rowInd + stepInd*rowSteps[dirInd], colInd + stepInd*colSteps[dirInd]);
+                            numOwn += cell == player;
+                            isFree = isFree && (cell == player || cell == CellState::none);
+                        }
+                        if(!isFree)
+                            continue;
+                        windows[playerInd][numOwn]++;
+                        if(numOwn == 5) {
+                            const int beforeRow = rowInd - rowSteps[dirInd], beforeCol = colInd - colSteps[dirInd];
+                            const int afterRow = endRow + rowSteps[dirInd], afterCol = endCol + colSteps[dirInd];
+                            fives[playerInd] += (!inBoard(beforeRow, beforeCol) || board1.getCell(beforeRow, beforeCol) != player)
+                                                && (!inBoard(afterRow, afterCol) || board1.getCell(afterRow, afterCol) != player);
+                        }
+                        for(int stepInd=0; stepInd<5 && (numOwn == 3 || numOwn == 4); stepInd++) {
+                            const int cellRow = rowInd + stepInd*rowSteps[dirInd], cellCol = colInd + stepInd*colSteps[dirInd];
+                            if(board1.getCell(cellRow, cellCol) == CellState::none)
+                                threatMaps[playerInd*NUM_CELLS + cellRow*BOARD_SIZE + cellCol]
+                                    |= numOwn == 4 ? BoardScanner::FIVE_POINT : BoardScanner::FOUR_POINT;
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    static bool inBoard(int row, int col) {
+        return row >= 0 && row < BOARD_SIZE && col >= 0 && col < BOARD_SIZE;
+    }
+};
+
+TEST_F(BoardScanTest, ReferenceTest) {
+    std::mt19937 rng(16);
+    for(int trialInd=0; trialInd<40; trialInd++) {
+        fillRandom(rng, 20 + 3*trialInd);
+
+        int windows[2][6] = {}, fives[2] = {};
+        std::vector<std::uint8_t> expectedMaps(2*NUM_CELLS, 0), threatMaps(2*NUM_CELLS);
+        referenceScan(windows, fives, expectedMaps.data());
+
+        BoardFeatures features;
+        BoardScanner::scan(board1, features, threatMaps.data(), Kernel::scalar);
+        for(int playerInd=0; playerInd<2; playerInd++) {
+            for(int countInd=0; countInd<6; countInd++)
+                ASSERT_EQ(features.windows[playerInd][countInd], windows[playerInd][countInd]);
+            ASSERT_EQ(features.fives[playerInd], fives[playerInd]);
+        }
+        ASSERT_EQ(threatMaps, expectedMaps);
+    }
+}
+
+TEST_F(BoardScanTest, KernelTest) {
+    std::mt19937 rng(61);
+    for(Kernel kernel : {Kernel::sse2, Kernel::avx2}) {
+        if(!BoardScanner::isSupported(kernel))
+            continue;
+        for(int trialInd=0; trialInd<40; trialInd++) {
+            fillRandom(rng, 10 + 4*trialInd);
+            BoardFeatures expected, features;
+            std::vector<std::uint8_t> expectedMaps(2*NUM_CELLS), threatMaps(2*NUM_CELLS);
+            BoardScanner::scan(board1, expected, expectedMaps.data(), Kernel::scalar);
+            BoardScanner::scan(board1, features, threatMaps.data(), kernel);
+            ASSERT_EQ(std::vector<int>(&features.windows[0][0], &features.windows[0][0] + 12),
+                      std::vector<int>(&expected.windows[0][0], &expected.windows[0][0] + 12));
+            for(int playerInd=0; playerInd<2; playerInd++) {
+                ASSERT_EQ(features.openThrees[playerInd], expected.openThrees[playerInd]);
+                ASSERT_EQ(features.openFours[playerInd], expected.openFours[playerInd]);
+                ASSERT_EQ(features.fives[playerInd], expected.fives[playerInd]);
+            }
+            ASSERT_EQ(threatMaps, expectedMaps);
+        }
+    }
+}
+
+TEST_F(BoardScanTest, PatternTest) {
+    // ..xxx.. along a row is a single open three, .xxxx. down a column an open four,
+    // and six in a row along a diagonal no five
+    for(int colInd=5; colInd<8; colInd++)
+        board1.placePiece(2, colInd, CellState::black);
+    for(int rowInd=5; rowInd<9; rowInd++)
+        board1.placePiece(rowInd, 1, CellState::white);
+    for(int stepInd=0; stepInd<6; stepInd++)
+        board1.placePiece(8+stepInd, 3+stepInd, CellState::black);
+
+    BoardFeatures features;
+    BoardScanner::scan(board1, features);
+    ASSERT_EQ(features.openThrees[0], 1);
+    ASSERT_EQ(features.openFours[1], 1);
+    ASSERT_EQ(features.fives[0], 0);
+
+    board1.removePiece(13, 8);
+    BoardScanner::scan(board1, features);
+    ASSERT_EQ(features.fives[0], 1);
+}
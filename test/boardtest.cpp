@@ -0,0 +1,75 @@
+#include "gtest/gtest.h"
+#include "board.h"
+#include <random>
+
+// Implements tests for the compile-time board against the runtime-sized one
+class BoardTest : public ::testing::Test {
+protected:
+    typedef MNKBoard::PieceDirection PieceDirection;
+
+    // 7x6 boards are not specialised, so the MNKBoard runs on the runtime-sized core
+    Board<7, 6, 4> fixedBoard;
+    MNKBoard runtimeBoard{7, 6, 4};
+
+    void expectSameLines(void) {
+        for(int dirInd=0; dirInd<MNKBoard::NUM_DIRS; dirInd++) {
+            const PieceDirection dir = static_cast<PieceDirection>(dirInd);
+            ASSERT_EQ((Board<7, 6, 4>::NUM_LINES[dirInd]), runtimeBoard.getNumLines(dir));
+            for(int lineInd=0; lineInd<runtimeBoard.getNumLines(dir); lineInd++)
+                for(CellState state : {CellState::none, CellState::black, CellState::white})
+                    ASSERT_EQ(fixedBoard.getLine(state, dir, lineInd), runtimeBoard.getLine(state, dir, lineInd));
+        }
+    }
+};
+
+TEST_F(BoardTest, TableTest) {
+    for(int rowInd=0; rowInd<7; rowInd++) {
+        for(int colInd=0; colInd<6; colInd++) {
+            for(int dirInd=0; dirInd<MNKBoard::NUM_DIRS; dirInd++) {
+                const PieceDirection dir = static_cast<PieceDirection>(dirInd);
+                ASSERT_EQ((Board<7, 6, 4>::lineIndex(dir, rowInd, colInd)), runtimeBoard.lineIndex(dir, rowInd, colInd));
+                ASSERT_EQ((Board<7, 6, 4>::CELLS.lines[dirInd][rowInd*6 + colInd]),
+                          (Board<7, 6, 4>::LINE_OFFSETS[dirInd] + runtimeBoard.lineIndex(dir, rowInd, colInd)));
+            }
+        }
+    }
+    expectSameLines();
+}
+
+TEST_F(BoardTest, RandomGameTest) {
+    std::mt19937 rng(15);
+    std::uniform_int_distribution<int> rowDist(0, 6), colDist(0, 5);
+    for(int gameInd=0; gameInd<50; gameInd++) {
+        for(int moveInd=0; moveInd<30; moveInd++) {
+            const int row = rowDist(rng), col = colDist(rng);
+            const CellState player = moveInd % 2 == 0 ? CellState::black : CellState::white;
+            if(runtimeBoard.getCell(row, col) != CellState::none)
+                continue;
+            fixedBoard.setCell(MNKBoard::playerIndex(player), row, col);
+            ASSERT_TRUE(runtimeBoard.placePiece(row, col, player));
+            ASSERT_EQ(fixedBoard.hasRun(MNKBoard::playerIndex(player), row, col), runtimeBoard.checkWin());
+            ASSERT_EQ(fixedBoard.getCell(row, col), player);
+        }
+        expectSameLines();
+
+        // take a few pieces back before starting over
+        for(int cellInd=0; cellInd<42; cellInd+=5) {
+            fixedBoard.clearCell(cellInd / 6, cellInd % 6);
+            runtimeBoard.removePiece(cellInd / 6, cellInd % 6);
+        }
+        expectSameLines();
+        fixedBoard.clear();
+        runtimeBoard.clearBoard();
+    }
+}
+
+TEST_F(BoardTest, SpecialisedSizeTest) {
+    // 19x19 boards run on a Board<19, 19, 5> behind the MNKBoard interface
+    MNKBoard goBoard(19, 19, 5);
+    for(int stepInd=0; stepInd<4; stepInd++)
+        ASSERT_TRUE(goBoard.placePiece(14+stepInd, 18-stepInd, CellState::white));
+    ASSERT_FALSE(goBoard.checkWin());
+    ASSERT_TRUE(goBoard.placePiece(18, 14, CellState::white));
+    ASSERT_TRUE(goBoard.checkWin());
+    ASSERT_EQ(goBoard.getLineBits(CellState::white, PieceDirection::FSD, 18, 14), MNKBoard::LineBits(0x1F) << 14);
+}
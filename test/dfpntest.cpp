@@ -0,0 +1,97 @@
+#include "gtest/gtest.h"
+#include "dfpnSolver.h"
+#include <cstdio>
+#include <string>
+#include <tuple>
+#include <vector>
+
+// Implements a fixture for the df-pn solver
+class DfpnSolverTest : public ::testing::Test {
+protected:
+    DfpnSolverTest() : solver(16), proofPath("dfpn_test_proof.txt") {}
+    ~DfpnSolverTest() { std::remove(proofPath.c_str()); }
+
+    // plays a list of moves that all have to be legal
+    void playMoves(Omok& game, const std::vector<std::tuple<int, int>>& moves) {
+        for(auto& move : moves)
+            ASSERT_TRUE(game.makeMove(std::get<0>(move), std::get<1>(move)));
+    }
+
+    DfpnSolver solver;
+    std::string proofPath;
+};
+
+TEST_F(DfpnSolverTest, TicTacToeDrawTest) {
+    MNKBoard board(3, 3, 3);
+    DfpnResult result = solver.solve(board);
+    ASSERT_EQ(result.value, ProofValue::draw);
+    ASSERT_FALSE(result.limitReached);
+    ASSERT_EQ(board.getMoveCount(), 0);
+
+    // the saved proof replays against the same position
+    ASSERT_TRUE(solver.saveProof(proofPath));
+    ASSERT_EQ(DfpnSolver::checkProofFile(board, proofPath), ProofValue::draw);
+}
+
+TEST_F(DfpnSolverTest, TicTacToeWinTest) {
+    // an edge reply to the centre opening loses
+    MNKBoard board(3, 3, 3);
+    ASSERT_TRUE(board.makeMove(1, 1, CellState::black));
+    ASSERT_TRUE(board.makeMove(0, 1, CellState::white));
+    DfpnResult result = solver.solve(board);
+    ASSERT_EQ(result.value, ProofValue::win);
+
+    // the proving move keeps the win
+    ASSERT_TRUE(board.makeMove(std::get<0>(result.bestMove), std::get<1>(result.bestMove), CellState::black));
+    ASSERT_EQ(solver.solve(board).value, ProofValue::loss);
+    ASSERT_TRUE(solver.saveProof(proofPath));
+    ASSERT_EQ(DfpnSolver::checkProofFile(board, proofPath), ProofValue::loss);
+
+    // a proof does not hold for another position
+    ASSERT_TRUE(board.unmakeMove());
+    ASSERT_EQ(DfpnSolver::checkProofFile(board, proofPath), ProofValue::unknown);
+}
+
+TEST_F(DfpnSolverTest, RectangularWinTest) {
+    // three in a row is a first player win on a 4x3 board
+    MNKBoard board(4, 3, 3);
+    DfpnResult result = solver.solve(board);
+    ASSERT_EQ(result.value, ProofValue::win);
+    ASSERT_TRUE(solver.saveProof(proofPath));
+    ASSERT_EQ(DfpnSolver::checkProofFile(board, proofPath), ProofValue::win);
+}
+
+TEST_F(DfpnSolverTest, OmokWinTest) {
+    // continuous fours win for black
+    Omok game;
+    playMoves(game, {{7,7}, {7,6}, {7,8}, {0,0}, {7,9}, {0,2}, {8,10}, {0,4}, {9,10}, {14,0}});
+    const auto keyBefore = game.getHashKey();
+
+    DfpnResult result = solver.solve(game);
+    ASSERT_EQ(result.value, ProofValue::win);
+    ASSERT_EQ(game.getHashKey(), keyBefore);
+    ASSERT_TRUE(game.makeMove(std::get<0>(result.bestMove), std::get<1>(result.bestMove)));
+    ASSERT_TRUE(game.unmakeMove());
+
+    ASSERT_TRUE(solver.saveProof(proofPath));
+    ASSERT_EQ(DfpnSolver::checkProofFile(game, proofPath), ProofValue::win);
+}
+
+TEST_F(DfpnSolverTest, OmokLossTest) {
+    // white cannot stop the open four on row 7
+    Omok game;
+    playMoves(game, {{7,4}, {0,0}, {7,5}, {0,2}, {7,6}, {0,4}, {7,7}});
+    DfpnResult result = solver.solve(game);
+    ASSERT_EQ(result.value, ProofValue::loss);
+    ASSERT_EQ(game.getMoveCount(), 7);
+}
+
+TEST_F(DfpnSolverTest, NodeLimitTest) {
+    MNKBoard board(4, 4, 4);
+    DfpnSolver limitedSolver(1, 100);
+    DfpnResult result = limitedSolver.solve(board);
+    ASSERT_EQ(result.value, ProofValue::unknown);
+    ASSERT_TRUE(result.limitReached);
+    ASSERT_FALSE(limitedSolver.saveProof(proofPath));
+    ASSERT_EQ(board.getMoveCount(), 0);
+}
@@ -0,0 +1,107 @@
+#include "gtest/gtest.h"
+#include "evaluator.h"
+#include <thread>
+#include <tuple>
+#include <vector>
+
+// Implements a fixture for the batched leaf evaluator
+class EvaluatorTest : public ::testing::Test {
+protected:
+    EvaluatorTest() : backend(15, 15) {}
+
+    // plays a list of moves that all have to be legal
+    void playMoves(Omok& game, const std::vector<std::tuple<int, int>>& moves) {
+        for(auto& move : moves)
+            ASSERT_TRUE(game.makeMove(std::get<0>(move), std::get<1>(move)));
+    }
+
+    // evaluates a single position straight through the backend
+    EvalOutput evaluateAlone(Omok& game) {
+        std::vector<float> planes(BatchEvaluator::NUM_PLANES*225);
+        BatchEvaluator::encodePosition(game, planes.data());
+        EvalOutput output;
+        output.policy.resize(225);
+        backend.evaluate(planes.data(), 1, 15, 15, &output.value, output.policy.data());
+        return output;
+    }
+
+    ReferenceBackend backend;
+};
+
+TEST_F(EvaluatorTest, EncodeTest) {
+    // black builds a row and a column that would both become open threes at (7,7)
+    Omok game;
+    playMoves(game, {{7,5}, {0,0}, {7,6}, {0,2}, {5,7}, {0,4}, {6,7}, {14,14}});
+    std::vector<float> planes(BatchEvaluator::NUM_PLANES*225);
+    BatchEvaluator::encodePosition(game, planes.data());
+
+    // black is to move
+    ASSERT_EQ(planes[7*15 + 5], 1);
+    ASSERT_EQ(planes[225 + 0], 1);
+    ASSERT_EQ(planes[7*15 + 7], 0);
+    ASSERT_EQ(planes[225 + 7*15 + 5], 0);
+    ASSERT_EQ(planes[2*225 + 100], 1);
+    ASSERT_EQ(planes[3*225 + 7*15 + 7], 1);
+    ASSERT_EQ(planes[3*225 + 7*15 + 4], 0);
+
+    // after a white move the planes swap sides
+    ASSERT_TRUE(game.makeMove(7, 4));
+    BatchEvaluator::encodePosition(game, planes.data());
+    ASSERT_EQ(planes[225 + 7*15 + 5], 1);
+    ASSERT_EQ(planes[0], 1);
+    ASSERT_EQ(planes[2*225 + 100], 0);
+}
+
+TEST_F(EvaluatorTest, EvaluateManyTest) {
+    // a batch gives the same outputs as evaluating every position alone
+    std::vector<Omok> games(11);
+    std::vector<Omok*> gamePtrs;
+    for(int gameInd=0; gameInd<11; gameInd++) {
+        for(int moveInd=0; moveInd<gameInd; moveInd++)
+            ASSERT_TRUE(games[gameInd].makeMove(moveInd, (3*moveInd + gameInd) % 15));
+        gamePtrs.push_back(&games[gameInd]);
+    }
+
+    BatchEvaluator evaluator(backend, 4);
+    std::vector<EvalOutput> outputs(11);
+    evaluator.evaluateMany(gamePtrs.data(), 11, outputs.data());
+    ASSERT_EQ(evaluator.getNumBatches(), 3);
+    ASSERT_EQ(evaluator.getNumPositions(), 11);
+
+    for(int gameInd=0; gameInd<11; gameInd++) {
+        EvalOutput expected = evaluateAlone(games[gameInd]);
+        ASSERT_FLOAT_EQ(outputs[gameInd].value, expected.value);
+        ASSERT_EQ(outputs[gameInd].policy, expected.policy);
+        ASSERT_GE(outputs[gameInd].value, -1);
+        ASSERT_LE(outputs[gameInd].value, 1);
+    }
+    ASSERT_LT(outputs[1].policy[1], -1e8);    // the cell of its only piece
+}
+
+TEST_F(EvaluatorTest, ConcurrentTest) {
+    // threads submitting at the same time share batches
+    const int numThreads = 8, numRounds = 20;
+    BatchEvaluator evaluator(backend, numThreads, 15, 15, 50000);
+    std::vector<int> numMismatches(numThreads, 0);
+    std::vector<std::thread> threads;
+    for(int threadInd=0; threadInd<numThreads; threadInd++) {
+        threads.emplace_back([&, threadInd]() {
+            Omok game;
+            game.makeMove(threadInd, threadInd);
+            for(int roundInd=0; roundInd<numRounds; roundInd++) {
+                EvalOutput output;
+                evaluator.evaluate(game, output);
+                EvalOutput expected = evaluateAlone(game);
+                if(output.value != expected.value || output.policy != expected.policy)
+                    numMismatches[threadInd]++;
+            }
+        });
+    }
+    for(std::thread& thread : threads)
+        thread.join();
+
+    for(int threadInd=0; threadInd<numThreads; threadInd++)
+        ASSERT_EQ(numMismatches[threadInd], 0);
+    ASSERT_EQ(evaluator.getNumPositions(), numThreads*numRounds);
+    ASSERT_LT(evaluator.getNumBatches(), numThreads*numRounds);
+}
@@ -0,0 +1,167 @@
+#include "gtest/gtest.h"
+#include "gameArchive.h"
+#include "psqReader.h"
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+// Implements a fixture for the binary game archive
+class GameArchiveTest : public ::testing::Test {
+protected:
+    GameArchiveTest() : archivePath("garc_test_archive.garc") {}
+    ~GameArchiveTest() { std::remove(archivePath.c_str()); }
+
+    inline static const std::string DATA_PATH = "../test/SimulatedGames/";
+    std::string archivePath;
+
+    // random games with random metadata
+    static std::vector<ArchiveGame> randomGames(int rows, int cols, int numGames, unsigned int seed) {
+        std::mt19937 rng(seed);
+        std::vector<ArchiveGame> games(numGames);
+        for(ArchiveGame& game : games) {
+            const int numMoves = rng() % 60;
+            for(int moveInd=0; moveInd<numMoves; moveInd++) {
+                game.moves.emplace_back(rng() % rows, rng() % cols);
+                game.times.push_back(rng() % 100000);
+            }
+            game.result = static_cast<int>(rng() % 4) - 1;
+            game.ruleSet = rng() % 2 ? Omok::RuleSet::renju : Omok::RuleSet::omok;
+        }
+        return games;
+    }
+
+    void writeGames(int rows, int cols, std::uint32_t flags, const std::vector<ArchiveGame>& games) {
+        GameArchiveWriter writer(archivePath, rows, cols, flags);
+        ASSERT_TRUE(writer.isOpen());
+        for(const ArchiveGame& game : games)
+            ASSERT_TRUE(writer.addGame(game));
+        ASSERT_TRUE(writer.finish());
+    }
+};
+
+TEST_F(GameArchiveTest, RoundTripTest) {
+    // one byte per move on 15x15, varints on a board of more than 256 cells
+    for(int boardSize : {15, 30}) {
+        const std::vector<ArchiveGame> games = randomGames(boardSize, boardSize, 200, boardSize);
+        writeGames(boardSize, boardSize, GameArchive::METADATA, games);
+
+        const GameArchive archive(archivePath);
+        ASSERT_TRUE(archive.isOpen());
+        ASSERT_EQ(games.size(), archive.size());
+        EXPECT_EQ(boardSize, archive.getRows());
+        EXPECT_TRUE(archive.hasMetadata());
+
+        // random access, backwards
+        ArchiveGame game;
+        for(std::size_t gameInd=games.size(); gameInd-->0;) {
+            ASSERT_TRUE(archive.getGame(gameInd, game));
+            EXPECT_EQ(games[gameInd].moves, game.moves);
+            EXPECT_EQ(games[gameInd].times, game.times);
+            EXPECT_EQ(games[gameInd].result, game.result);
+            EXPECT_TRUE(games[gameInd].ruleSet == game.ruleSet);
+        }
+        EXPECT_FALSE(archive.getGame(games.size(), game));
+    }
+
+    // without metadata only the moves are kept
+    const std::vector<ArchiveGame> games = randomGames(15, 15, 20, 5);
+    writeGames(15, 15, 0, games);
+    const GameArchive archive(archivePath);
+    ASSERT_TRUE(archive.isOpen());
+    EXPECT_FALSE(archive.hasMetadata());
+    ArchiveGame game;
+    ASSERT_TRUE(archive.getGame(7, game));
+    EXPECT_EQ(games[7].moves, game.moves);
+    EXPECT_EQ(-1, game.result);
+    EXPECT_TRUE(game.times.empty());
+
+    // moves off the board are rejected
+    GameArchiveWriter writer(archivePath, 15, 15, 0);
+    ArchiveGame badGame;
+    badGame.moves.emplace_back(15, 0);
+    EXPECT_FALSE(writer.addGame(badGame));
+}
+
+TEST_F(GameArchiveTest, ConvertTest) {
+    const std::vector<std::string> psqPaths = PsqReplayer::listCorpus(DATA_PATH);
+    ASSERT_EQ(static_cast<long>(psqPaths.size()), GameArchive::convertPsq(psqPaths, archivePath));
+
+    const GameArchive archive(archivePath);
+    ASSERT_TRUE(archive.isOpen());
+    ASSERT_EQ(psqPaths.size(), archive.size());
+    EXPECT_EQ(15, archive.getCols());
+
+    ArchiveGame game;
+    PsqMove move;
+    int width, height;
+    for(std::size_t gameInd=0; gameInd<psqPaths.size(); gameInd+=37) {
+        ASSERT_TRUE(archive.getGame(gameInd, game));
+        EXPECT_EQ(PsqReplayer::expectedWinner(psqPaths[gameInd]), game.result);
+        EXPECT_TRUE(game.ruleSet == Omok::RuleSet::renju);
+
+        const MappedFile psqFile(psqPaths[gameInd]);
+        PsqScanner scanner(psqFile.data(), psqFile.data() + psqFile.size());
+        ASSERT_TRUE(scanner.readHeader(width, height));
+        std::size_t moveInd = 0;
+        for(; scanner.nextMove(move); moveInd++) {
+            ASSERT_LT(moveInd, game.moves.size());
+            EXPECT_EQ(std::make_tuple(move.x-1, move.y-1), game.moves[moveInd]);
+            EXPECT_EQ(move.time, game.times[moveInd]);
+        }
+        EXPECT_EQ(moveInd, game.moves.size());
+    }
+}
+
+TEST_F(GameArchiveTest, CorruptTest) {
+    EXPECT_FALSE(GameArchive("garc_missing.garc").isOpen());
+    writeGames(15, 15, GameArchive::METADATA, randomGames(15, 15, 10, 3));
+
+    // a truncated archive loses its index
+    std::ifstream inFile(archivePath, std::ios::binary);
+    std::vector<char> fileBytes((std::istreambuf_iterator<char>(inFile)), std::istreambuf_iterator<char>());
+    inFile.close();
+    std::ofstream(archivePath, std::ios::binary).write(fileBytes.data(), fileBytes.size() - 8);
+    EXPECT_FALSE(GameArchive(archivePath).isOpen());
+
+    // a bad index entry leaves a stray byte after a record, which is refused
+    fileBytes[fileBytes.size() - 16] += 1;
+    std::ofstream(archivePath, std::ios::binary).write(fileBytes.data(), fileBytes.size());
+    const GameArchive archive(archivePath);
+    ASSERT_TRUE(archive.isOpen());
+    ArchiveGame game;
+    EXPECT_TRUE(archive.getGame(7, game));
+    EXPECT_FALSE(archive.getGame(8, game));
+}
+
+TEST_F(GameArchiveTest, InvalidInputTest) {
+    ArchiveGame emptyGame;
+    emptyGame.ruleSet = Omok::RuleSet::renju;
+    writeGames(15, 15, GameArchive::METADATA, {emptyGame});
+
+    // a writer of an impossible size fails without truncating the existing archive
+    for(int badSize : {0, -3, MNKBoard::MAX_DIM + 1}) {
+        GameArchiveWriter writer(archivePath, badSize, 15, GameArchive::METADATA);
+        EXPECT_FALSE(writer.isOpen());
+        EXPECT_FALSE(writer.addGame(emptyGame));
+        EXPECT_FALSE(writer.finish());
+    }
+    ArchiveGame game;
+    ASSERT_TRUE(GameArchive(archivePath).isOpen());
+    ASSERT_TRUE(GameArchive(archivePath).getGame(0, game));
+    EXPECT_TRUE(game.ruleSet == Omok::RuleSet::renju);
+
+    // the record is the move count, result, rule set and time count; an unknown rule set is refused
+    std::ifstream inFile(archivePath, std::ios::binary);
+    std::vector<char> fileBytes((std::istreambuf_iterator<char>(inFile)), std::istreambuf_iterator<char>());
+    inFile.close();
+    ASSERT_EQ(static_cast<char>(Omok::RuleSet::renju), fileBytes[34]);
+    for(char badRuleSet : {char(4), char(0x7F), char(-1)}) {
+        fileBytes[34] = badRuleSet;
+        std::ofstream(archivePath, std::ios::binary).write(fileBytes.data(), fileBytes.size());
+        const GameArchive archive(archivePath);
+        ASSERT_TRUE(archive.isOpen());
+        EXPECT_FALSE(archive.getGame(0, game));
+    }
+}
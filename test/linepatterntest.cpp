@@ -0,0 +1,61 @@
+#include "gtest/gtest.h"
+#include "linePatterns.h"
+
+// Implements tests for the line pattern table
+class LinePatternTest : public ::testing::Test {
+protected:
+    typedef LinePatterns::Pattern Pattern;
+    typedef LinePatterns::LineBits LineBits;
+
+    // reads a line such as "..xx.x.." where x is an own piece, o a blocked cell and . an
+    // empty cell, and classifies it around the cell at bit
+    static int lineIndex(const char* line, int bit) {
+        LineBits ownBits = 0, emptyBits = 0;
+        for(int cellInd=0; line[cellInd]; cellInd++) {
+            if(line[cellInd] == 'x')
+                ownBits |= LineBits(1) << cellInd;
+            else if(line[cellInd] == '.')
+                emptyBits |= LineBits(1) << cellInd;
+        }
+        return LinePatterns::windowIndex(ownBits, emptyBits, bit);
+    }
+
+    static Pattern classify(const char* line, int bit) {
+        return LinePatterns::getPattern(lineIndex(line, bit));
+    }
+};
+
+TEST_F(LinePatternTest, PatternTest) {
+    ASSERT_EQ(classify("...xxxxx...", 5), Pattern::five);
+    ASSERT_EQ(classify("xxxxx", 0), Pattern::five);
+    ASSERT_EQ(classify("..xxxxxx...", 4), Pattern::overline);
+    ASSERT_EQ(classify("..x.xxxx....", 7), Pattern::four);      // overline on the left, five on the right
+    ASSERT_EQ(classify("...xxxx....", 4), Pattern::openFour);
+    ASSERT_EQ(classify("..oxxxx....", 4), Pattern::four);
+    ASSERT_EQ(classify("...xx.xx...", 3), Pattern::four);
+    ASSERT_EQ(classify("...xxx.....", 4), Pattern::openThree);
+    ASSERT_EQ(classify("...x.xx....", 5), Pattern::brokenThree);
+    ASSERT_EQ(classify("..oxxx.o...", 4), Pattern::none);
+    ASSERT_EQ(classify("...x.x.....", 5), Pattern::none);
+
+    // the piece at the centre is counted as placed
+    ASSERT_EQ(classify("...xx.xx...", 5), Pattern::five);
+}
+
+TEST_F(LinePatternTest, OutsideWindowTest) {
+    // the cells just outside the window turn fives into overlines
+    ASSERT_EQ(classify(".xxxxx.......", 6), Pattern::overline);
+    ASSERT_EQ(classify("...xxx.......", 6), Pattern::openFour);
+    ASSERT_EQ(classify(".x.xxx.......", 6), Pattern::four);
+    ASSERT_EQ(LinePatterns::fivePoints(lineIndex(".x.xxx.......", 6), 6), LineBits(1) << 7);
+    ASSERT_EQ(classify("......xxxx.x", 6), Pattern::four);
+    ASSERT_EQ(LinePatterns::fivePoints(lineIndex("......xxxx.x", 6), 6), LineBits(1) << 5);
+    ASSERT_EQ(LinePatterns::fivePoints(lineIndex("......xxxx..", 6), 6), (LineBits(1) << 5) | (LineBits(1) << 10));
+}
+
+TEST_F(LinePatternTest, ThreeGapsTest) {
+    // xxx is matched as both ..xxx. and .xxx.., and the gaps of both are reported
+    ASSERT_EQ(LinePatterns::threeGaps(lineIndex("...xxx.....", 4), 4), LineBits(0xC6));
+    ASSERT_EQ(LinePatterns::threeGaps(lineIndex("...x.xx....", 3), 3), LineBits(0x94));
+    ASSERT_EQ(LinePatterns::threeGaps(lineIndex("..oxxx.o...", 4), 4), LineBits(0));
+}
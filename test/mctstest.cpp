@@ -0,0 +1,116 @@
+#include "gtest/gtest.h"
+#include "mcts.h"
+#include <tuple>
+#include <vector>
+
+// Implements a fixture for the Monte Carlo tree searcher
+class MctsTest : public ::testing::Test {
+protected:
+    MctsTest() : game() {}
+
+    // plays a list of moves that all have to be legal
+    void playMoves(const std::vector<std::tuple<int, int>>& moves) {
+        for(auto& move : moves)
+            ASSERT_TRUE(game.makeMove(std::get<0>(move), std::get<1>(move)));
+    }
+
+    Omok game;
+};
+
+TEST_F(MctsTest, FindsWinTest) {
+    // black has an open four on row 7 and is to move
+    playMoves({{7,4}, {0,0}, {7,5}, {0,2}, {7,6}, {0,4}, {7,7}, {2,10}});
+    MctsSearcher searcher;
+    MctsLimits limits;
+    limits.maxPlayouts = 2000;
+    MctsResult result = searcher.search(game, limits);
+
+    ASSERT_TRUE(result.bestMove == std::make_tuple(7, 3) || result.bestMove == std::make_tuple(7, 8));
+    ASSERT_GT(result.winRate, 0.9);
+}
+
+TEST_F(MctsTest, BlocksFourTest) {
+    // black threatens five on column 3 and white has to block at (7,3)
+    playMoves({{3,3}, {2,3}, {4,3}, {0,12}, {5,3}, {2,12}, {6,3}});
+    MctsConfig config;
+    config.usePuct = true;
+    MctsSearcher searcher(config);
+    MctsLimits limits;
+    limits.maxPlayouts = 3000;
+    MctsResult result = searcher.search(game, limits);
+
+    ASSERT_EQ(result.bestMove, std::make_tuple(7, 3));
+}
+
+TEST_F(MctsTest, ParallelTest) {
+    playMoves({{7,7}, {7,8}, {8,8}});
+    const auto keyBefore = game.getHashKey();
+
+    MctsConfig config;
+    config.numThreads = 4;
+    MctsSearcher searcher(config);
+    MctsLimits limits;
+    limits.maxPlayouts = 2000;
+    MctsResult result = searcher.search(game, limits);
+
+    // every thread shares the playout budget and the searched game is restored
+    ASSERT_EQ(result.playouts, 2000u);
+    ASSERT_GT(result.treeNodes, 1u);
+    ASSERT_GT(result.playoutsPerSecond, 0u);
+    ASSERT_EQ(game.getHashKey(), keyBefore);
+    ASSERT_EQ(game.getMoveCount(), 3);
+    ASSERT_TRUE(game.makeMove(std::get<0>(result.bestMove), std::get<1>(result.bestMove)));
+}
+
+TEST_F(MctsTest, TreeReuseTest) {
+    playMoves({{7,7}, {7,8}});
+    MctsConfig config;
+    config.numThreads = 2;
+    MctsSearcher searcher(config);
+    MctsLimits limits;
+    limits.maxPlayouts = 1000;
+    MctsResult result = searcher.search(game, limits);
+    ASSERT_EQ(result.reusedVisits, 0u);
+
+    // the subtree below our move and the reply is carried over
+    playMoves({result.bestMove});
+    MctsResult replyResult = searcher.search(game, limits);
+    playMoves({replyResult.bestMove});
+    MctsResult nextResult = searcher.search(game, limits);
+    ASSERT_GT(nextResult.reusedVisits, 0u);
+
+    // an unrelated position starts from scratch
+    game.clearBoard();
+    playMoves({{3,3}});
+    ASSERT_EQ(searcher.search(game, limits).reusedVisits, 0u);
+}
+
+TEST_F(MctsTest, TimeLimitTest) {
+    playMoves({{7,7}});
+    MctsSearcher searcher;
+    MctsLimits limits;
+    limits.maxPlayouts = 0;
+    limits.maxTimeMs = 50;
+    MctsResult result = searcher.search(game, limits);
+
+    ASSERT_GT(result.playouts, 0u);
+    ASSERT_LT(result.elapsedMs, 1000);
+}
+
+TEST_F(MctsTest, ArenaFillTest) {
+    playMoves({{7,7}, {7,8}, {8,8}, {6,6}, {8,7}});
+    for(int numThreads : {1, 4}) {
+        MctsConfig config;
+        config.numThreads = numThreads;
+        config.maxNodes = 1000;
+        MctsSearcher searcher(config);
+        MctsLimits limits;
+        limits.maxPlayouts = 20000;
+        MctsResult result = searcher.search(game, limits);
+
+        // a node that does not fit stays a leaf without taking the rest of the arena, so
+        // smaller expansions keep filling it up to the last block that fits
+        EXPECT_LE(result.treeNodes, config.maxNodes);
+        EXPECT_GE(result.treeNodes, config.maxNodes * 9 / 10);
+    }
+}
@@ -0,0 +1,94 @@
+#include "gtest/gtest.h"
+#include "mnkSolver.h"
+#include <cstdio>
+#include <fstream>
+#include <random>
+
+TEST(MNKSolverTest, TicTacToeTest) {
+    MNKSolver solver(3, 3, 3, 4);
+    ASSERT_EQ(solver.solve(), ProofValue::draw);
+
+    // 765 positions up to symmetry can be reached in tic-tac-toe
+    ASSERT_EQ(solver.getNumPositions(), 765u);
+
+    // an edge reply to the centre opening loses
+    MNKBoard board(3, 3, 3);
+    ASSERT_TRUE(board.makeMove(1, 1, CellState::black));
+    ASSERT_TRUE(board.makeMove(0, 1, CellState::white));
+    ASSERT_EQ(solver.getValue(board), ProofValue::win);
+
+    // symmetric positions share their value
+    MNKBoard mirrorBoard(3, 3, 3);
+    ASSERT_TRUE(mirrorBoard.makeMove(1, 1, CellState::black));
+    ASSERT_TRUE(mirrorBoard.makeMove(1, 2, CellState::white));
+    ASSERT_EQ(solver.canonicalKey(solver.positionKey(board)), solver.canonicalKey(solver.positionKey(mirrorBoard)));
+    ASSERT_EQ(solver.getValue(mirrorBoard), ProofValue::win);
+}
+
+TEST(MNKSolverTest, RectangularTest) {
+    // three in a row is a first player win on a 4x3 board but not on a 3x2 one
+    MNKSolver solver(4, 3, 3, 4);
+    ASSERT_EQ(solver.solve(), ProofValue::win);
+
+    MNKSolver smallSolver(3, 2, 3, 2);
+    ASSERT_EQ(smallSolver.solve(), ProofValue::draw);
+}
+
+TEST(MNKSolverTest, ThreadCountTest) {
+    // the table must not depend on how the work was split
+    MNKSolver serialSolver(4, 3, 3, 1), parallelSolver(4, 3, 3, 8);
+    ASSERT_EQ(serialSolver.solve(), ProofValue::win);
+    ASSERT_EQ(parallelSolver.solve(), ProofValue::win);
+    ASSERT_EQ(serialSolver.getNumPositions(), parallelSolver.getNumPositions());
+
+    std::mt19937 randGen(7);
+    MNKBoard board(4, 3, 3);
+    for(int trialInd=0; trialInd<200; trialInd++) {
+        board.clearBoard();
+        CellState player = CellState::black;
+        for(int moveInd=0; moveInd<6; moveInd++) {
+            const int cell = randGen() % 12;
+            if(!board.isPosEmpty(cell / 3, cell % 3))
+                continue;
+            board.makeMove(cell / 3, cell % 3, player);
+            player = player == CellState::black ? CellState::white : CellState::black;
+        }
+        ASSERT_EQ(serialSolver.getValue(board), parallelSolver.getValue(board));
+    }
+}
+
+TEST(MNKSolverTest, DfpnAgreementTest) {
+    // the exhaustive table is the reference for the df-pn solver
+    MNKSolver solver(3, 3, 3, 2);
+    solver.solve();
+    DfpnSolver dfpn(1);
+
+    std::mt19937 randGen(11);
+    MNKBoard board(3, 3, 3);
+    for(int trialInd=0; trialInd<50; trialInd++) {
+        board.clearBoard();
+        CellState player = CellState::black;
+        for(int moveInd=0; moveInd<4 && !board.checkWin(); moveInd++) {
+            const int cell = randGen() % 9;
+            if(!board.isPosEmpty(cell / 3, cell % 3))
+                continue;
+            board.makeMove(cell / 3, cell % 3, player);
+            player = player == CellState::black ? CellState::white : CellState::black;
+        }
+        if(board.checkWin())
+            continue;
+        ASSERT_EQ(dfpn.solve(board).value, solver.getValue(board));
+    }
+}
+
+TEST(MNKSolverTest, SaveTableTest) {
+    MNKSolver solver(3, 3, 3, 2);
+    solver.solve();
+    ASSERT_TRUE(solver.saveTable("mnk_test_table.bin"));
+
+    // header plus one 9 byte record per position
+    std::ifstream tableFile("mnk_test_table.bin", std::ios::binary | std::ios::ate);
+    ASSERT_EQ(static_cast<std::size_t>(tableFile.tellg()), 4 + 16 + 9*solver.getNumPositions());
+    tableFile.close();
+    std::remove("mnk_test_table.bin");
+}
@@ -82,6 +82,68 @@ TEST_F(MNKGameTest, BSDWintest) {
     ASSERT_TRUE(board3.checkWin());
 }
 
+TEST_F(MNKGameTest, RectangularDiagWinTest) {
+    // diagonals of a non-square board only partially cover their line
+    MNKBoard wideBoard(3, 6, 3);
+    wideBoard.placePiece(2, 3, CellState::black);
+    wideBoard.placePiece(1, 4, CellState::black);
+    ASSERT_FALSE(wideBoard.checkWin());
+    wideBoard.placePiece(0, 5, CellState::black);
+    ASSERT_TRUE(wideBoard.checkWin());
+
+    wideBoard.clearBoard();
+    wideBoard.placePiece(0, 3, CellState::white);
+    wideBoard.placePiece(2, 5, CellState::white);
+    wideBoard.placePiece(1, 4, CellState::white);
+    ASSERT_TRUE(wideBoard.checkWin());
+    ASSERT_EQ(wideBoard.getCell(1, 4), CellState::white);
+    ASSERT_TRUE(wideBoard.isPosEmpty(2, 3));
+    ASSERT_FALSE(wideBoard.isPosEmpty(3, 0));
+}
+
+TEST_F(MNKGameTest, MakeUnmakeTest) {
+    ASSERT_TRUE(board2.makeMove(0, 0, CellState::black));
+    ASSERT_TRUE(board2.makeMove(1, 1, CellState::black));
+    ASSERT_FALSE(board2.makeMove(1, 1, CellState::white));
+    ASSERT_TRUE(board2.makeMove(2, 2, CellState::black));
+    ASSERT_TRUE(board2.checkWin());
+    ASSERT_EQ(board2.getMoveCount(), 3);
+
+    // taking back the winning move restores the previous last move
+    ASSERT_TRUE(board2.unmakeMove());
+    ASSERT_TRUE(board2.isPosEmpty(2, 2));
+    ASSERT_EQ(board2.getLastMove(), std::make_tuple(1, 1));
+    ASSERT_FALSE(board2.checkWin());
+
+    ASSERT_TRUE(board2.unmakeMove());
+    ASSERT_TRUE(board2.unmakeMove());
+    ASSERT_FALSE(board2.unmakeMove());
+    for(int rowInd = 0; rowInd < 3; rowInd++)
+        for(int colInd = 0; colInd < 3; colInd++)
+            ASSERT_TRUE(board2.isPosEmpty(rowInd, colInd));
+}
+
+TEST_F(MNKGameTest, HashKeyTest) {
+    ASSERT_EQ(board3.getHashKey(), 0u);
+    board3.makeMove(0, 0, CellState::black);
+    board3.makeMove(4, 4, CellState::white);
+    const auto firstKey = board3.getHashKey();
+
+    // the same position reached in another order has the same key
+    board3.clearBoard();
+    board3.placePiece(4, 4, CellState::white);
+    board3.placePiece(0, 0, CellState::black);
+    ASSERT_EQ(board3.getHashKey(), firstKey);
+
+    // colours matter, and taking pieces back restores the previous keys
+    board3.removePiece(0, 0);
+    board3.placePiece(0, 0, CellState::white);
+    ASSERT_NE(board3.getHashKey(), firstKey);
+    board3.removePiece(0, 0);
+    board3.removePiece(4, 4);
+    ASSERT_EQ(board3.getHashKey(), 0u);
+}
+
 TEST_F(MNKGameTest, Randomized3x3WinTest) {
     // enumerate possible combinations for 3x3 board
     int posIndVals[3] = {0, 1, 2};
@@ -136,4 +198,97 @@ TEST_F(MNKGameTest, Randomized5x5WinTest) {
         }
         numIters++;
     }
-}
\ No newline at end of file
+}
+
+TEST_F(MNKGameTest, SymmetryTest) {
+    // every symmetric image of a position shares its canonical key, and the transform
+    // maps each of them onto the same canonical image
+    const int moves[][2] = {{0, 1}, {2, 3}, {4, 4}, {1, 3}, {3, 0}};
+    std::uint64_t canonicalKey = 0;
+    std::vector<std::tuple<int, int, CellState>> canonicalImage;
+    for(int symInd=0; symInd<board3.getNumSymmetries(); symInd++) {
+        const MNKBoard::Symmetry sym = static_cast<MNKBoard::Symmetry>(symInd);
+        board3.clearBoard();
+        for(int moveInd=0; moveInd<5; moveInd++) {
+            const auto [row, col] = board3.transformCell(sym, moves[moveInd][0], moves[moveInd][1]);
+            ASSERT_EQ(board3.inverseTransformCell(sym, row, col), std::make_tuple(moves[moveInd][0], moves[moveInd][1]));
+            board3.makeMove(row, col, moveInd % 2 == 0 ? CellState::black : CellState::white);
+        }
+
+        MNKBoard::Symmetry transform;
+        const std::uint64_t key = board3.getCanonicalKey(transform);
+        std::vector<std::tuple<int, int, CellState>> image;
+        for(int rowInd=0; rowInd<5; rowInd++) {
+            for(int colInd=0; colInd<5; colInd++) {
+                if(board3.getCell(rowInd, colInd) == CellState::none)
+                    continue;
+                const auto [imageRow, imageCol] = board3.transformCell(transform, rowInd, colInd);
+                image.emplace_back(imageRow, imageCol, board3.getCell(rowInd, colInd));
+            }
+        }
+        std::sort(image.begin(), image.end());
+
+        if(symInd == 0) {
+            canonicalKey = key;
+            canonicalImage = image;
+        }
+        ASSERT_EQ(key, canonicalKey);
+        ASSERT_EQ(image, canonicalImage);
+    }
+
+    // quarter turns do not exist on a 3x6 board, and a different position keeps its own key
+    MNKBoard wideBoard(3, 6, 3);
+    ASSERT_EQ(wideBoard.getNumSymmetries(), 4);
+    MNKBoard::Symmetry cornerTransform, transform;
+    wideBoard.placePiece(0, 0, CellState::black);
+    const std::uint64_t cornerKey = wideBoard.getCanonicalKey(cornerTransform);
+    wideBoard.clearBoard();
+    wideBoard.placePiece(2, 5, CellState::black);
+    ASSERT_EQ(wideBoard.getCanonicalKey(transform), cornerKey);
+    ASSERT_EQ(wideBoard.transformCell(transform, 2, 5), wideBoard.transformCell(cornerTransform, 0, 0));
+    wideBoard.placePiece(1, 1, CellState::white);
+    ASSERT_NE(wideBoard.getCanonicalKey(transform), cornerKey);
+}
+
+TEST_F(MNKGameTest, CopyTest) {
+    // board2 runs on a compile-time board, board3 on a runtime one
+    for(MNKBoard* board : {&board2, &board3}) {
+        ASSERT_TRUE(board->makeMove(0, 0, CellState::black));
+        ASSERT_TRUE(board->makeMove(1, 1, CellState::white));
+        ASSERT_TRUE(board->makeMove(2, 0, CellState::black));
+
+        // a copy starts equal and then lives on its own
+        MNKBoard boardCopy(*board);
+        ASSERT_EQ(board->getHashKey(), boardCopy.getHashKey());
+        ASSERT_EQ(board->getMoveCount(), boardCopy.getMoveCount());
+        ASSERT_TRUE(boardCopy.getCell(1, 1) == CellState::white);
+        ASSERT_TRUE(boardCopy.makeMove(1, 0, CellState::black));
+        ASSERT_EQ(board->getWinSize() == 3, boardCopy.checkWin());
+        ASSERT_TRUE(board->isPosEmpty(1, 0));
+
+        // the undo stack comes along
+        ASSERT_TRUE(boardCopy.unmakeMove());
+        ASSERT_TRUE(boardCopy.unmakeMove());
+        ASSERT_TRUE(boardCopy.isPosEmpty(2, 0));
+        ASSERT_FALSE(board->isPosEmpty(2, 0));
+
+        // assigning back, and moving
+        boardCopy = *board;
+        ASSERT_EQ(board->getHashKey(), boardCopy.getHashKey());
+        MNKBoard movedBoard(std::move(boardCopy));
+        ASSERT_EQ(board->getHashKey(), movedBoard.getHashKey());
+        ASSERT_TRUE(movedBoard.unmakeMove());
+        ASSERT_TRUE(movedBoard.isPosEmpty(2, 0));
+        board->clearBoard();
+    }
+
+    // assigning a board of another size takes its size
+    BoardArena arena;
+    MNKBoard arenaBoard(board2, &arena);
+    board3.placePiece(4, 4, CellState::white);
+    arenaBoard = board3;
+    ASSERT_EQ(std::make_tuple(5, 5), arenaBoard.getBoardSize());
+    ASSERT_EQ(5, arenaBoard.getWinSize());
+    ASSERT_TRUE(arenaBoard.getCell(4, 4) == CellState::white);
+    ASSERT_EQ(board3.getHashKey(), arenaBoard.getHashKey());
+}
@@ -0,0 +1,140 @@
+#include "gtest/gtest.h"
+#include "moveGenerator.h"
+#include <algorithm>
+#include <random>
+#include <vector>
+
+// Implements tests for the staged move generator
+class MoveGeneratorTest : public ::testing::Test {
+protected:
+    typedef MoveGenerator::Stage Stage;
+
+    Omok board1;
+    int moves[15*15];
+
+    // testing constants
+    static const int BOARD_SIZE = 15;
+
+    void playMoves(const std::vector<std::pair<int, int>>& moveList) {
+        for(const auto& [row, col] : moveList)
+            ASSERT_TRUE(board1.makeMove(row, col));
+    }
+};
+
+TEST_F(MoveGeneratorTest, FirstMoveTest) {
+    MoveGenerator generator(board1);
+    ASSERT_EQ(generator.nextBatch(moves), 1);
+    ASSERT_EQ(moves[0], 7*BOARD_SIZE + 7);
+    ASSERT_EQ(generator.getStage(), Stage::quiet);
+    ASSERT_EQ(generator.nextBatch(moves), 0);
+}
+
+TEST_F(MoveGeneratorTest, NeighbourhoodTest) {
+    std::mt19937 rng(14);
+    std::uniform_int_distribution<int> cellDist(4, 10);
+    for(int numMoves=0; numMoves<20 && !board1.isFinished(); )
+        if(board1.makeMove(cellDist(rng), cellDist(rng)))
+            numMoves++;
+    board1.unmakeMove();
+    board1.unmakeMove();
+
+    // every empty cell within two cells of a piece that the side to move may play
+    std::vector<int> expected;
+    for(int rowInd=0; rowInd<BOARD_SIZE; rowInd++) {
+        for(int colInd=0; colInd<BOARD_SIZE; colInd++) {
+            bool isNear = false;
+            for(int nearRow=std::max(0, rowInd-2); nearRow<=std::min(BOARD_SIZE-1, rowInd+2); nearRow++)
+                for(int nearCol=std::max(0, colInd-2); nearCol<=std::min(BOARD_SIZE-1, colInd+2); nearCol++)
+                    isNear = isNear || board1.getCell(nearRow, nearCol) != CellState::none;
+            if(isNear && board1.isPosEmpty(rowInd, colInd) && !board1.isForbidden(rowInd, colInd))
+                expected.push_back(rowInd*BOARD_SIZE + colInd);
+        }
+    }
+
+    MoveGenerator generator(board1);
+    const int numMoves = generator.generateAll(moves);
+    std::vector<int> generated(moves, moves+numMoves);
+    std::sort(generated.begin(), generated.end());
+    ASSERT_EQ(generated, expected);
+}
+
+TEST_F(MoveGeneratorTest, WinTest) {
+    // black has an open four and white a four: only the wins of black are generated
+    playMoves({{7, 4}, {0, 0}, {7, 5}, {0, 1}, {7, 6}, {0, 2}, {7, 7}, {0, 3}});
+    MoveGenerator generator(board1);
+    ASSERT_EQ(generator.nextBatch(moves), 2);
+    ASSERT_EQ(generator.getStage(), Stage::wins);
+    ASSERT_EQ(generator.nextBatch(moves), 0);
+}
+
+TEST_F(MoveGeneratorTest, BlockTest) {
+    // white has to fill the cell completing the four of black
+    playMoves({{7, 3}, {8, 3}, {7, 4}, {8, 4}, {7, 5}, {9, 9}, {7, 6}});
+    MoveGenerator generator(board1);
+    ASSERT_EQ(generator.nextBatch(moves), 2);
+    ASSERT_EQ(generator.getStage(), Stage::blocks);
+    ASSERT_EQ(std::min(moves[0], moves[1]), 7*BOARD_SIZE + 2);
+    ASSERT_EQ(std::max(moves[0], moves[1]), 7*BOARD_SIZE + 7);
+    ASSERT_EQ(generator.nextBatch(moves), 0);
+}
+
+TEST_F(MoveGeneratorTest, OrderTest) {
+    // (7, 6) would be a double three for black
+    playMoves({{7, 7}, {0, 0}, {7, 8}, {0, 14}, {8, 6}, {14, 0}, {9, 6}, {14, 14}});
+    ASSERT_TRUE(board1.isForbidden(7, 6));
+
+    MoveGenerator generator(board1);
+    const ThreatCache& threats = board1.getThreats();
+    Stage prevStage = Stage::wins;
+    int numBatches = 0;
+    for(int batchSize=generator.nextBatch(moves); batchSize>0; batchSize=generator.nextBatch(moves)) {
+        ASSERT_GT(generator.getStage(), prevStage);
+        prevStage = generator.getStage();
+        numBatches++;
+
+        int prevScore = ThreatCache::FIVE_SCORE;
+        for(int moveInd=0; moveInd<batchSize; moveInd++) {
+            const int row = moves[moveInd] / BOARD_SIZE, col = moves[moveInd] % BOARD_SIZE;
+            ASSERT_NE(moves[moveInd], 7*BOARD_SIZE + 6);
+            const int score = threats.getCellScore(CellState::black, row, col) + threats.getCellScore(CellState::white, row, col);
+            ASSERT_LE(score, prevScore);
+            prevScore = score;
+        }
+    }
+    ASSERT_EQ(numBatches, 2);
+    ASSERT_EQ(prevStage, Stage::quiet);
+}
+
+TEST_F(MoveGeneratorTest, GenerateAllTest) {
+    std::mt19937 rng(23);
+    std::uniform_int_distribution<int> cellDist(3, 11);
+    int batchMoves[15*15];
+    for(int numMoves=0; numMoves<40 && !board1.isFinished(); ) {
+        if(!board1.makeMove(cellDist(rng), cellDist(rng)))
+            continue;
+        numMoves++;
+
+        // all batches at once are the batches one after the other
+        MoveGenerator batchGenerator(board1), allGenerator(board1);
+        int numBatchMoves = 0;
+        for(int batchSize=batchGenerator.nextBatch(batchMoves); batchSize>0;
+            batchSize=batchGenerator.nextBatch(batchMoves+numBatchMoves))
+            numBatchMoves += batchSize;
+        const int numAllMoves = allGenerator.generateAll(moves);
+        ASSERT_EQ(std::vector<int>(batchMoves, batchMoves+numBatchMoves), std::vector<int>(moves, moves+numAllMoves));
+        ASSERT_EQ(batchGenerator.getStage(), allGenerator.getStage());
+
+        // unsorted batches hold the same moves
+        MoveGenerator unsortedGenerator(board1, false);
+        ASSERT_EQ(unsortedGenerator.generateAll(moves), numAllMoves);
+        std::sort(moves, moves+numAllMoves);
+        std::sort(batchMoves, batchMoves+numBatchMoves);
+        ASSERT_EQ(std::vector<int>(batchMoves, batchMoves+numBatchMoves), std::vector<int>(moves, moves+numAllMoves));
+
+        // the wins alone, and every candidate with the forbidden ones
+        MoveGenerator winGenerator(board1);
+        const int numWins = winGenerator.generateWins(moves);
+        ASSERT_EQ(numWins > 0, batchGenerator.getStage() == Stage::wins);
+        ASSERT_GE(MoveGenerator::candidateCells(board1, moves), numAllMoves);
+    }
+}
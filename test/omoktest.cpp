@@ -1,14 +1,16 @@
 #include "gtest/gtest.h"
 #include "gomoku.h"
+#include "psqReader.h"
 #include <iostream>
 #include <sstream>
 #include <utility>
+#include <tuple>
+#include <vector>
 #include <ctime>
 #include <cstdlib>
 #include <fstream>
 #include <filesystem>
 namespace fs = std::filesystem;
-#include <regex>
 
 
 // Implements a fixture to test the Omok class
@@ -27,6 +29,7 @@ protected:
 
     // testing constants
     static const int NUM_TRIALS = 50;
+    static const int BOARD_SIZE = 15;
 };
 
 TEST_F(OmokGameTest, PlacementTest) {
@@ -38,6 +41,263 @@ TEST_F(OmokGameTest, WinnerTest) {
 
 }
 
+TEST_F(OmokGameTest, DoubleThreeTest) {
+    // black builds a row and a column that would both become open threes at (7,7)
+    int moves[8][2] = {{7,5}, {0,0}, {7,6}, {0,2}, {5,7}, {0,4}, {6,7}, {14,14}};
+    for(auto& move : moves)
+        ASSERT_TRUE(board1.placePiece(move[0], move[1]));
+    ASSERT_FALSE(board1.placePiece(7, 7));
+
+    // black is still to move and may play elsewhere
+    ASSERT_TRUE(board1.placePiece(7, 4));
+    ASSERT_FALSE(board1.isFinished());
+}
+
+TEST_F(OmokGameTest, RenjuOverlineTest) {
+    // black would join two runs on row 7 into six
+    int moves[10][2] = {{7,2}, {0,0}, {7,3}, {0,2}, {7,4}, {0,4}, {7,6}, {0,6}, {7,7}, {0,8}};
+    Omok renjuGame(Omok::RuleSet::renju);
+    for(auto& move : moves) {
+        ASSERT_TRUE(board1.makeMove(move[0], move[1]));
+        ASSERT_TRUE(renjuGame.makeMove(move[0], move[1]));
+    }
+
+    // an overline is only a non-winning move under the Omok rules
+    ASSERT_TRUE(renjuGame.isForbidden(7, 5));
+    ASSERT_FALSE(renjuGame.makeMove(7, 5));
+    ASSERT_TRUE(board1.makeMove(7, 5));
+    ASSERT_FALSE(board1.isFinished());
+}
+
+TEST_F(OmokGameTest, FreeRulesTest) {
+    // black prepares a double three at (7,7) and two runs on row 3 that (3,5) joins into six
+    int moves[12][2] = {{7,5}, {0,0}, {7,6}, {0,2}, {5,7}, {0,4}, {6,7}, {0,6}, {3,2}, {0,8}, {3,3}, {0,10}};
+    Omok freestyleGame(Omok::RuleSet::freestyle), standardGame(Omok::RuleSet::standard);
+    for(auto& move : moves) {
+        ASSERT_TRUE(freestyleGame.makeMove(move[0], move[1]));
+        ASSERT_TRUE(standardGame.makeMove(move[0], move[1]));
+    }
+    for(int col : {4, 6, 7})
+        for(Omok* game : {&freestyleGame, &standardGame})
+            ASSERT_TRUE(game->makeMove(3, col) && game->makeMove(1, 2*col % BOARD_SIZE));
+
+    // neither rule set forbids a move
+    int forbiddenCells[BOARD_SIZE*BOARD_SIZE];
+    for(Omok* game : {&freestyleGame, &standardGame}) {
+        EXPECT_FALSE(game->isForbidden(7, 7));
+        EXPECT_EQ(0, game->getForbiddenPoints(forbiddenCells));
+        ASSERT_TRUE(game->makeMove(7, 7));
+        EXPECT_FALSE(game->isFinished());
+        ASSERT_TRUE(game->unmakeMove());
+    }
+
+    // the overline wins only under freestyle
+    ASSERT_TRUE(freestyleGame.makeMove(3, 5));
+    EXPECT_TRUE(freestyleGame.isFinished());
+    EXPECT_EQ(1, freestyleGame.getGameWinner());
+    ASSERT_TRUE(standardGame.makeMove(3, 5));
+    EXPECT_FALSE(standardGame.isFinished());
+}
+
+TEST_F(OmokGameTest, RenjuDoubleFourTest) {
+    // fours along row 7 and column 7 meet at (7,7)
+    int moves[12][2] = {{7,4}, {0,0}, {4,7}, {0,2}, {7,5}, {0,4}, {5,7}, {0,6}, {7,6}, {0,8}, {6,7}, {0,10}};
+    Omok renjuGame(Omok::RuleSet::renju);
+    for(auto& move : moves) {
+        ASSERT_TRUE(board1.makeMove(move[0], move[1]));
+        ASSERT_TRUE(renjuGame.makeMove(move[0], move[1]));
+    }
+    ASSERT_FALSE(board1.isForbidden(7, 7));
+    ASSERT_TRUE(renjuGame.isForbidden(7, 7));
+
+    // two fours on a single line (x.xxx.x) count as well
+    Omok lineGame(Omok::RuleSet::renju);
+    int lineMoves[8][2] = {{7,3}, {0,0}, {7,5}, {0,2}, {7,7}, {0,4}, {7,9}, {0,6}};
+    for(auto& move : lineMoves)
+        ASSERT_TRUE(lineGame.makeMove(move[0], move[1]));
+    ASSERT_FALSE(lineGame.makeMove(7, 6));
+    ASSERT_TRUE(lineGame.makeMove(7, 4));
+}
+
+TEST_F(OmokGameTest, RenjuRecursiveThreeTest) {
+    // black threes on row 7 (blocked on the left by white) and column 7 cross at (7,7)
+    Omok renjuGame(Omok::RuleSet::renju);
+    int moves[8][2] = {{7,5}, {7,3}, {7,6}, {0,0}, {8,7}, {0,2}, {9,7}, {0,4}};
+    for(auto& move : moves)
+        ASSERT_TRUE(renjuGame.makeMove(move[0], move[1]));
+    ASSERT_TRUE(renjuGame.isForbidden(7, 7));
+
+    // once (7,8) would be a double four, the row can not become a straight four any more
+    // and is no real three
+    int moreMoves[5][2] = {{4,8}, {0,6}, {5,8}, {0,8}, {6,8}};
+    for(auto& move : moreMoves)
+        ASSERT_TRUE(renjuGame.makeMove(move[0], move[1]));
+    ASSERT_TRUE(renjuGame.makeMove(0, 10));
+    ASSERT_FALSE(renjuGame.isForbidden(7, 7));
+    ASSERT_TRUE(renjuGame.isDoubleThree(7, 7));
+    ASSERT_TRUE(renjuGame.makeMove(7, 7));
+
+    // and (7,8) is indeed a double four for black
+    ASSERT_TRUE(renjuGame.makeMove(0, 12));
+    ASSERT_TRUE(renjuGame.isForbidden(7, 8));
+}
+
+TEST_F(OmokGameTest, RenjuFiveTest) {
+    // (7,7) completes five on row 7 while also making fours on column 7 and a diagonal
+    Omok renjuGame(Omok::RuleSet::renju);
+    int moves[20][2] = {{7,3}, {0,0}, {4,7}, {0,2}, {4,10}, {0,4}, {7,4}, {0,6}, {5,7}, {0,8},
+                        {5,9}, {0,10}, {7,5}, {0,12}, {6,7}, {0,14}, {6,8}, {14,0}, {7,6}, {14,2}};
+    for(auto& move : moves)
+        ASSERT_TRUE(renjuGame.makeMove(move[0], move[1]));
+    ASSERT_FALSE(renjuGame.isForbidden(7, 7));
+    ASSERT_TRUE(renjuGame.makeMove(7, 7));
+    ASSERT_TRUE(renjuGame.isFinished());
+    ASSERT_EQ(renjuGame.getGameWinner(), 1);
+}
+
+TEST_F(OmokGameTest, ForbiddenPointsTest) {
+    // the row and column threes of black cross at (7,7)
+    Omok renjuGame(Omok::RuleSet::renju);
+    int moves[8][2] = {{7,5}, {0,0}, {7,6}, {0,2}, {5,7}, {0,4}, {6,7}, {14,14}};
+    for(auto& move : moves)
+        ASSERT_TRUE(renjuGame.makeMove(move[0], move[1]));
+
+    int cells[225];
+    ASSERT_EQ(renjuGame.getForbiddenPoints(cells), 1);
+    ASSERT_EQ(cells[0], 7*15 + 7);
+
+    // white has no forbidden points here, and undoing the white move restores black's
+    ASSERT_TRUE(renjuGame.makeMove(7, 4));
+    ASSERT_EQ(renjuGame.getForbiddenPoints(cells), 0);
+    ASSERT_TRUE(renjuGame.unmakeMove());
+    ASSERT_EQ(renjuGame.getForbiddenPoints(cells), 1);
+
+    // nothing is forbidden before the first move
+    renjuGame.clearBoard();
+    ASSERT_EQ(renjuGame.getForbiddenPoints(cells), 0);
+}
+
+TEST_F(OmokGameTest, UnmakeMoveTest) {
+    // black wins along row 7 while white plays along row 0
+    for(int colInd = 0; colInd < 4; colInd++) {
+        ASSERT_TRUE(board1.makeMove(7, colInd));
+        ASSERT_TRUE(board1.makeMove(0, colInd));
+    }
+    ASSERT_TRUE(board1.makeMove(7, 4));
+    ASSERT_TRUE(board1.isFinished());
+    ASSERT_EQ(board1.getGameWinner(), 1);
+
+    // undoing the win hands the move back to black
+    ASSERT_TRUE(board1.unmakeMove());
+    ASSERT_FALSE(board1.isFinished());
+    ASSERT_EQ(board1.getGameWinner(), 0);
+    ASSERT_TRUE(board1.isPosEmpty(7, 4));
+    ASSERT_TRUE(board1.makeMove(7, 4));
+    ASSERT_EQ(board1.getGameWinner(), 1);
+
+    // unwinding everything leaves a fresh game
+    while(board1.unmakeMove());
+    ASSERT_EQ(board1.getMoveCount(), 0);
+    ASSERT_TRUE(board1.makeMove(0, 0));
+    ASSERT_TRUE(board1.makeMove(0, 1));
+    ASSERT_FALSE(board1.isPosEmpty(0, 0));
+    ASSERT_EQ(board1.getGameWinner(), 0);
+}
+
+TEST_F(OmokGameTest, HashKeyTest) {
+    // two move orders reaching the same position share a key
+    int orderA[4][2] = {{7,7}, {7,8}, {8,8}, {6,6}};
+    int orderB[4][2] = {{8,8}, {6,6}, {7,7}, {7,8}};
+    for(auto& move : orderA)
+        ASSERT_TRUE(board1.makeMove(move[0], move[1]));
+    const auto keyA = board1.getHashKey();
+    board1.clearBoard();
+    for(auto& move : orderB)
+        ASSERT_TRUE(board1.makeMove(move[0], move[1]));
+    ASSERT_EQ(board1.getHashKey(), keyA);
+
+    // the side to move is part of the key
+    board1.unmakeMove();
+    const auto keyBlack = board1.getHashKey();
+    board1.makeMove(7, 8);
+    board1.unmakeMove();
+    ASSERT_EQ(board1.getHashKey(), keyBlack);
+    while(board1.unmakeMove());
+    ASSERT_EQ(board1.getHashKey(), 0u);
+}
+
+TEST_F(OmokGameTest, CopyTest) {
+    BoardArena arena;
+    Omok renjuGame(Omok::RuleSet::renju, &arena);
+    const int moves[][2] = {{7, 7}, {6, 6}, {7, 8}, {6, 8}, {8, 7}, {5, 9}};
+    for(auto& move : moves)
+        ASSERT_TRUE(renjuGame.makeMove(move[0], move[1]));
+
+    // the copy carries the rules, the undo stack and the threat cache
+    Omok gameCopy(renjuGame);
+    ASSERT_TRUE(gameCopy.getRuleSet() == Omok::RuleSet::renju);
+    ASSERT_EQ(renjuGame.getHashKey(), gameCopy.getHashKey());
+    ASSERT_TRUE(renjuGame.getCurrentPlayer() == gameCopy.getCurrentPlayer());
+    for(int rowInd=0; rowInd<BOARD_SIZE; rowInd++)
+        for(int colInd=0; colInd<BOARD_SIZE; colInd++)
+            ASSERT_EQ(renjuGame.getThreats().getCellScore(CellState::black, rowInd, colInd),
+                      gameCopy.getThreats().getCellScore(CellState::black, rowInd, colInd));
+
+    // both continue on their own
+    ASSERT_TRUE(gameCopy.makeMove(0, 0));
+    ASSERT_TRUE(renjuGame.isPosEmpty(0, 0));
+    while(gameCopy.unmakeMove());
+    ASSERT_EQ(gameCopy.getMoveCount(), 0);
+    ASSERT_EQ(renjuGame.getMoveCount(), 6);
+
+    // snapshots on the arena, assigned in place
+    Omok snapshot(renjuGame, &arena);
+    ASSERT_TRUE(renjuGame.makeMove(8, 8));
+    snapshot = renjuGame;
+    ASSERT_FALSE(snapshot.isPosEmpty(8, 8));
+    ASSERT_EQ(renjuGame.isForbidden(9, 9), snapshot.isForbidden(9, 9));
+    board1 = std::move(snapshot);
+    ASSERT_TRUE(board1.getRuleSet() == Omok::RuleSet::renju);
+    ASSERT_TRUE(board1.unmakeMove());
+    ASSERT_TRUE(board1.isPosEmpty(8, 8));
+
+    // the fixture's board outlives the arena
+    board1 = Omok();
+}
+
+TEST_F(OmokGameTest, SetPositionTest) {
+    // (7,7) completes a double three once the other black stones are down, so the
+    // position only comes from a game in which it was played first
+    std::vector<std::tuple<int, int>> blackStones = {{7,5}, {7,6}, {5,7}, {6,7}, {7,7}};
+    std::vector<std::tuple<int, int>> whiteStones = {{0,0}, {0,2}, {0,4}, {14,14}};
+    ASSERT_TRUE(board1.setPosition(blackStones, whiteStones));
+    ASSERT_TRUE(board1.getCurrentPlayer() == CellState::white);
+    ASSERT_EQ(9, board1.getMoveCount());
+
+    // the same position played in order, with the threat cache rebuilt
+    Omok playedGame;
+    const int moves[9][2] = {{7,7}, {0,0}, {7,5}, {0,2}, {7,6}, {0,4}, {5,7}, {14,14}, {6,7}};
+    for(auto& move : moves)
+        ASSERT_TRUE(playedGame.makeMove(move[0], move[1]));
+    ASSERT_EQ(playedGame.getHashKey(), board1.getHashKey());
+    for(int rowInd=0; rowInd<BOARD_SIZE; rowInd++)
+        for(int colInd=0; colInd<BOARD_SIZE; colInd++)
+            ASSERT_EQ(playedGame.getThreats().getCellScore(CellState::black, rowInd, colInd),
+                      board1.getThreats().getCellScore(CellState::black, rowInd, colInd));
+    ASSERT_TRUE(board1.makeMove(7, 4));
+    ASSERT_TRUE(board1.unmakeMove());
+
+    // uneven counts, shared cells and finished games are turned down
+    whiteStones.pop_back();
+    ASSERT_FALSE(board1.setPosition(whiteStones, blackStones));
+    ASSERT_EQ(0, board1.getMoveCount());
+    ASSERT_FALSE(board1.setPosition(blackStones, {{7,7}, {0,2}, {0,4}, {14,14}}));
+    blackStones.insert(blackStones.end(), {{7,8}, {7,9}});
+    whiteStones.insert(whiteStones.end(), {{14,14}, {14,12}, {14,10}});
+    ASSERT_FALSE(board1.setPosition(blackStones, whiteStones));
+    ASSERT_TRUE(board1.isPosEmpty(7, 7));
+}
+
 /**
  *  Turns out that finding a proper GOMOKU dataset is difficult to do. For now, the
  *  test is simply running through RENJU games and verifying that everything is fine.
@@ -49,47 +309,28 @@ TEST_F(OmokGameTest, SimulatedGameTest) {
     // loads in a series of game files played by previous AIs
     // Note that there is no randomization due to the walk nature of the iterator
     std::string datPath = "../test/SimulatedGames/";
-    std::regex csvPattern = std::regex("\\d+,\\d+,\\d+");
     unsigned int curTrial = 0;
-
-    // string parsing variables
-    std::ifstream gameFile;
-    std::string sToParse;
-    std::string tempVar;
-    std::string lastString;     // determine the winner using this string at the end
-    int inX, inY, winVal, moveNum;
+    int winVal, moveNum, width, height;
+    PsqMove move;
 
     for(auto& fileEntry : fs::directory_iterator(datPath)) {
         // clears the board for playing
         board1.clearBoard();
         moveNum = 0;
 
-        // open file and parse only the moves (who moves first doesn't matter)
-        gameFile.open(fileEntry.path(), std::ifstream::in);
-        std::getline(gameFile, sToParse);   // skip introductory line
-        while(std::getline(gameFile, sToParse)) { // parse only the relevant lines that we need
-            if(std::regex_search(sToParse, csvPattern)) {
-                std::istringstream curLine = std::istringstream(sToParse);
-                
-                std::getline(curLine, tempVar, ',');
-                std::istringstream(tempVar) >> inX;
-                std::getline(curLine, tempVar, ',');
-                std::istringstream(tempVar) >> inY;     // last value not necessary
-
-                // play the game given values (every move must be valid until the very last one)
-                ASSERT_TRUE(board1.placePiece(inX-1, inY-1)) << fileEntry.path();
-                moveNum += 1;
-            }
-
-            lastString = sToParse; // move string into new container before rewriting it
+        // map the file and read only the moves (who moves first doesn't matter)
+        MappedFile gameFile(fileEntry.path().string());
+        ASSERT_TRUE(gameFile.isOpen()) << fileEntry.path();
+        PsqScanner scanner(gameFile.data(), gameFile.data() + gameFile.size());
+        ASSERT_TRUE(scanner.readHeader(width, height)) << fileEntry.path();
+        while(scanner.nextMove(move)) {
+            // play the game given values (every move must be valid until the very last one)
+            ASSERT_TRUE(board1.placePiece(move.x-1, move.y-1)) << fileEntry.path();
+            moveNum += 1;
         }
-        gameFile.close();   // safely close file after we read all the moves
 
         // once we're outside we confirm the winner (or draw state) using the filename
-        std::istringstream winLine = std::istringstream(fileEntry.path().stem());
-        for(int i = 0; i < 4; i++)
-            std::getline(winLine, tempVar, '_');
-        std::istringstream(tempVar) >> winVal;
+        winVal = PsqReplayer::expectedWinner(fileEntry.path().string());
         ASSERT_EQ(winVal, board1.getGameWinner()) << "Failed on test " << fileEntry.path() << "in " << moveNum << " moves...";
 
         // exit condition since there are quite a few simulations in the folder
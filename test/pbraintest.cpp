@@ -0,0 +1,225 @@
+#include "gtest/gtest.h"
+#include "pbrainEngine.h"
+#include <chrono>
+#include <cstdio>
+#include <sstream>
+#include <string>
+
+// Implements a fixture in which a scripted referee stands in for the tournament manager
+class PbrainTest : public ::testing::Test {
+protected:
+    PbrainTest() : engine(true) {}
+
+    PbrainEngine engine;
+
+    // sends one line to the engine and returns its reply (without the line break)
+    std::string send(const std::string& line) {
+        std::ostringstream reply;
+        engine.handleLine(line, reply);
+        std::string replyText = reply.str();
+        if(!replyText.empty() && replyText.back() == '\n')
+            replyText.pop_back();
+        return replyText;
+    }
+
+    // reads a move reply "x,y" into board coordinates
+    static bool readMove(const std::string& reply, int& row, int& col) {
+        char comma, extra;
+        return std::sscanf(reply.c_str(), "%d%c%d%c", &col, &comma, &row, &extra) == 3 && comma == ',';
+    }
+};
+
+TEST_F(PbrainTest, TimeControlTest) {
+    TimeControl timeControl;
+    EXPECT_EQ(4500, timeControl.getMoveBudgetMs(0));
+    timeControl.turnMs = 0;
+    EXPECT_EQ(TimeControl::MIN_MOVE_MS, timeControl.getMoveBudgetMs(0));
+
+    // the match time is spread over the moves still to come
+    timeControl.turnMs = 30000;
+    timeControl.matchMs = 180000;
+    timeControl.timeLeftMs = 60000;
+    EXPECT_EQ(900, timeControl.getMoveBudgetMs(0));
+    EXPECT_EQ(5400, timeControl.getMoveBudgetMs(110));
+    timeControl.timeLeftMs = 100;
+    EXPECT_EQ(TimeControl::MIN_MOVE_MS, timeControl.getMoveBudgetMs(50));
+}
+
+TEST_F(PbrainTest, ProtocolTest) {
+    EXPECT_EQ(0u, send("ABOUT").find("name=\"GomokuSolver\""));
+    EXPECT_EQ(0u, send("BEGIN").find("ERROR"));
+    EXPECT_EQ(0u, send("START 20").find("ERROR"));
+    EXPECT_EQ("OK", send("START 15"));
+    EXPECT_EQ("", send("INFO timeout_turn 100"));
+    EXPECT_EQ(100, engine.getTimeControl().turnMs);
+
+    // the first move is the engine's
+    int row, col;
+    const std::string reply = send("BEGIN");
+    ASSERT_TRUE(readMove(reply, row, col)) << reply;
+    EXPECT_TRUE(engine.getGame().getCell(row, col) == CellState::black);
+    EXPECT_TRUE(engine.isPondering());
+
+    // x is the column
+    EXPECT_EQ(0u, send("TURN " + std::to_string(col) + "," + std::to_string(row)).find("ERROR"));
+    EXPECT_FALSE(engine.isPondering());
+    ASSERT_TRUE(readMove(send("TURN 0,1"), row, col));
+    EXPECT_TRUE(engine.getGame().getCell(1, 0) == CellState::white);
+    EXPECT_EQ(3, engine.getGame().getMoveCount());
+    EXPECT_EQ("OK", send("TAKEBACK " + std::to_string(col) + "," + std::to_string(row)));
+    EXPECT_EQ(0u, send("TAKEBACK 14,14").find("ERROR"));
+    EXPECT_EQ(2, engine.getGame().getMoveCount());
+
+    EXPECT_EQ("UNKNOWN SWAP", send("SWAP"));
+    EXPECT_EQ("OK", send("RESTART"));
+    EXPECT_EQ(0, engine.getGame().getMoveCount());
+    std::ostringstream reply2;
+    EXPECT_FALSE(engine.handleLine("END", reply2));
+}
+
+TEST_F(PbrainTest, MaxMemoryTest) {
+    EXPECT_EQ(0u, engine.getTableSizeMB());
+    send("INFO max_memory 83886080");
+    ASSERT_EQ("OK", send("START 15"));
+    EXPECT_EQ(40u, engine.getTableSizeMB());
+
+    // INFO follows START in a tournament and still sizes the table of the empty board
+    send("INFO max_memory 20971520");
+    EXPECT_EQ(10u, engine.getTableSizeMB());
+    send("INFO timeout_turn 50");
+    std::string reply = send("BEGIN");
+    int row, col;
+    ASSERT_TRUE(readMove(reply, row, col)) << reply;
+
+    // during a game the table is kept until the next game
+    send("INFO max_memory 0");
+    EXPECT_EQ(10u, engine.getTableSizeMB());
+    EXPECT_EQ("OK", send("RESTART"));
+    EXPECT_EQ(PbrainEngine::DEFAULT_TT_MB, engine.getTableSizeMB());
+}
+
+TEST_F(PbrainTest, BoardTest) {
+    ASSERT_EQ("OK", send("START 15"));
+    send("INFO rule 4");
+    send("INFO timeout_turn 100");
+    EXPECT_TRUE(engine.getGame().getRuleSet() == Omok::RuleSet::renju);
+
+    // the stones may come in any order; equal counts make the engine black
+    for(const char* line : {"BOARD", "8,8,2", "7,7,1", "6,6,2", "7,8,1"})
+        EXPECT_EQ("", send(line));
+    int row, col;
+    const std::string reply = send("DONE");
+    ASSERT_TRUE(readMove(reply, row, col)) << reply;
+    EXPECT_TRUE(engine.getGame().getCell(7, 7) == CellState::black);
+    EXPECT_TRUE(engine.getGame().getCell(8, 8) == CellState::white);
+    EXPECT_TRUE(engine.getGame().getCell(row, col) == CellState::black);
+    EXPECT_EQ(5, engine.getGame().getMoveCount());
+
+    // (7,7) is a Renju double three once the other black stones are down, so it was played
+    // first; the opponent has one stone more and the engine plays white
+    ASSERT_EQ("OK", send("RESTART"));
+    for(const char* line : {"BOARD", "5,7,2", "0,0,1", "6,7,2", "2,0,1", "7,5,2", "4,0,1", "7,6,2", "14,14,1", "7,7,2"})
+        EXPECT_EQ("", send(line));
+    const std::string whiteReply = send("DONE");
+    ASSERT_TRUE(readMove(whiteReply, row, col)) << whiteReply;
+    EXPECT_TRUE(engine.getGame().getCell(7, 7) == CellState::black);
+    EXPECT_TRUE(engine.getGame().getCell(0, 0) == CellState::white);
+    EXPECT_EQ(10, engine.getGame().getMoveCount());
+
+    // one side cannot be two stones ahead
+    for(const char* line : {"BOARD", "1,1,1", "2,2,1"})
+        send(line);
+    EXPECT_EQ(0u, send("DONE").find("ERROR"));
+}
+
+TEST_F(PbrainTest, RuleTest) {
+    ASSERT_EQ("OK", send("START 15"));
+    send("INFO timeout_turn 100");
+    EXPECT_TRUE(engine.getGame().getRuleSet() == Omok::RuleSet::freestyle);
+    send("INFO rule 4");
+    EXPECT_TRUE(engine.getGame().getRuleSet() == Omok::RuleSet::renju);
+    send("INFO rule 0");
+    EXPECT_TRUE(engine.getGame().getRuleSet() == Omok::RuleSet::freestyle);
+    send("INFO rule 1");
+    EXPECT_TRUE(engine.getGame().getRuleSet() == Omok::RuleSet::standard);
+
+    // the opponent (white) prepares a double three at (7,7) and at (11,11); the engine
+    // plays black and can spoil only one of them
+    for(const char* line : {"BOARD", "5,7,2", "6,7,2", "7,5,2", "7,6,2", "9,11,2", "10,11,2", "11,9,2", "11,10,2",
+                            "0,0,1", "3,0,1", "6,0,1", "9,0,1", "0,14,1", "3,14,1", "6,14,1", "9,14,1"})
+        EXPECT_EQ("", send(line));
+    int row, col;
+    const std::string reply = send("DONE");
+    ASSERT_TRUE(readMove(reply, row, col)) << reply;
+    Omok game = engine.getGame();
+    const int threeRow = game.isDoubleThree(7, 7) ? 7 : 11;
+    ASSERT_TRUE(game.isDoubleThree(threeRow, threeRow));
+
+    // a double three is legal under the standard rules, so the engine answers it with a move
+    const std::string turnReply = send("TURN " + std::to_string(threeRow) + "," + std::to_string(threeRow));
+    ASSERT_TRUE(readMove(turnReply, row, col)) << turnReply;
+    EXPECT_TRUE(engine.getGame().getCell(threeRow, threeRow) == CellState::white);
+    EXPECT_TRUE(engine.getGame().getCell(row, col) == CellState::black);
+    EXPECT_EQ(19, engine.getGame().getMoveCount());
+}
+
+TEST_F(PbrainTest, RefereeGameTest) {
+    const int turnMs = 100;
+    ASSERT_EQ("OK", send("START 15"));
+    send("INFO timeout_turn " + std::to_string(turnMs));
+    send("INFO timeout_match 100000");
+
+    // the referee plays white with a shallow search and checks every reply (under the
+    // freestyle rules the engine takes without INFO rule)
+    Omok refereeGame(Omok::RuleSet::freestyle);
+    Searcher opponent(1);
+    SearchLimits opponentLimits;
+    opponentLimits.maxDepth = 2;
+    std::string command = "BEGIN";
+    int timeLeft = 100000, seenMoves = 0;
+    while(!refereeGame.isFinished() && refereeGame.getMoveCount() < 80) {
+        send("INFO time_left " + std::to_string(timeLeft));
+        const auto startTime = std::chrono::steady_clock::now();
+        const std::string reply = send(command);
+        const int replyMs = static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                                                 std::chrono::steady_clock::now() - startTime).count());
+        timeLeft -= replyMs;
+        EXPECT_LT(replyMs, 3*turnMs);
+
+        int row, col;
+        ASSERT_TRUE(readMove(reply, row, col)) << reply;
+        ASSERT_TRUE(refereeGame.placePiece(row, col)) << reply;
+        seenMoves = refereeGame.getMoveCount();
+        if(refereeGame.isFinished())
+            break;
+        EXPECT_TRUE(engine.isPondering());
+
+        const auto [opponentRow, opponentCol] = opponent.search(refereeGame, opponentLimits).bestMove;
+        ASSERT_TRUE(refereeGame.placePiece(opponentRow, opponentCol));
+        command = "TURN " + std::to_string(opponentCol) + "," + std::to_string(opponentRow);
+    }
+    EXPECT_TRUE(refereeGame.isFinished() || refereeGame.getMoveCount() >= 80);
+
+    // the engine holds the game up to its own last move
+    EXPECT_EQ(seenMoves, engine.getGame().getMoveCount());
+    for(int moveInd=0; moveInd<seenMoves; moveInd++)
+        EXPECT_EQ(refereeGame.getMove(moveInd), engine.getGame().getMove(moveInd));
+}
+
+TEST_F(PbrainTest, RunTest) {
+    std::istringstream script("START 15\nINFO timeout_turn 50\nBEGIN\nTURN 0,0\nEND\nABOUT\n");
+    std::ostringstream replies;
+    engine.run(script, replies);
+
+    // nothing after END is read
+    std::istringstream replyLines(replies.str());
+    std::string line;
+    int numLines = 0, row, col;
+    for(; std::getline(replyLines, line); numLines++) {
+        if(numLines > 0) {
+            EXPECT_TRUE(readMove(line, row, col)) << line;
+        }
+    }
+    EXPECT_EQ(3, numLines);
+    EXPECT_FALSE(engine.isPondering());
+}
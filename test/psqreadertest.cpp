@@ -0,0 +1,96 @@
+#include "gtest/gtest.h"
+#include "psqReader.h"
+#include <cstring>
+#include <string>
+#include <vector>
+
+// Implements tests for the Piskvork record reader and the corpus replay
+class PsqReaderTest : public ::testing::Test {
+protected:
+    // same corpus as OmokGameTest.SimulatedGameTest
+    inline static const std::string DATA_PATH = "../test/SimulatedGames/";
+
+    static std::vector<PsqMove> scanMoves(const char* record) {
+        PsqScanner scanner(record, record + std::strlen(record));
+        int width, height;
+        EXPECT_TRUE(scanner.readHeader(width, height));
+        std::vector<PsqMove> moves;
+        PsqMove move;
+        while(scanner.nextMove(move))
+            moves.push_back(move);
+        return moves;
+    }
+};
+
+TEST_F(PsqReaderTest, ScannerTest) {
+    const char* record = "Piskvorky 15x15, 11:11, 0\r\n8,9,0\r\n9,8,125\r\n10,10,7 \r\nKATAGOMO21.R.zip\r\n1,2,3\r\n-1\r\n2,Renju\r\n";
+    PsqScanner scanner(record, record + std::strlen(record));
+    int width = 0, height = 0;
+    ASSERT_TRUE(scanner.readHeader(width, height));
+    EXPECT_EQ(15, width);
+    EXPECT_EQ(15, height);
+
+    // moves end at the engine names, so the later "1,2,3" is not read
+    const std::vector<PsqMove> moves = scanMoves(record);
+    ASSERT_EQ(3u, moves.size());
+    EXPECT_EQ(8, moves[0].x);
+    EXPECT_EQ(9, moves[0].y);
+    EXPECT_EQ(125, moves[1].time);
+    EXPECT_EQ(10, moves[2].y);
+
+    // lines without three numbers or without a final newline
+    EXPECT_EQ(0u, scanMoves("Piskvorky 15x15, 11:11, 0\n2,Renju\n").size());
+    EXPECT_EQ(0u, scanMoves("Piskvorky 15x15, 11:11, 0\n1,2\n3,4,5\n").size());
+    EXPECT_EQ(1u, scanMoves("Piskvorky 20x20, 11:11, 0\n1,2,5").size());
+    EXPECT_EQ(0u, scanMoves("Piskvorky 20x20, 11:11, 0").size());
+
+    const char* badHeader = "Gomoku 15x15\n1,2,3\n";
+    PsqScanner badScanner(badHeader, badHeader + std::strlen(badHeader));
+    EXPECT_FALSE(badScanner.readHeader(width, height));
+}
+
+TEST_F(PsqReaderTest, FileNameTest) {
+    EXPECT_EQ(1, PsqReplayer::expectedWinner(DATA_PATH + "0_0_10_1.psq"));
+    EXPECT_EQ(0, PsqReplayer::expectedWinner("3_1_2_0.psq"));
+    EXPECT_EQ(2, PsqReplayer::expectedWinner("/tmp/a_b_c_2.psq"));
+    EXPECT_EQ(-1, PsqReplayer::expectedWinner("game.psq"));
+    EXPECT_EQ(-1, PsqReplayer::expectedWinner("0_0_10_7.psq"));
+
+    Omok board1;
+    EXPECT_TRUE(PsqReplayer::replayFile(board1, DATA_PATH + "missing.psq").readError);
+    EXPECT_FALSE(MappedFile(DATA_PATH + "missing.psq").isOpen());
+}
+
+// the threads must report exactly what a single thread does
+TEST_F(PsqReaderTest, ParallelReplayTest) {
+    const std::vector<std::string> filePaths = PsqReplayer::listCorpus(DATA_PATH);
+    ASSERT_FALSE(filePaths.empty());
+
+    const std::vector<PsqReport> serial = PsqReplayer(Omok::RuleSet::omok, 1).replay(filePaths);
+    const std::vector<PsqReport> parallel = PsqReplayer(Omok::RuleSet::omok, 4).replay(filePaths);
+    ASSERT_EQ(filePaths.size(), serial.size());
+    ASSERT_EQ(filePaths.size(), parallel.size());
+    for(std::size_t fileInd=0; fileInd<filePaths.size(); fileInd++) {
+        EXPECT_EQ(filePaths[fileInd], parallel[fileInd].filePath);
+        EXPECT_FALSE(parallel[fileInd].readError) << filePaths[fileInd];
+        EXPECT_GT(parallel[fileInd].numMoves + (parallel[fileInd].illegalMove >= 0), 0) << filePaths[fileInd];
+        EXPECT_EQ(serial[fileInd].numMoves, parallel[fileInd].numMoves);
+        EXPECT_EQ(serial[fileInd].illegalMove, parallel[fileInd].illegalMove);
+        EXPECT_EQ(serial[fileInd].winner, parallel[fileInd].winner);
+        EXPECT_EQ(serial[fileInd].expectedWinner, parallel[fileInd].expectedWinner);
+    }
+}
+
+// a record that breaks no rule and ends in a five has to match its recorded winner (games
+// decided by the referee, e.g. on a foul or a timeout, end without one)
+TEST_F(PsqReaderTest, ReplayResultTest) {
+    const std::vector<PsqReport> reports = PsqReplayer(Omok::RuleSet::renju).replay(PsqReplayer::listCorpus(DATA_PATH));
+    int numFinished = 0;
+    for(const PsqReport& report : reports) {
+        if(!report.readError && !report.isRuleViolation() && report.winner != 0) {
+            EXPECT_EQ(report.expectedWinner, report.winner) << report.filePath;
+            numFinished++;
+        }
+    }
+    EXPECT_GT(numFinished, 0);
+}
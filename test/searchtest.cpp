@@ -0,0 +1,136 @@
+#include "gtest/gtest.h"
+#include "searcher.h"
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+// Implements a fixture for the alpha-beta searcher
+class SearcherTest : public ::testing::Test {
+protected:
+    SearcherTest() : game(), searcher(4) {}
+
+    // plays a list of moves that all have to be legal
+    void playMoves(const std::vector<std::tuple<int, int>>& moves) {
+        for(auto& move : moves)
+            ASSERT_TRUE(game.makeMove(std::get<0>(move), std::get<1>(move)));
+    }
+
+    Omok game;
+    Searcher searcher;
+};
+
+TEST_F(SearcherTest, FindsWinTest) {
+    // black has an open four on row 7 and is to move
+    playMoves({{7,4}, {0,0}, {7,5}, {0,2}, {7,6}, {0,4}, {7,7}, {2,10}});
+    SearchLimits limits;
+    limits.maxDepth = 4;
+    SearchResult result = searcher.search(game, limits);
+
+    ASSERT_TRUE(Searcher::isWinScore(result.score));
+    ASSERT_GT(result.score, 0);
+    ASSERT_TRUE(result.bestMove == std::make_tuple(7, 3) || result.bestMove == std::make_tuple(7, 8));
+}
+
+TEST_F(SearcherTest, BlocksFourTest) {
+    // black threatens five on column 3 and white has to block at (7,3)
+    playMoves({{3,3}, {2,3}, {4,3}, {0,12}, {5,3}, {2,12}, {6,3}});
+    SearchLimits limits;
+    limits.maxDepth = 3;
+    SearchResult result = searcher.search(game, limits);
+
+    ASSERT_EQ(result.bestMove, std::make_tuple(7, 3));
+}
+
+TEST_F(SearcherTest, PositionRestoredTest) {
+    playMoves({{7,7}, {7,8}, {8,8}, {6,6}, {8,7}});
+    const auto keyBefore = game.getHashKey();
+    const int movesBefore = game.getMoveCount();
+
+    SearchLimits limits;
+    limits.maxDepth = 5;
+    SearchResult result = searcher.search(game, limits);
+    ASSERT_EQ(game.getHashKey(), keyBefore);
+    ASSERT_EQ(game.getMoveCount(), movesBefore);
+    ASSERT_EQ(game.getCurrentPlayer(), CellState::white);
+    ASSERT_EQ(result.depth, 5);
+    ASSERT_GT(result.nodes, 0u);
+    ASSERT_GT(result.nodesPerSecond, 0u);
+
+    // the principal variation starts with the best move and is playable under the rules
+    ASSERT_FALSE(result.pv.empty());
+    ASSERT_EQ(result.pv.front(), result.bestMove);
+    for(auto& move : result.pv)
+        ASSERT_TRUE(game.makeMove(std::get<0>(move), std::get<1>(move)));
+}
+
+TEST_F(SearcherTest, NodeLimitTest) {
+    playMoves({{7,7}, {7,8}, {8,8}});
+    SearchLimits limits;
+    limits.maxNodes = 2000;
+    SearchResult result = searcher.search(game, limits);
+
+    // aborting mid-iteration still yields a legal move
+    ASSERT_LE(result.nodes, 2000u);
+    ASSERT_TRUE(game.isPosEmpty(std::get<0>(result.bestMove), std::get<1>(result.bestMove)));
+    ASSERT_FALSE(game.isDoubleThree(std::get<0>(result.bestMove), std::get<1>(result.bestMove)));
+}
+
+TEST_F(SearcherTest, AvoidsDoubleThreeTest) {
+    // (7,7) would give black two open threes, so it must never be suggested
+    playMoves({{7,5}, {0,0}, {7,6}, {0,2}, {5,7}, {0,4}, {6,7}, {14,14}});
+    ASSERT_TRUE(game.isDoubleThree(7, 7));
+
+    SearchLimits limits;
+    limits.maxDepth = 3;
+    SearchResult result = searcher.search(game, limits);
+    ASSERT_NE(result.bestMove, std::make_tuple(7, 7));
+    ASSERT_TRUE(game.makeMove(std::get<0>(result.bestMove), std::get<1>(result.bestMove)));
+}
+
+TEST_F(SearcherTest, SharedTableTest) {
+    // two searchers work on one table at the same time
+    TransTable sharedTable(4);
+    sharedTable.newSearch();
+    Searcher firstSearcher(sharedTable), secondSearcher(sharedTable);
+    playMoves({{7,7}, {7,8}, {8,8}, {6,6}});
+    Omok otherGame(game);
+
+    SearchLimits limits;
+    limits.maxDepth = 4;
+    SearchResult firstResult, secondResult;
+    std::thread otherThread([&]() { secondResult = secondSearcher.search(otherGame, limits); });
+    firstResult = firstSearcher.search(game, limits);
+    otherThread.join();
+
+    // the searchers leave the age to the owner of the table
+    ASSERT_EQ(1, sharedTable.getAge());
+    ASSERT_EQ(4, firstResult.depth);
+    ASSERT_EQ(4, secondResult.depth);
+    ASSERT_TRUE(game.isPosEmpty(std::get<0>(firstResult.bestMove), std::get<1>(firstResult.bestMove)));
+    ASSERT_TRUE(game.isPosEmpty(std::get<0>(secondResult.bestMove), std::get<1>(secondResult.bestMove)));
+}
+
+TEST_F(SearcherTest, StopFlagTest) {
+    playMoves({{7,7}, {7,8}, {8,8}});
+    std::atomic<bool> stopFlag(true);
+    SearchLimits limits;
+    limits.stopFlag = &stopFlag;
+
+    // a flag set before the search starts stops it at once, with a legal move
+    SearchResult result = searcher.search(game, limits);
+    ASSERT_EQ(0, result.depth);
+    ASSERT_TRUE(game.isPosEmpty(std::get<0>(result.bestMove), std::get<1>(result.bestMove)));
+
+    // a flag set from another thread ends an unlimited search
+    stopFlag = false;
+    std::thread stopThread([&]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        stopFlag = true;
+    });
+    result = searcher.search(game, limits);
+    stopThread.join();
+    ASSERT_TRUE(game.isPosEmpty(std::get<0>(result.bestMove), std::get<1>(result.bestMove)));
+    ASSERT_EQ(3, game.getMoveCount());
+}
@@ -0,0 +1,67 @@
+#include "gtest/gtest.h"
+#include "gomoku.h"
+#include <random>
+
+// Implements tests for the incremental threat cache kept by the Omok board
+class ThreatCacheTest : public ::testing::Test {
+protected:
+    typedef MNKBoard::PieceDirection PieceDirection;
+
+    Omok board1;
+
+    // testing constants
+    static const int BOARD_SIZE = 15;
+
+    // compares the cache of the board with one read from scratch
+    static void expectFresh(const Omok& board) {
+        ThreatCache fresh(BOARD_SIZE, BOARD_SIZE);
+        fresh.reset(board);
+        const ThreatCache& cached = board.getThreats();
+        for(CellState player : {CellState::black, CellState::white}) {
+            ASSERT_EQ(cached.getLineScore(player), fresh.getLineScore(player));
+            for(int rowInd=0; rowInd<BOARD_SIZE; rowInd++) {
+                for(int colInd=0; colInd<BOARD_SIZE; colInd++) {
+                    ASSERT_EQ(cached.getCellScore(player, rowInd, colInd), fresh.getCellScore(player, rowInd, colInd));
+                    for(int dirInd=0; dirInd<MNKBoard::NUM_DIRS; dirInd++) {
+                        const PieceDirection dir = static_cast<PieceDirection>(dirInd);
+                        ASSERT_EQ(cached.getPatternIndex(player, dir, rowInd, colInd), fresh.getPatternIndex(player, dir, rowInd, colInd));
+                    }
+                }
+            }
+        }
+    }
+};
+
+TEST_F(ThreatCacheTest, IncrementalTest) {
+    std::mt19937 rng(13);
+    std::uniform_int_distribution<int> cellDist(0, BOARD_SIZE-1);
+    for(int gameInd=0; gameInd<4; gameInd++) {
+        int numMoves = 0;
+        while(numMoves < 40 && !board1.isFinished()) {
+            if(board1.makeMove(cellDist(rng), cellDist(rng)))
+                numMoves++;
+            if(numMoves % 8 == 0)
+                expectFresh(board1);
+        }
+        expectFresh(board1);
+
+        // taking moves back restores the cache as well
+        for(int undoInd=0; undoInd<numMoves/2; undoInd++)
+            board1.unmakeMove();
+        expectFresh(board1);
+        board1.clearBoard();
+        expectFresh(board1);
+    }
+}
+
+TEST_F(ThreatCacheTest, FiveScoreTest) {
+    const int moves[][2] = {{7, 3}, {0, 0}, {7, 4}, {0, 2}, {7, 5}, {0, 4}, {7, 6}};
+    for(const auto& move : moves)
+        ASSERT_TRUE(board1.makeMove(move[0], move[1]));
+
+    const ThreatCache& threats = board1.getThreats();
+    ASSERT_GE(threats.getCellScore(CellState::black, 7, 2), ThreatCache::FIVE_SCORE);
+    ASSERT_GE(threats.getCellScore(CellState::black, 7, 7), ThreatCache::FIVE_SCORE);
+    ASSERT_LT(threats.getCellScore(CellState::black, 8, 7), ThreatCache::FIVE_SCORE);
+    ASSERT_LT(threats.getCellScore(CellState::white, 0, 1), ThreatCache::FIVE_SCORE);
+}
@@ -0,0 +1,94 @@
+#include "gtest/gtest.h"
+#include "threatSearch.h"
+#include <tuple>
+#include <vector>
+
+// Implements a fixture for the threat-space solver
+class ThreatSolverTest : public ::testing::Test {
+protected:
+    ThreatSolverTest() : game(), solver(200000) {}
+
+    // plays a list of moves that all have to be legal
+    void playMoves(const std::vector<std::tuple<int, int>>& moves) {
+        for(auto& move : moves)
+            ASSERT_TRUE(game.makeMove(std::get<0>(move), std::get<1>(move)));
+    }
+
+    // replays a winning sequence and checks that it ends the game for the side to move
+    void checkSequence(const ThreatSearchResult& result) {
+        const CellState attacker = game.getCurrentPlayer();
+        const auto keyBefore = game.getHashKey();
+        ASSERT_FALSE(result.sequence.empty());
+        for(auto& move : result.sequence)
+            ASSERT_TRUE(game.makeMove(std::get<0>(move), std::get<1>(move)));
+        ASSERT_TRUE(game.isFinished());
+        ASSERT_EQ(game.getGameWinner(), attacker == CellState::black ? 1 : 2);
+
+        for(std::size_t moveInd=0; moveInd<result.sequence.size(); moveInd++)
+            ASSERT_TRUE(game.unmakeMove());
+        ASSERT_EQ(game.getHashKey(), keyBefore);
+    }
+
+    Omok game;
+    ThreatSolver solver;
+};
+
+TEST_F(ThreatSolverTest, FivePointsTest) {
+    playMoves({{7,7}, {0,0}, {7,8}, {0,2}, {7,9}, {0,4}});
+    int cells[15*15];
+    ASSERT_EQ(ThreatSolver::findFivePoints(game, CellState::black, cells), 0);
+
+    // completing the open three on row 7 leaves two five points
+    ASSERT_EQ(ThreatSolver::fivePointsAfter(game, CellState::black, 7, 10, cells), 2);
+    ASSERT_TRUE((cells[0] == 7*15+6 && cells[1] == 7*15+11) || (cells[0] == 7*15+11 && cells[1] == 7*15+6));
+
+    playMoves({{7,10}, {7,11}});
+    ASSERT_EQ(ThreatSolver::findFivePoints(game, CellState::black, cells), 1);
+    ASSERT_EQ(cells[0], 7*15+6);
+}
+
+TEST_F(ThreatSolverTest, VCFTest) {
+    // the closed three on row 7 becomes a four that leads into an open four on column 10
+    playMoves({{7,7}, {7,6}, {7,8}, {0,0}, {7,9}, {0,2}, {8,10}, {0,4}, {9,10}, {14,0}});
+    ThreatSearchResult result = solver.solveVCF(game);
+
+    ASSERT_TRUE(result.win);
+    ASSERT_FALSE(result.limitReached);
+    ASSERT_EQ(result.sequence.front(), std::make_tuple(7, 10));
+    checkSequence(result);
+}
+
+TEST_F(ThreatSolverTest, VCTTest) {
+    // no continuous fours win here, but starting with a three does
+    playMoves({{9,10}, {4,5}, {6,9}, {8,5}, {7,4}, {9,7}, {8,6},
+               {5,8}, {8,8}, {10,8}, {4,10}, {8,4}, {7,8}, {7,10}});
+    ASSERT_FALSE(solver.solveVCF(game).win);
+
+    ThreatSearchResult result = solver.solveVCT(game, 3);
+    ASSERT_TRUE(result.win);
+    checkSequence(result);
+}
+
+TEST_F(ThreatSolverTest, NoWinTest) {
+    playMoves({{7,7}, {7,8}, {8,8}, {6,6}});
+    ASSERT_FALSE(solver.solveVCF(game).win);
+
+    ThreatSearchResult result = solver.solveVCT(game, 2);
+    ASSERT_FALSE(result.win);
+    ASSERT_FALSE(result.limitReached);
+    ASSERT_TRUE(result.sequence.empty());
+    ASSERT_EQ(game.getMoveCount(), 4);
+}
+
+TEST_F(ThreatSolverTest, NodeLimitTest) {
+    playMoves({{9,10}, {4,5}, {6,9}, {8,5}, {7,4}, {9,7}, {8,6},
+               {5,8}, {8,8}, {10,8}, {4,10}, {8,4}, {7,8}, {7,10}});
+    ThreatSolver limitedSolver(50);
+    ThreatSearchResult result = limitedSolver.solveVCT(game, 3);
+
+    // running out of nodes is not a proof that there is no win
+    ASSERT_FALSE(result.win);
+    ASSERT_TRUE(result.limitReached);
+    ASSERT_LE(result.nodes, 51u);
+    ASSERT_EQ(game.getMoveCount(), 14);
+}
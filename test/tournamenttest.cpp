@@ -0,0 +1,150 @@
+#include "gtest/gtest.h"
+#include "tournament.h"
+#include "psqReader.h"
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// Implements a fixture for the self-play tournaments
+class TournamentTest : public ::testing::Test {
+protected:
+    TournamentTest() : bookPath("tournament_test_book.txt"), psqDir("tournament_test_games") {}
+    ~TournamentTest() {
+        std::remove(bookPath.c_str());
+        std::filesystem::remove_all(psqDir);
+    }
+
+    std::string bookPath;
+    std::string psqDir;
+
+    static MatchStats makeStats(long wins, long draws, long losses) {
+        MatchStats stats;
+        stats.wins = wins;
+        stats.draws = draws;
+        stats.losses = losses;
+        return stats;
+    }
+};
+
+TEST_F(TournamentTest, EngineConfigTest) {
+    EngineConfig config;
+    ASSERT_TRUE(EngineConfig::parse("ab:depth=6,nodes=20000,ms=50,tt=4", config));
+    EXPECT_TRUE(config.type == EngineConfig::Type::alphaBeta);
+    EXPECT_EQ(6, config.searchLimits.maxDepth);
+    EXPECT_EQ(20000u, config.searchLimits.maxNodes);
+    EXPECT_EQ(50, config.getMoveTimeMs());
+    EXPECT_EQ(4u, config.ttSizeMB);
+    EXPECT_EQ("ab:depth=6,nodes=20000,ms=50,tt=4", config.name);
+
+    // without a limit alpha-beta searches to a fixed depth
+    ASSERT_TRUE(EngineConfig::parse("ab:name=base", config));
+    EXPECT_EQ(EngineConfig::DEFAULT_DEPTH, config.searchLimits.maxDepth);
+    EXPECT_EQ("base", config.name);
+
+    // MCTS given a time searches by time only
+    ASSERT_TRUE(EngineConfig::parse("mcts:ms=20,puct=1,c=0.8", config));
+    EXPECT_TRUE(config.type == EngineConfig::Type::mcts);
+    EXPECT_EQ(0u, config.mctsLimits.maxPlayouts);
+    EXPECT_EQ(20, config.getMoveTimeMs());
+    EXPECT_TRUE(config.mctsConfig.usePuct);
+    EXPECT_DOUBLE_EQ(0.8, config.mctsConfig.exploration);
+
+    for(const char* badSpec : {"alphabeta", "ab:depth", "ab:depth=0", "ab:depth=x", "ab:playouts=10",
+                               "mcts:depth=3", "mcts:playouts=0", "mcts:puct=2", "ab:ms=2147483648",
+                               "mcts:ms=1e15", "mcts:ms=100,threads=2147483648"})
+        EXPECT_FALSE(EngineConfig::parse(badSpec, config)) << badSpec;
+}
+
+TEST_F(TournamentTest, StatsTest) {
+    const MatchStats evenStats = makeStats(40, 20, 40);
+    EXPECT_DOUBLE_EQ(0.5, evenStats.getScore());
+    EXPECT_NEAR(0, evenStats.getEloDiff(), 1e-9);
+    EXPECT_NEAR(0, evenStats.getLLR(-5, 5), 1e-9);
+
+    // a score of 0.7 is about 147 Elo, known to within the interval
+    const MatchStats strongStats = makeStats(60, 20, 20);
+    EXPECT_NEAR(147.19, strongStats.getEloDiff(), 0.01);
+    EXPECT_GT(strongStats.getEloError(), 30);
+    EXPECT_LT(strongStats.getEloError(), 100);
+    const MatchStats moreStats = makeStats(600, 200, 200);
+    EXPECT_NEAR(strongStats.getEloDiff(), moreStats.getEloDiff(), 1e-9);
+    EXPECT_NEAR(strongStats.getEloError() / std::sqrt(10.0), moreStats.getEloError(), 1.0);
+    EXPECT_TRUE(std::isinf(makeStats(5, 0, 0).getEloError()));
+
+    // the test accepts whichever hypothesis the results back
+    SprtConfig sprt;
+    sprt.isEnabled = true;
+    sprt.elo1 = 50;
+    EXPECT_NEAR(-2.944, sprt.getLowerBound(), 1e-3);
+    EXPECT_NEAR(2.944, sprt.getUpperBound(), 1e-3);
+    EXPECT_TRUE(sprt.check(strongStats) == SprtConfig::Result::acceptH1);
+    EXPECT_TRUE(sprt.check(makeStats(20, 20, 60)) == SprtConfig::Result::acceptH0);
+    EXPECT_TRUE(sprt.check(makeStats(11, 2, 10)) == SprtConfig::Result::running);
+    EXPECT_LT(makeStats(500, 0, 500).getLLR(0, 5), 0);
+}
+
+TEST_F(TournamentTest, BookTest) {
+    std::ofstream(bookPath) << "# openings\n8,8 8,9 9,9\n\n8,8 8,8\n7,7 20,1\n8,8\n1,1,0\n";
+    std::vector<std::vector<std::tuple<int, int>>> openings;
+    ASSERT_TRUE(Tournament::readBook(bookPath, Omok::RuleSet::omok, openings));
+    ASSERT_EQ(2u, openings.size());
+    EXPECT_EQ(std::make_tuple(7, 8), openings[0][1]);
+    EXPECT_EQ(1u, openings[1].size());
+    EXPECT_FALSE(Tournament::readBook("tournament_missing_book.txt", Omok::RuleSet::omok, openings));
+}
+
+TEST_F(TournamentTest, MatchTest) {
+    EngineConfig weakConfig, strongConfig;
+    ASSERT_TRUE(EngineConfig::parse("ab:depth=1,name=weak", weakConfig));
+    ASSERT_TRUE(EngineConfig::parse("ab:depth=2,name=strong", strongConfig));
+    std::ofstream(bookPath) << "8,8 8,9\n8,8 9,9 7,7\n";
+
+    TournamentConfig config;
+    config.numGames = 7;
+    config.numThreads = 2;
+    config.bookPath = bookPath;
+    config.psqDir = psqDir;
+    Tournament tournament(weakConfig, strongConfig, config);
+    ASSERT_TRUE(tournament.run());
+    const MatchStats& stats = tournament.getStats();
+    EXPECT_EQ(8, stats.getGames());
+    EXPECT_LT(stats.getScore(), 0.5);
+
+    // every record replays to the result given by its name
+    const std::vector<std::string> psqPaths = PsqReplayer::listCorpus(psqDir);
+    ASSERT_EQ(8u, psqPaths.size());
+    Omok board;
+    for(const std::string& psqPath : psqPaths) {
+        const PsqReport report = PsqReplayer::replayFile(board, psqPath);
+        EXPECT_TRUE(report.isValid()) << psqPath;
+        EXPECT_GE(report.numMoves, 2);
+    }
+    TournamentConfig missingBookConfig;
+    missingBookConfig.numThreads = 1;
+    missingBookConfig.numGames = 2;
+    missingBookConfig.bookPath = "tournament_missing_book.txt";
+    Tournament missingBook(weakConfig, strongConfig, missingBookConfig);
+    EXPECT_FALSE(missingBook.run());
+}
+
+TEST_F(TournamentTest, SprtStopTest) {
+    EngineConfig weakConfig, strongConfig;
+    ASSERT_TRUE(EngineConfig::parse("ab:depth=1", weakConfig));
+    ASSERT_TRUE(EngineConfig::parse("ab:depth=2", strongConfig));
+
+    // a strong engine is told apart long before the game limit
+    TournamentConfig config;
+    config.numGames = 2000;
+    config.numThreads = 1;
+    config.sprt.isEnabled = true;
+    config.sprt.elo0 = 0;
+    config.sprt.elo1 = 100;
+    config.sprt.alpha = config.sprt.beta = 0.1;
+    Tournament tournament(strongConfig, weakConfig, config);
+    ASSERT_TRUE(tournament.run());
+    EXPECT_TRUE(tournament.getSprtResult() == SprtConfig::Result::acceptH1) << tournament.summary();
+    EXPECT_LT(tournament.getStats().getGames(), 200);
+}
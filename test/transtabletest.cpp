@@ -0,0 +1,99 @@
+#include "gtest/gtest.h"
+#include "transTable.h"
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <cstdint>
+
+// Implements a fixture for transposition table testing
+class TransTableTest : public ::testing::Test {
+protected:
+    TransTableTest() : table(1) {}
+
+    // one megabyte table
+    TransTable table;
+
+    // keys landing in the same bucket differ only above the index bits
+    std::uint64_t sameBucketKey(std::uint64_t baseKey, int keyInd) {
+        return baseKey + (std::uint64_t)keyInd * table.getNumBuckets();
+    }
+};
+
+TEST_F(TransTableTest, StoreProbeTest) {
+    TTEntry entry;
+    ASSERT_FALSE(table.probe(0x1234, entry));
+    ASSERT_FALSE(table.probe(0, entry));
+
+    table.store(0x1234, -150, 7, BoundType::lower, 112);
+    ASSERT_TRUE(table.probe(0x1234, entry));
+    ASSERT_EQ(entry.score, -150);
+    ASSERT_EQ(entry.depth, 7);
+    ASSERT_EQ(entry.bound, BoundType::lower);
+    ASSERT_EQ(entry.move, 112);
+
+    // another key of the same bucket does not alias the entry
+    ASSERT_FALSE(table.probe(sameBucketKey(0x1234, 1), entry));
+
+    // overwriting without a move keeps the previous best move
+    table.store(0x1234, 20, 9, BoundType::exact, -1);
+    ASSERT_TRUE(table.probe(0x1234, entry));
+    ASSERT_EQ(entry.score, 20);
+    ASSERT_EQ(entry.move, 112);
+}
+
+TEST_F(TransTableTest, ReplacementTest) {
+    // fill a bucket, then store one more entry: the shallowest entry is evicted
+    const int depths[TransTable::ENTRIES_PER_BUCKET] = {10, 3, 12, 8};
+    for(int keyInd = 0; keyInd < TransTable::ENTRIES_PER_BUCKET; keyInd++)
+        table.store(sameBucketKey(77, keyInd), keyInd, depths[keyInd], BoundType::exact, keyInd);
+    table.store(sameBucketKey(77, 4), 4, 5, BoundType::exact, 4);
+
+    TTEntry entry;
+    ASSERT_FALSE(table.probe(sameBucketKey(77, 1), entry));
+    ASSERT_TRUE(table.probe(sameBucketKey(77, 4), entry));
+
+    // after a few new searches even deep entries give way
+    for(int searchInd = 0; searchInd < 2; searchInd++)
+        table.newSearch();
+    table.store(sameBucketKey(77, 5), 5, 1, BoundType::exact, 5);
+    ASSERT_TRUE(table.probe(sameBucketKey(77, 5), entry));
+    ASSERT_FALSE(table.probe(sameBucketKey(77, 4), entry));
+}
+
+TEST_F(TransTableTest, ClearAndHashfullTest) {
+    ASSERT_EQ(table.hashfull(), 0);
+    for(std::uint64_t keyVal = 0; keyVal < table.getNumBuckets() * TransTable::ENTRIES_PER_BUCKET; keyVal++)
+        table.store(keyVal * 0x9E3779B97F4A7C15ULL + 1, 0, 1, BoundType::exact, -1);
+    ASSERT_GT(table.hashfull(), 500);
+
+    table.clear();
+    ASSERT_EQ(table.hashfull(), 0);
+    TTEntry entry;
+    ASSERT_FALSE(table.probe(0x9E3779B97F4A7C15ULL + 1, entry));
+}
+
+TEST_F(TransTableTest, ConcurrentAccessTest) {
+    // every writer derives the entry from the key, so any accepted entry must be consistent
+    const int numThreads = 4;
+    const int numOps = 200000;
+    std::atomic<int> numBad(0);
+    std::vector<std::thread> workers;
+    for(int threadInd = 0; threadInd < numThreads; threadInd++) {
+        workers.emplace_back([&, threadInd]() {
+            std::uint64_t seedVal = threadInd + 1;
+            TTEntry entry;
+            for(int opInd = 0; opInd < numOps; opInd++) {
+                seedVal = seedVal * 6364136223846793005ULL + 1442695040888963407ULL;
+                const std::uint64_t keyVal = (seedVal >> 16) % 5000 + 1;
+                if(opInd % 2)
+                    table.store(keyVal, (int)(keyVal % 1000), (int)(keyVal % 50), BoundType::exact, (int)(keyVal % 225));
+                else if(table.probe(keyVal, entry) && (entry.score != (int)(keyVal % 1000) || entry.move != (int)(keyVal % 225)))
+                    numBad++;
+            }
+        });
+    }
+    for(auto& worker : workers)
+        worker.join();
+
+    ASSERT_EQ(numBad.load(), 0);
+}
@@ -0,0 +1,109 @@
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "include/tournament.h"
+
+using namespace std;
+
+namespace {
+    void printUsage(void) {
+        cout << "Usage: tournament [options] ENGINE ENGINE [ENGINE...]" << endl
+             << "Plays every pair of engines against each other, e.g." << endl
+             << "  tournament --games 20000 --sprt 0 5 0.05 0.05 ab:depth=4 ab:nodes=50000,name=new" << endl << endl
+             << "Engines: ab[:depth=D,nodes=N,ms=T,tt=MB,name=S]" << endl
+             << "         mcts[:playouts=P,ms=T,threads=N,c=C,puct=0|1,seed=S,name=S]" << endl << endl
+             << "Options:" << endl
+             << "  --games N            games per pair of engines (default 1000)" << endl
+             << "  --threads N          games played at once (default: every hardware thread)" << endl
+             << "  --rules NAME         rule set: omok, renju, freestyle or standard (default omok)" << endl
+             << "  --book FILE          openings, one per line as 1-based x,y moves" << endl
+             << "  --random-plies N     length of the random openings used without a book (default 4)" << endl
+             << "  --seed N             seed of the openings" << endl
+             << "  --psq DIR            writes every game as a .psq record into DIR" << endl
+             << "  --max-moves N        the game is drawn after N moves (default 225)" << endl
+             << "  --margin MS          time over the move limit tolerated before a forfeit (default 100)" << endl
+             << "  --report N           prints the standings every N games (default 100)" << endl
+             << "  --sprt E0 E1 A B     stops a pair once H0: elo=E0 or H1: elo=E1 is accepted" << endl;
+    }
+}
+
+int main(int argc, char** argv) {
+    TournamentConfig config;
+    vector<EngineConfig> engines;
+    for(int argInd=1; argInd<argc; argInd++) {
+        const string arg = argv[argInd];
+        const int numValues = arg == "--sprt" ? 4 : (arg.rfind("--", 0) == 0 ? 1 : 0);
+        if(argInd + numValues >= argc) {
+            printUsage();
+            return 1;
+        }
+
+        if(arg == "--games")
+            config.numGames = atol(argv[++argInd]);
+        else if(arg == "--threads")
+            config.numThreads = atoi(argv[++argInd]);
+        else if(arg == "--rules") {
+            const string rules = argv[++argInd];
+            if(rules == "omok")
+                config.ruleSet = Omok::RuleSet::omok;
+            else if(rules == "renju")
+                config.ruleSet = Omok::RuleSet::renju;
+            else if(rules == "freestyle")
+                config.ruleSet = Omok::RuleSet::freestyle;
+            else if(rules == "standard")
+                config.ruleSet = Omok::RuleSet::standard;
+            else {
+                printUsage();
+                return 1;
+            }
+        }
+        else if(arg == "--book")
+            config.bookPath = argv[++argInd];
+        else if(arg == "--random-plies")
+            config.randomPlies = atoi(argv[++argInd]);
+        else if(arg == "--seed")
+            config.seed = strtoull(argv[++argInd], nullptr, 10);
+        else if(arg == "--psq")
+            config.psqDir = argv[++argInd];
+        else if(arg == "--max-moves")
+            config.maxMoves = atoi(argv[++argInd]);
+        else if(arg == "--margin")
+            config.timeMarginMs = atoi(argv[++argInd]);
+        else if(arg == "--report")
+            config.reportInterval = atoi(argv[++argInd]);
+        else if(arg == "--sprt") {
+            config.sprt.isEnabled = true;
+            config.sprt.elo0 = atof(argv[++argInd]);
+            config.sprt.elo1 = atof(argv[++argInd]);
+            config.sprt.alpha = atof(argv[++argInd]);
+            config.sprt.beta = atof(argv[++argInd]);
+        }
+        else {
+            EngineConfig engine;
+            if(!EngineConfig::parse(arg, engine)) {
+                cerr << "Unknown engine or option: " << arg << endl;
+                printUsage();
+                return 1;
+            }
+            engines.push_back(engine);
+        }
+    }
+    if(engines.size() < 2) {
+        printUsage();
+        return 1;
+    }
+
+    // a round robin, one match (and one test) per pair
+    for(size_t firstInd=0; firstInd<engines.size(); firstInd++) {
+        for(size_t secondInd=firstInd+1; secondInd<engines.size(); secondInd++) {
+            Tournament tournament(engines[firstInd], engines[secondInd], config);
+            if(!tournament.run(&cout)) {
+                cerr << "Could not read the opening book " << config.bookPath << endl;
+                return 1;
+            }
+            cout << "Final " << engines[firstInd].name << " vs " << engines[secondInd].name << ": " << tournament.summary() << endl;
+        }
+    }
+    return 0;
+}